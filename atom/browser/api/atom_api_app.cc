@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_app.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -33,10 +34,14 @@
 #include "brightray/browser/brightray_paths.h"
 #include "chrome/common/chrome_paths.h"
 #include "content/public/browser/browser_accessibility_state.h"
+#include "content/public/browser/browser_child_process_host.h"
+#include "content/public/browser/child_process_data.h"
 #include "content/public/browser/client_certificate_delegate.h"
 #include "content/public/browser/gpu_data_manager.h"
 #include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
 #include "content/public/common/content_switches.h"
+#include "content/public/common/process_type.h"
 #include "media/audio/audio_manager.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
@@ -463,10 +468,23 @@ int ImportIntoCertStore(
 
 }  // namespace
 
+App::ProcessMetric::ProcessMetric(
+    int type,
+    base::ProcessId pid,
+    std::unique_ptr<base::ProcessMetrics> metrics)
+    : type(type), pid(pid), metrics(std::move(metrics)) {
+}
+
+App::ProcessMetric::~ProcessMetric() {
+}
+
 App::App(v8::Isolate* isolate) {
   static_cast<AtomBrowserClient*>(AtomBrowserClient::Get())->set_delegate(this);
   Browser::Get()->AddObserver(this);
   content::GpuDataManager::GetInstance()->AddObserver(this);
+  content::BrowserChildProcessObserver::Add(this);
+  AddProcessMetric(content::PROCESS_TYPE_BROWSER,
+                   base::GetCurrentProcessHandle());
   Init(isolate);
 }
 
@@ -475,6 +493,7 @@ App::~App() {
       nullptr);
   Browser::Get()->RemoveObserver(this);
   content::GpuDataManager::GetInstance()->RemoveObserver(this);
+  content::BrowserChildProcessObserver::Remove(this);
 }
 
 void App::OnBeforeQuit(bool* prevent_default) {
@@ -528,6 +547,10 @@ void App::OnAccessibilitySupportChanged() {
   Emit("accessibility-support-changed", IsAccessibilitySupportEnabled());
 }
 
+void App::OnJank(const base::DictionaryValue& details) {
+  Emit("jank", details);
+}
+
 #if defined(OS_MACOSX)
 void App::OnContinueUserActivity(
     bool* prevent_default,
@@ -628,6 +651,104 @@ void App::OnGpuProcessCrashed(base::TerminationStatus status) {
     status == base::TERMINATION_STATUS_PROCESS_WAS_KILLED);
 }
 
+void App::BrowserChildProcessLaunchedAndConnected(
+    const content::ChildProcessData& data) {
+  AddProcessMetric(data.process_type, data.handle);
+}
+
+void App::BrowserChildProcessHostDisconnected(
+    const content::ChildProcessData& data) {
+  ChildProcessDisconnected(base::GetProcId(data.handle));
+}
+
+void App::BrowserChildProcessCrashed(
+    const content::ChildProcessData& data, int exit_code) {
+  ChildProcessDisconnected(base::GetProcId(data.handle));
+}
+
+void App::BrowserChildProcessKilled(
+    const content::ChildProcessData& data, int exit_code) {
+  ChildProcessDisconnected(base::GetProcId(data.handle));
+}
+
+void App::AddProcessMetric(int type, base::ProcessHandle handle) {
+  base::ProcessId pid = base::GetProcId(handle);
+  if (pid == base::kNullProcessId || app_metrics_.count(pid))
+    return;
+
+#if defined(OS_MACOSX)
+  std::unique_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          handle, content::BrowserChildProcessHost::GetPortProvider()));
+#else
+  std::unique_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(handle));
+#endif
+  // Take the first sample so the next call can compute the CPU usage.
+  metrics->GetCPUUsage();
+  app_metrics_[pid].reset(new ProcessMetric(type, pid, std::move(metrics)));
+}
+
+void App::ChildProcessDisconnected(base::ProcessId pid) {
+  app_metrics_.erase(pid);
+}
+
+v8::Local<v8::Value> App::GetAppMetrics(v8::Isolate* isolate) {
+  // Renderer processes are not reported by BrowserChildProcessObserver, sync
+  // them with the list of live RenderProcessHosts.
+  std::set<base::ProcessId> renderers;
+  for (content::RenderProcessHost::iterator it(
+           content::RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    content::RenderProcessHost* host = it.GetCurrentValue();
+    if (!host->HasConnection())
+      continue;
+    base::ProcessHandle handle = host->GetHandle();
+    renderers.insert(base::GetProcId(handle));
+    AddProcessMetric(content::PROCESS_TYPE_RENDERER, handle);
+  }
+  for (auto it = app_metrics_.begin(); it != app_metrics_.end();) {
+    if (it->second->type == content::PROCESS_TYPE_RENDERER &&
+        !renderers.count(it->first))
+      it = app_metrics_.erase(it);
+    else
+      ++it;
+  }
+
+  std::vector<mate::Dictionary> result;
+  result.reserve(app_metrics_.size());
+  for (const auto& process_metric : app_metrics_) {
+    base::ProcessMetrics* metrics = process_metric.second->metrics.get();
+
+    mate::Dictionary cpu_dict = mate::Dictionary::CreateEmpty(isolate);
+    cpu_dict.Set("percentCPUUsage", metrics->GetCPUUsage());
+#if defined(OS_MACOSX) || defined(OS_LINUX)
+    cpu_dict.Set("idleWakeupsPerSecond", metrics->GetIdleWakeupsPerSecond());
+#endif
+
+    mate::Dictionary memory_dict = mate::Dictionary::CreateEmpty(isolate);
+    memory_dict.Set("workingSetSize",
+                    static_cast<double>(metrics->GetWorkingSetSize() >> 10));
+    memory_dict.Set(
+        "peakWorkingSetSize",
+        static_cast<double>(metrics->GetPeakWorkingSetSize() >> 10));
+    size_t private_bytes, shared_bytes;
+    if (metrics->GetMemoryBytes(&private_bytes, &shared_bytes)) {
+      memory_dict.Set("privateBytes", static_cast<double>(private_bytes >> 10));
+      memory_dict.Set("sharedBytes", static_cast<double>(shared_bytes >> 10));
+    }
+
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+    dict.Set("pid", process_metric.second->pid);
+    dict.Set("type", content::GetProcessTypeNameInEnglish(
+        process_metric.second->type));
+    dict.Set("cpu", cpu_dict);
+    dict.Set("memory", memory_dict);
+    result.push_back(dict);
+  }
+  return mate::ConvertToV8(isolate, result);
+}
+
 base::FilePath App::GetPath(mate::Arguments* args, const std::string& name) {
   bool succeed = false;
   base::FilePath path;
@@ -903,7 +1024,8 @@ void App::BuildPrototype(
       .SetMethod("isAccessibilitySupportEnabled",
                  &App::IsAccessibilitySupportEnabled)
       .SetMethod("disableHardwareAcceleration",
-                 &App::DisableHardwareAcceleration);
+                 &App::DisableHardwareAcceleration)
+      .SetMethod("getAppMetrics", &App::GetAppMetrics);
 }
 
 }  // namespace api
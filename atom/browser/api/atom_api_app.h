@@ -5,6 +5,8 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_APP_H_
 #define ATOM_BROWSER_API_ATOM_API_APP_H_
 
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -12,7 +14,9 @@
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/browser_observer.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "base/process/process_metrics.h"
 #include "chrome/browser/process_singleton.h"
+#include "content/public/browser/browser_child_process_observer.h"
 #include "content/public/browser/gpu_data_manager_observer.h"
 #include "native_mate/handle.h"
 #include "net/base/completion_callback.h"
@@ -40,7 +44,8 @@ namespace api {
 class App : public AtomBrowserClient::Delegate,
             public mate::EventEmitter<App>,
             public BrowserObserver,
-            public content::GpuDataManagerObserver {
+            public content::GpuDataManagerObserver,
+            public content::BrowserChildProcessObserver {
  public:
   static mate::Handle<App> Create(v8::Isolate* isolate);
 
@@ -81,6 +86,7 @@ class App : public AtomBrowserClient::Delegate,
   void OnLogin(LoginHandler* login_handler,
                const base::DictionaryValue& request_details) override;
   void OnAccessibilitySupportChanged() override;
+  void OnJank(const base::DictionaryValue& details) override;
 #if defined(OS_MACOSX)
   void OnContinueUserActivity(
       bool* prevent_default,
@@ -108,7 +114,37 @@ class App : public AtomBrowserClient::Delegate,
   // content::GpuDataManagerObserver:
   void OnGpuProcessCrashed(base::TerminationStatus status) override;
 
+  // content::BrowserChildProcessObserver:
+  void BrowserChildProcessLaunchedAndConnected(
+      const content::ChildProcessData& data) override;
+  void BrowserChildProcessHostDisconnected(
+      const content::ChildProcessData& data) override;
+  void BrowserChildProcessCrashed(
+      const content::ChildProcessData& data, int exit_code) override;
+  void BrowserChildProcessKilled(
+      const content::ChildProcessData& data, int exit_code) override;
+
  private:
+  // The metrics of a process are kept between calls of getAppMetrics, since
+  // the CPU usage is computed from the difference to the previous sample.
+  struct ProcessMetric {
+    ProcessMetric(int type,
+                  base::ProcessId pid,
+                  std::unique_ptr<base::ProcessMetrics> metrics);
+    ~ProcessMetric();
+
+    int type;
+    base::ProcessId pid;
+    std::unique_ptr<base::ProcessMetrics> metrics;
+  };
+
+  // Returns the resource usage of all the processes of the app.
+  v8::Local<v8::Value> GetAppMetrics(v8::Isolate* isolate);
+
+  // Adds the metrics of a process that is not being tracked yet.
+  void AddProcessMetric(int type, base::ProcessHandle handle);
+  void ChildProcessDisconnected(base::ProcessId pid);
+
   // Get/Set the pre-defined path in PathService.
   base::FilePath GetPath(mate::Arguments* args, const std::string& name);
   void SetPath(mate::Arguments* args,
@@ -138,6 +174,9 @@ class App : public AtomBrowserClient::Delegate,
 
   std::unique_ptr<ProcessSingleton> process_singleton_;
 
+  // The metrics of browser process and child processes, keyed by pid.
+  std::map<base::ProcessId, std::unique_ptr<ProcessMetric>> app_metrics_;
+
 #if defined(USE_NSS_CERTS)
   std::unique_ptr<CertificateManagerModel> certificate_manager_model_;
 #endif
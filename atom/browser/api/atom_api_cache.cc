@@ -0,0 +1,305 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_cache.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atom/browser/atom_browser_context.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "base/bind.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "native_mate/dictionary.h"
+#include "native_mate/object_template_builder.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache.h"
+#include "net/http/http_transaction_factory.h"
+#include "net/http/http_util.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "url/gurl.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+// The HTTP cache uses the stream 0 for headers, 1 for the body and 2 for the
+// metadata of an entry.
+const int kNumCacheStreams = 3;
+
+using QueryCallback =
+    base::Callback<void(int, std::unique_ptr<base::ListValue>)>;
+
+// Finds the entries of the HTTP cache that match a filter on IO thread, and
+// either reports them or dooms them. It deletes itself when done.
+class CacheQuery {
+ public:
+  CacheQuery(Cache::Action action,
+             const std::string& key,
+             const std::string& prefix,
+             const QueryCallback& callback)
+      : action_(action),
+        key_(key),
+        prefix_(prefix),
+        callback_(callback),
+        backend_(nullptr),
+        entry_(nullptr),
+        entries_(new base::ListValue) {}
+
+  void Start(scoped_refptr<net::URLRequestContextGetter> getter) {
+    auto* http_cache = getter->GetURLRequestContext()->
+        http_transaction_factory()->GetCache();
+    if (!http_cache) {
+      Finish(net::ERR_FAILED);
+      return;
+    }
+    int rv = http_cache->GetBackend(
+        &backend_, base::Bind(&CacheQuery::OnGetBackend,
+                              base::Unretained(this)));
+    if (rv != net::ERR_IO_PENDING)
+      OnGetBackend(rv);
+  }
+
+ private:
+  ~CacheQuery() {
+    if (entry_)
+      entry_->Close();
+  }
+
+  void OnGetBackend(int rv) {
+    if (rv != net::OK || !backend_) {
+      Finish(rv == net::OK ? net::ERR_FAILED : rv);
+      return;
+    }
+
+    // A single URL is looked up by its key instead of walking all entries.
+    if (!key_.empty()) {
+      if (action_ == Cache::Action::REMOVE) {
+        rv = backend_->DoomEntry(
+            key_, base::Bind(&CacheQuery::OnKeyDoomed,
+                             base::Unretained(this)));
+        if (rv != net::ERR_IO_PENDING)
+          OnKeyDoomed(rv);
+      } else {
+        rv = backend_->OpenEntry(
+            key_, &entry_, base::Bind(&CacheQuery::OnKeyOpened,
+                                      base::Unretained(this)));
+        if (rv != net::ERR_IO_PENDING)
+          OnKeyOpened(rv);
+      }
+      return;
+    }
+
+    if (action_ == Cache::Action::REMOVE && prefix_.empty()) {
+      rv = backend_->DoomAllEntries(
+          base::Bind(&CacheQuery::Finish, base::Unretained(this)));
+      if (rv != net::ERR_IO_PENDING)
+        Finish(rv);
+      return;
+    }
+
+    iterator_ = backend_->CreateIterator();
+    OpenNextEntry();
+  }
+
+  void OnKeyOpened(int rv) {
+    // A missing entry is not an error, it just matches nothing.
+    if (rv == net::OK)
+      AddEntry();
+    Finish(net::OK);
+  }
+
+  void OnKeyDoomed(int rv) {
+    Finish(net::OK);
+  }
+
+  void OpenNextEntry() {
+    while (true) {
+      int rv = iterator_->OpenNextEntry(
+          &entry_, base::Bind(&CacheQuery::OnEntryOpened,
+                              base::Unretained(this)));
+      if (rv == net::ERR_IO_PENDING)
+        return;
+      if (!ReadEntry(rv))
+        return;
+    }
+  }
+
+  void OnEntryOpened(int rv) {
+    if (ReadEntry(rv))
+      OpenNextEntry();
+  }
+
+  // Handles the entry opened by the iterator, returns false when the
+  // iteration has ended.
+  bool ReadEntry(int rv) {
+    if (rv != net::OK) {
+      // The iterator fails when there are no more entries.
+      iterator_.reset();
+      if (action_ == Cache::Action::REMOVE)
+        DoomNextKey(net::OK);
+      else
+        Finish(net::OK);
+      return false;
+    }
+
+    if (base::StartsWith(entry_->GetKey(), prefix_,
+                         base::CompareCase::SENSITIVE)) {
+      // Dooming entries while iterating may skip some of them, so the keys
+      // are doomed after the iteration.
+      if (action_ == Cache::Action::REMOVE)
+        doomed_keys_.push_back(entry_->GetKey());
+      else
+        AddEntry();
+    }
+    entry_->Close();
+    entry_ = nullptr;
+    return true;
+  }
+
+  void DoomNextKey(int rv) {
+    while (!doomed_keys_.empty()) {
+      std::string key = doomed_keys_.back();
+      doomed_keys_.pop_back();
+      rv = backend_->DoomEntry(
+          key, base::Bind(&CacheQuery::DoomNextKey, base::Unretained(this)));
+      if (rv == net::ERR_IO_PENDING)
+        return;
+    }
+    Finish(net::OK);
+  }
+
+  void AddEntry() {
+    int64_t size = 0;
+    for (int i = 0; i < kNumCacheStreams; ++i)
+      size += entry_->GetDataSize(i);
+    std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+    dict->SetString("url", entry_->GetKey());
+    dict->SetDouble("size", static_cast<double>(size));
+    dict->SetDouble("lastUsed", entry_->GetLastUsed().ToDoubleT());
+    dict->SetDouble("lastModified", entry_->GetLastModified().ToDoubleT());
+    entries_->Append(std::move(dict));
+  }
+
+  void Finish(int rv) {
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(callback_, rv, base::Passed(&entries_)));
+    delete this;
+  }
+
+  Cache::Action action_;
+  std::string key_;
+  std::string prefix_;
+  QueryCallback callback_;
+
+  disk_cache::Backend* backend_;
+  std::unique_ptr<disk_cache::Backend::Iterator> iterator_;
+  disk_cache::Entry* entry_;
+  std::vector<std::string> doomed_keys_;
+  std::unique_ptr<base::ListValue> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(CacheQuery);
+};
+
+void StartQueryInIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                    Cache::Action action,
+                    const std::string& key,
+                    const std::string& prefix,
+                    const QueryCallback& callback) {
+  (new CacheQuery(action, key, prefix, callback))->Start(getter);
+}
+
+void StartQuery(scoped_refptr<net::URLRequestContextGetter> getter,
+                Cache::Action action,
+                const base::DictionaryValue& filter,
+                const QueryCallback& callback) {
+  // The HTTP cache keys the entries by their URL without the reference.
+  std::string url, key, prefix;
+  if (filter.GetString("url", &url)) {
+    GURL gurl(url);
+    key = gurl.is_valid() ? net::HttpUtil::SpecForRequest(gurl) : url;
+  }
+  filter.GetString("prefix", &prefix);
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&StartQueryInIO, getter, action, key, prefix, callback));
+}
+
+}  // namespace
+
+Cache::Cache(v8::Isolate* isolate, AtomBrowserContext* browser_context)
+    : request_context_getter_(browser_context->url_request_context_getter()),
+      weak_factory_(this) {
+  Init(isolate);
+}
+
+Cache::~Cache() {
+}
+
+void Cache::Get(const base::DictionaryValue& filter,
+                const GetCallback& callback) {
+  StartQuery(request_context_getter_, Action::GET, filter,
+             base::Bind(&Cache::OnGetDone, weak_factory_.GetWeakPtr(),
+                        callback));
+}
+
+void Cache::Remove(const base::DictionaryValue& filter,
+                   const RemoveCallback& callback) {
+  StartQuery(request_context_getter_, Action::REMOVE, filter,
+             base::Bind(&Cache::OnRemoveDone, weak_factory_.GetWeakPtr(),
+                        callback));
+}
+
+void Cache::OnGetDone(const GetCallback& callback,
+                      int result,
+                      std::unique_ptr<base::ListValue> entries) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  callback.Run(ErrorToV8(result), *entries);
+}
+
+void Cache::OnRemoveDone(const RemoveCallback& callback,
+                         int result,
+                         std::unique_ptr<base::ListValue> entries) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  callback.Run(ErrorToV8(result));
+}
+
+v8::Local<v8::Value> Cache::ErrorToV8(int result) {
+  if (result == net::OK)
+    return v8::Null(isolate());
+  return v8::Exception::Error(
+      mate::StringToV8(isolate(), net::ErrorToString(result)));
+}
+
+// static
+mate::Handle<Cache> Cache::Create(v8::Isolate* isolate,
+                                  AtomBrowserContext* browser_context) {
+  return mate::CreateHandle(isolate, new Cache(isolate, browser_context));
+}
+
+// static
+void Cache::BuildPrototype(v8::Isolate* isolate,
+                           v8::Local<v8::FunctionTemplate> prototype) {
+  prototype->SetClassName(mate::StringToV8(isolate, "Cache"));
+  mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
+      .SetMethod("get", &Cache::Get)
+      .SetMethod("remove", &Cache::Remove);
+}
+
+}  // namespace api
+
+}  // namespace atom
@@ -0,0 +1,79 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_CACHE_H_
+#define ATOM_BROWSER_API_ATOM_API_CACHE_H_
+
+#include <memory>
+
+#include "atom/browser/api/trackable_object.h"
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "native_mate/handle.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
+
+namespace net {
+class URLRequestContextGetter;
+}
+
+namespace atom {
+
+class AtomBrowserContext;
+
+namespace api {
+
+// Queries and evicts the entries of a session's HTTP cache.
+class Cache : public mate::TrackableObject<Cache> {
+ public:
+  enum class Action {
+    GET,
+    REMOVE,
+  };
+
+  using GetCallback =
+      base::Callback<void(v8::Local<v8::Value>, const base::ListValue&)>;
+  using RemoveCallback = base::Callback<void(v8::Local<v8::Value>)>;
+
+  static mate::Handle<Cache> Create(v8::Isolate* isolate,
+                                    AtomBrowserContext* browser_context);
+
+  // mate::TrackableObject:
+  static void BuildPrototype(v8::Isolate* isolate,
+                             v8::Local<v8::FunctionTemplate> prototype);
+
+ protected:
+  Cache(v8::Isolate* isolate, AtomBrowserContext* browser_context);
+  ~Cache() override;
+
+  void Get(const base::DictionaryValue& filter, const GetCallback& callback);
+  void Remove(const base::DictionaryValue& filter,
+              const RemoveCallback& callback);
+
+ private:
+  void OnGetDone(const GetCallback& callback,
+                 int result,
+                 std::unique_ptr<base::ListValue> entries);
+  void OnRemoveDone(const RemoveCallback& callback,
+                    int result,
+                    std::unique_ptr<base::ListValue> entries);
+
+  v8::Local<v8::Value> ErrorToV8(int result);
+
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
+
+  base::WeakPtrFactory<Cache> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(Cache);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_CACHE_H_
@@ -2,18 +2,25 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/trace_event/trace_log.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/tracing_controller.h"
 #include "native_mate/dictionary.h"
+#include "third_party/zlib/zlib.h"
 
 #include "atom/common/node_includes.h"
 
+using content::BrowserThread;
 using content::TracingController;
 
 namespace mate {
@@ -58,6 +65,180 @@ void StopRecording(const base::FilePath& path,
       GetTraceDataSink(path, callback));
 }
 
+using ChunkCallback = base::Callback<void(v8::Local<v8::Value>)>;
+
+const char kTraceEventsLabel[] = "traceEvents";
+const char kMetadataLabel[] = "metadata";
+
+// Size of the buffer receiving the output of zlib.
+const size_t kCompressBufferSize = 64 * 1024;
+
+// Delivers the trace data to JavaScript as it is produced. Unlike the sinks of
+// TracingController it keeps none of the data it has passed on, so the memory
+// used does not grow with the size of the trace.
+//
+// The JSON is written on UI thread, and gzipped on FILE thread when |compress|
+// is set, the chunks are emitted on UI thread in the order they were written.
+class StreamingTraceDataSink : public TracingController::TraceDataSink {
+ public:
+  StreamingTraceDataSink(v8::Isolate* isolate,
+                         bool compress,
+                         const ChunkCallback& chunk_callback,
+                         const base::Closure& end_callback)
+      : isolate_(isolate),
+        compress_(compress),
+        chunk_callback_(chunk_callback),
+        end_callback_(end_callback),
+        has_chunks_(false),
+        stream_initialized_(false) {}
+
+  // TracingController::TraceDataSink:
+  void AddTraceChunk(const std::string& chunk) override {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    std::string data(has_chunks_ ? "," :
+                     std::string("{\"") + kTraceEventsLabel + "\":[");
+    has_chunks_ = true;
+    Write(data + chunk);
+  }
+
+  void Close() override {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    std::string data(has_chunks_ ? "]" :
+                     std::string("{\"") + kTraceEventsLabel + "\":[]");
+    std::string metadata;
+    if (base::JSONWriter::Write(*GetMetadataCopy(), &metadata) &&
+        !metadata.empty())
+      data += std::string(",\"") + kMetadataLabel + "\": " + metadata;
+    data += "}";
+    Write(data);
+
+    if (compress_)
+      BrowserThread::PostTask(
+          BrowserThread::FILE, FROM_HERE,
+          base::Bind(&StreamingTraceDataSink::CompressOnFileThread, this,
+                     std::string(), true));
+    else
+      BrowserThread::PostTask(BrowserThread::UI, FROM_HERE, end_callback_);
+  }
+
+ private:
+  ~StreamingTraceDataSink() override {
+    if (stream_initialized_)
+      deflateEnd(&stream_);
+  }
+
+  void Write(const std::string& data) {
+    if (compress_)
+      BrowserThread::PostTask(
+          BrowserThread::FILE, FROM_HERE,
+          base::Bind(&StreamingTraceDataSink::CompressOnFileThread, this,
+                     data, false));
+    else
+      BrowserThread::PostTask(
+          BrowserThread::UI, FROM_HERE,
+          base::Bind(&StreamingTraceDataSink::EmitChunk, this, data));
+  }
+
+  // Gzips |data| and passes on the output produced so far, the end of the
+  // gzip stream is written when |finish| is set.
+  void CompressOnFileThread(const std::string& data, bool finish) {
+    DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+    if (!stream_initialized_) {
+      memset(&stream_, 0, sizeof(stream_));
+      // 16 is added to the window bits to write a gzip header.
+      stream_initialized_ =
+          deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16,
+                       8, Z_DEFAULT_STRATEGY) == Z_OK;
+      if (!stream_initialized_)
+        LOG(ERROR) << "Failed to initialize the compression of trace data";
+    }
+
+    if (stream_initialized_) {
+      stream_.next_in =
+          reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+      stream_.avail_in = static_cast<uInt>(data.size());
+      std::vector<char> buffer(kCompressBufferSize);
+      int result;
+      do {
+        stream_.next_out = reinterpret_cast<Bytef*>(buffer.data());
+        stream_.avail_out = static_cast<uInt>(buffer.size());
+        result = deflate(&stream_, finish ? Z_FINISH : Z_NO_FLUSH);
+        size_t size = buffer.size() - stream_.avail_out;
+        if (size > 0)
+          BrowserThread::PostTask(
+              BrowserThread::UI, FROM_HERE,
+              base::Bind(&StreamingTraceDataSink::EmitChunk, this,
+                         std::string(buffer.data(), size)));
+      } while (result == Z_OK && stream_.avail_out == 0);
+    }
+
+    if (finish)
+      BrowserThread::PostTask(BrowserThread::UI, FROM_HERE, end_callback_);
+  }
+
+  void EmitChunk(const std::string& chunk) {
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    chunk_callback_.Run(
+        node::Buffer::Copy(isolate_, chunk.data(), chunk.size())
+            .ToLocalChecked());
+  }
+
+  v8::Isolate* isolate_;
+  bool compress_;
+  ChunkCallback chunk_callback_;
+  base::Closure end_callback_;
+
+  // Only accessed on UI thread.
+  bool has_chunks_;
+
+  // Only accessed on FILE thread.
+  bool stream_initialized_;
+  z_stream stream_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamingTraceDataSink);
+};
+
+scoped_refptr<TracingController::TraceDataSink> GetStreamingTraceDataSink(
+    v8::Isolate* isolate,
+    bool compress,
+    const ChunkCallback& chunk_callback,
+    const base::Closure& end_callback) {
+  return new StreamingTraceDataSink(isolate, compress, chunk_callback,
+                                    end_callback);
+}
+
+bool StopRecordingToStream(v8::Isolate* isolate,
+                           bool compress,
+                           const ChunkCallback& chunk_callback,
+                           const base::Closure& end_callback) {
+  return TracingController::GetInstance()->StopTracing(
+      GetStreamingTraceDataSink(isolate, compress, chunk_callback,
+                                end_callback));
+}
+
+void RestartRecording(const base::trace_event::TraceConfig& trace_config,
+                      const base::Closure& end_callback) {
+  TracingController::GetInstance()->StartTracing(
+      trace_config, TracingController::StartTracingDoneCallback());
+  end_callback.Run();
+}
+
+// The tracing controller can only flush the trace buffers by stopping, so a
+// snapshot stops the recording and starts it again with the same config once
+// the data has been collected.
+bool CaptureRecordingSnapshot(v8::Isolate* isolate,
+                              bool compress,
+                              const ChunkCallback& chunk_callback,
+                              const base::Closure& end_callback) {
+  auto trace_config =
+      base::trace_event::TraceLog::GetInstance()->GetCurrentTraceConfig();
+  return TracingController::GetInstance()->StopTracing(
+      GetStreamingTraceDataSink(
+          isolate, compress, chunk_callback,
+          base::Bind(&RestartRecording, trace_config, end_callback)));
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   auto controller = base::Unretained(TracingController::GetInstance());
@@ -67,6 +248,8 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("startRecording", base::Bind(
       &TracingController::StartTracing, controller));
   dict.SetMethod("stopRecording", &StopRecording);
+  dict.SetMethod("_stopRecordingToStream", &StopRecordingToStream);
+  dict.SetMethod("_captureRecordingSnapshot", &CaptureRecordingSnapshot);
   dict.SetMethod("getTraceBufferUsage", base::Bind(
       &TracingController::GetTraceBufferUsage, controller));
   dict.SetMethod("setWatchEvent", base::Bind(
@@ -4,16 +4,23 @@
 
 #include "atom/browser/api/atom_api_cookies.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "atom/browser/atom_browser_context.h"
+#include "atom/browser/net/cookie_index.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/memory/ref_counted.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "net/cookies/canonical_cookie.h"
 #include "net/cookies/cookie_monster.h"
 #include "net/cookies/cookie_store.h"
 #include "net/cookies/cookie_util.h"
@@ -21,6 +28,7 @@
 #include "net/url_request/url_request_context_getter.h"
 
 using atom::AtomCookieDelegate;
+using atom::CookieFilter;
 using content::BrowserThread;
 
 namespace mate {
@@ -76,6 +84,18 @@ struct Converter<AtomCookieDelegate::ChangeCause> {
   }
 };
 
+template<>
+struct Converter<AtomCookieDelegate::CookieChange> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate, const AtomCookieDelegate::CookieChange& val) {
+    mate::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("cookie", val.cookie);
+    dict.Set("cause", val.cause);
+    dict.Set("removed", val.removed);
+    return dict.GetHandle();
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
@@ -84,45 +104,6 @@ namespace api {
 
 namespace {
 
-// Returns whether |domain| matches |filter|.
-bool MatchesDomain(std::string filter, const std::string& domain) {
-  // Add a leading '.' character to the filter domain if it doesn't exist.
-  if (net::cookie_util::DomainIsHostOnly(filter))
-    filter.insert(0, ".");
-
-  std::string sub_domain(domain);
-  // Strip any leading '.' character from the input cookie domain.
-  if (!net::cookie_util::DomainIsHostOnly(sub_domain))
-    sub_domain = sub_domain.substr(1);
-
-  // Now check whether the domain argument is a subdomain of the filter domain.
-  for (sub_domain.insert(0, "."); sub_domain.length() >= filter.length();) {
-    if (sub_domain == filter)
-      return true;
-    const size_t next_dot = sub_domain.find('.', 1);  // Skip over leading dot.
-    sub_domain.erase(0, next_dot);
-  }
-  return false;
-}
-
-// Returns whether |cookie| matches |filter|.
-bool MatchesCookie(const base::DictionaryValue* filter,
-                   const net::CanonicalCookie& cookie) {
-  std::string str;
-  bool b;
-  if (filter->GetString("name", &str) && str != cookie.Name())
-    return false;
-  if (filter->GetString("path", &str) && str != cookie.Path())
-    return false;
-  if (filter->GetString("domain", &str) && !MatchesDomain(str, cookie.Domain()))
-    return false;
-  if (filter->GetBoolean("secure", &b) && b != cookie.IsSecure())
-    return false;
-  if (filter->GetBoolean("session", &b) && b != !cookie.IsPersistent())
-    return false;
-  return true;
-}
-
 // Helper to returns the CookieStore.
 inline net::CookieStore* GetCookieStore(
     scoped_refptr<net::URLRequestContextGetter> getter) {
@@ -135,33 +116,39 @@ void RunCallbackInUI(const base::Closure& callback) {
 }
 
 // Remove cookies from |list| not matching |filter|, and pass it to |callback|.
-void FilterCookies(std::unique_ptr<base::DictionaryValue> filter,
+void FilterCookies(std::unique_ptr<CookieFilter> filter,
                    const Cookies::GetCallback& callback,
                    const net::CookieList& list) {
   net::CookieList result;
   for (const auto& cookie : list) {
-    if (MatchesCookie(filter.get(), cookie))
+    if (filter->Matches(cookie))
       result.push_back(cookie);
   }
   RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, result));
 }
 
+// Pass the cookies found by the index to |callback|.
+void OnCookieIndexQueried(const Cookies::GetCallback& callback,
+                          const net::CookieList& result) {
+  RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, result));
+}
+
 // Receives cookies matching |filter| in IO thread.
 void GetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                    std::unique_ptr<base::DictionaryValue> filter,
+                    scoped_refptr<AtomCookieDelegate> cookie_delegate,
+                    std::unique_ptr<CookieFilter> filter,
                     const Cookies::GetCallback& callback) {
-  std::string url;
-  filter->GetString("url", &url);
-
-  auto filtered_callback =
-      base::Bind(FilterCookies, base::Passed(&filter), callback);
+  // Empty url will match all url cookies, which are served by the index.
+  if (filter->url.empty()) {
+    cookie_delegate->cookie_index()->Query(
+        GetCookieStore(getter), *filter,
+        base::Bind(OnCookieIndexQueried, callback));
+    return;
+  }
 
-  // Empty url will match all url cookies.
-  if (url.empty())
-    GetCookieStore(getter)->GetAllCookiesAsync(filtered_callback);
-  else
-    GetCookieStore(getter)->GetAllCookiesForURLAsync(GURL(url),
-        filtered_callback);
+  GURL url(filter->url);
+  GetCookieStore(getter)->GetAllCookiesForURLAsync(
+      url, base::Bind(FilterCookies, base::Passed(&filter), callback));
 }
 
 // Removes cookie with |url| and |name| in IO thread.
@@ -178,50 +165,233 @@ void OnSetCookie(const Cookies::SetCallback& callback, bool success) {
       base::Bind(callback, success ? Cookies::SUCCESS : Cookies::FAILED));
 }
 
+// The details of a cookie to set.
+struct CookieDetails {
+  CookieDetails() : secure(false), http_only(false) {}
+
+  GURL url;
+  std::string name;
+  std::string value;
+  std::string domain;
+  std::string path;
+  bool secure;
+  bool http_only;
+  base::Time creation_time;
+  base::Time expiration_time;
+  base::Time last_access_time;
+};
+
+// Converts a date of |details| to time, 0 means the epoch.
+base::Time GetTime(const base::DictionaryValue& details,
+                   const std::string& key) {
+  double date;
+  if (!details.GetDouble(key, &date))
+    return base::Time();
+  return date == 0 ? base::Time::UnixEpoch() : base::Time::FromDoubleT(date);
+}
+
+void ParseCookieDetails(const base::DictionaryValue& details,
+                        CookieDetails* parsed) {
+  std::string url;
+  details.GetString("url", &url);
+  parsed->url = GURL(url);
+  details.GetString("name", &parsed->name);
+  details.GetString("value", &parsed->value);
+  details.GetString("domain", &parsed->domain);
+  details.GetString("path", &parsed->path);
+  details.GetBoolean("secure", &parsed->secure);
+  details.GetBoolean("httpOnly", &parsed->http_only);
+  parsed->creation_time = GetTime(details, "creationDate");
+  parsed->expiration_time = GetTime(details, "expirationDate");
+  parsed->last_access_time = GetTime(details, "lastAccessDate");
+}
+
+// Sets cookie with |details| in IO thread, |callback| is called in IO thread.
+void SetCookieWithDetails(
+    net::CookieStore* cookie_store,
+    const CookieDetails& details,
+    const net::CookieStore::SetCookiesCallback& callback) {
+  cookie_store->SetCookieWithDetailsAsync(
+      details.url, details.name, details.value, details.domain, details.path,
+      details.creation_time, details.expiration_time, details.last_access_time,
+      details.secure, details.http_only, net::CookieSameSite::DEFAULT_MODE,
+      false, net::COOKIE_PRIORITY_DEFAULT, callback);
+}
+
 // Sets cookie with |details| in IO thread.
 void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
                    std::unique_ptr<base::DictionaryValue> details,
                    const Cookies::SetCallback& callback) {
-  std::string url, name, value, domain, path;
-  bool secure = false;
-  bool http_only = false;
-  double creation_date;
-  double expiration_date;
-  double last_access_date;
-  details->GetString("url", &url);
-  details->GetString("name", &name);
-  details->GetString("value", &value);
-  details->GetString("domain", &domain);
-  details->GetString("path", &path);
-  details->GetBoolean("secure", &secure);
-  details->GetBoolean("httpOnly", &http_only);
+  CookieDetails parsed;
+  ParseCookieDetails(*details, &parsed);
+  SetCookieWithDetails(GetCookieStore(getter), parsed,
+                       base::Bind(OnSetCookie, callback));
+}
 
-  base::Time creation_time;
-  if (details->GetDouble("creationDate", &creation_date)) {
-    creation_time = (creation_date == 0) ?
-        base::Time::UnixEpoch() :
-        base::Time::FromDoubleT(creation_date);
+// Tracks the operations of a batch in IO thread, and takes the changes of the
+// cookies written by them, which are notified together after the last
+// operation is done instead of one by one. The changes of other cookies are
+// notified as usual even if they happen meanwhile.
+class CookieBatch : public base::RefCounted<CookieBatch>,
+                    public AtomCookieDelegate::IOObserver {
+ public:
+  CookieBatch(scoped_refptr<AtomCookieDelegate> cookie_delegate,
+              const Cookies::SetCallback& callback)
+      : cookie_delegate_(cookie_delegate),
+        callback_(callback),
+        failed_(false) {
+    cookie_delegate_->AddIOObserver(this);
   }
 
-  base::Time expiration_time;
-  if (details->GetDouble("expirationDate", &expiration_date)) {
-    expiration_time = (expiration_date == 0) ?
-        base::Time::UnixEpoch() :
-        base::Time::FromDoubleT(expiration_date);
+  // Adds a cookie set by the batch.
+  void AddSetCookie(const net::CanonicalCookie& cookie) {
+    set_cookies_.push_back(cookie);
   }
 
-  base::Time last_access_time;
-  if (details->GetDouble("lastAccessDate", &last_access_date)) {
-    last_access_time = (last_access_date == 0) ?
-        base::Time::UnixEpoch() :
-        base::Time::FromDoubleT(last_access_date);
+  // Adds a cookie deleted by the batch.
+  void AddDeletedCookie(const net::CanonicalCookie& cookie) {
+    deleted_cookies_.push_back(cookie);
   }
 
-  GetCookieStore(getter)->SetCookieWithDetailsAsync(
-      GURL(url), name, value, domain, path, creation_time,
-      expiration_time, last_access_time, secure, http_only,
-      net::CookieSameSite::DEFAULT_MODE, false,
-      net::COOKIE_PRIORITY_DEFAULT, base::Bind(OnSetCookie, callback));
+  void OnSetCookie(bool success) {
+    if (!success)
+      failed_ = true;
+  }
+
+  void OnDeleteCookie(int num_deleted) {}
+
+  void Fail() { failed_ = true; }
+
+  // AtomCookieDelegate::IOObserver:
+  bool OnCookieChangedOnIO(const net::CanonicalCookie& cookie,
+                           bool removed,
+                           AtomCookieDelegate::ChangeCause cause) override {
+    if (!IsWrittenCookie(cookie, removed, cause))
+      return false;
+    changes_.push_back(
+        AtomCookieDelegate::CookieChange(cookie, removed, cause));
+    return true;
+  }
+
+ private:
+  friend class base::RefCounted<CookieBatch>;
+
+  // Every pending operation holds a reference, so the batch ends after the
+  // last one finishes.
+  ~CookieBatch() override {
+    cookie_delegate_->RemoveIOObserver(this);
+    if (!changes_.empty())
+      cookie_delegate_->NotifyBatch(changes_);
+    RunCallbackInUI(
+        base::Bind(callback_, failed_ ? Cookies::FAILED : Cookies::SUCCESS));
+  }
+
+  // Whether the change is made by the batch: setting a cookie inserts it and
+  // replaces the cookie with the same name, domain and path, deleting a cookie
+  // removes the exact cookie read from the store.
+  bool IsWrittenCookie(const net::CanonicalCookie& cookie,
+                       bool removed,
+                       AtomCookieDelegate::ChangeCause cause) const {
+    if (removed && cause == AtomCookieDelegate::CHANGE_COOKIE_EXPLICIT) {
+      for (const auto& deleted : deleted_cookies_) {
+        if (cookie.IsEquivalent(deleted) &&
+            cookie.CreationDate() == deleted.CreationDate())
+          return true;
+      }
+      return false;
+    }
+
+    bool replaced = removed &&
+        (cause == AtomCookieDelegate::CHANGE_COOKIE_OVERWRITE ||
+         cause == AtomCookieDelegate::CHANGE_COOKIE_EXPIRED_OVERWRITE);
+    if (removed && !replaced)
+      return false;
+    for (const auto& set : set_cookies_) {
+      if (cookie.IsEquivalent(set) &&
+          (replaced || cookie.Value() == set.Value()))
+        return true;
+    }
+    return false;
+  }
+
+  scoped_refptr<AtomCookieDelegate> cookie_delegate_;
+  Cookies::SetCallback callback_;
+  bool failed_;
+
+  std::vector<net::CanonicalCookie> set_cookies_;
+  std::vector<net::CanonicalCookie> deleted_cookies_;
+  std::vector<AtomCookieDelegate::CookieChange> changes_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieBatch);
+};
+
+// Sets all the cookies of |list| in IO thread.
+void SetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                    scoped_refptr<AtomCookieDelegate> cookie_delegate,
+                    std::unique_ptr<base::ListValue> list,
+                    const Cookies::SetCallback& callback) {
+  scoped_refptr<CookieBatch> batch(new CookieBatch(cookie_delegate, callback));
+  net::CookieStore* cookie_store = GetCookieStore(getter);
+  for (const auto& value : *list) {
+    const base::DictionaryValue* details = nullptr;
+    if (!value->GetAsDictionary(&details)) {
+      batch->Fail();
+      continue;
+    }
+    CookieDetails parsed;
+    ParseCookieDetails(*details, &parsed);
+    // Canonicalize the cookie the same way the store does, so its changes can
+    // be told apart from the ones of other cookies.
+    std::unique_ptr<net::CanonicalCookie> cookie(net::CanonicalCookie::Create(
+        parsed.url, parsed.name, parsed.value, parsed.domain, parsed.path,
+        parsed.creation_time, parsed.expiration_time, parsed.secure,
+        parsed.http_only, net::CookieSameSite::DEFAULT_MODE, false,
+        net::COOKIE_PRIORITY_DEFAULT));
+    if (!cookie) {
+      batch->Fail();
+      continue;
+    }
+    batch->AddSetCookie(*cookie);
+    SetCookieWithDetails(cookie_store, parsed,
+                         base::Bind(&CookieBatch::OnSetCookie, batch));
+  }
+}
+
+// Deletes the cookies of |cookies| named |name|.
+void DeleteCookiesNamed(scoped_refptr<net::URLRequestContextGetter> getter,
+                        scoped_refptr<CookieBatch> batch,
+                        const std::string& name,
+                        const net::CookieList& cookies) {
+  net::CookieStore* cookie_store = GetCookieStore(getter);
+  for (const auto& cookie : cookies) {
+    if (cookie.Name() != name)
+      continue;
+    batch->AddDeletedCookie(cookie);
+    cookie_store->DeleteCanonicalCookieAsync(
+        cookie, base::Bind(&CookieBatch::OnDeleteCookie, batch));
+  }
+}
+
+// Removes all the cookies of |list| in IO thread.
+void RemoveCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                       scoped_refptr<AtomCookieDelegate> cookie_delegate,
+                       std::unique_ptr<base::ListValue> list,
+                       const Cookies::SetCallback& callback) {
+  scoped_refptr<CookieBatch> batch(new CookieBatch(cookie_delegate, callback));
+  net::CookieStore* cookie_store = GetCookieStore(getter);
+  for (const auto& value : *list) {
+    const base::DictionaryValue* details = nullptr;
+    std::string url, name;
+    if (!value->GetAsDictionary(&details) ||
+        !details->GetString("url", &url) ||
+        !details->GetString("name", &name)) {
+      batch->Fail();
+      continue;
+    }
+    // Reads the cookies first, so the batch knows which ones it deletes.
+    cookie_store->GetAllCookiesForURLAsync(
+        GURL(url), base::Bind(DeleteCookiesNamed, getter, batch, name));
+  }
 }
 
 }  // namespace
@@ -240,11 +410,13 @@ Cookies::~Cookies() {
 
 void Cookies::Get(const base::DictionaryValue& filter,
                   const GetCallback& callback) {
-  std::unique_ptr<base::DictionaryValue> copied(filter.CreateDeepCopy());
+  std::unique_ptr<CookieFilter> parsed(new CookieFilter);
+  parsed->Parse(filter);
   auto getter = make_scoped_refptr(request_context_getter_);
   content::BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
-      base::Bind(GetCookiesOnIO, getter, Passed(&copied), callback));
+      base::Bind(GetCookiesOnIO, getter, cookie_delegate_, Passed(&parsed),
+                 callback));
 }
 
 void Cookies::Remove(const GURL& url, const std::string& name,
@@ -264,12 +436,37 @@ void Cookies::Set(const base::DictionaryValue& details,
       base::Bind(SetCookieOnIO, getter, Passed(&copied), callback));
 }
 
+void Cookies::SetMany(const base::ListValue& list,
+                      const SetCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(list.CreateDeepCopy());
+  auto getter = make_scoped_refptr(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(SetCookiesOnIO, getter, cookie_delegate_, Passed(&copied),
+                 callback));
+}
+
+void Cookies::RemoveMany(const base::ListValue& list,
+                         const SetCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(list.CreateDeepCopy());
+  auto getter = make_scoped_refptr(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(RemoveCookiesOnIO, getter, cookie_delegate_, Passed(&copied),
+                 callback));
+}
+
 void Cookies::OnCookieChanged(const net::CanonicalCookie& cookie,
                               bool removed,
                               AtomCookieDelegate::ChangeCause cause) {
   Emit("changed", cookie, cause, removed);
 }
 
+void Cookies::OnCookiesChanged(
+    const std::vector<AtomCookieDelegate::CookieChange>& changes) {
+  Emit("changed-batch", changes);
+}
+
 
 // static
 mate::Handle<Cookies> Cookies::Create(
@@ -285,7 +482,9 @@ void Cookies::BuildPrototype(v8::Isolate* isolate,
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("get", &Cookies::Get)
       .SetMethod("remove", &Cookies::Remove)
-      .SetMethod("set", &Cookies::Set);
+      .SetMethod("set", &Cookies::Set)
+      .SetMethod("setMany", &Cookies::SetMany)
+      .SetMethod("removeMany", &Cookies::RemoveMany);
 }
 
 }  // namespace api
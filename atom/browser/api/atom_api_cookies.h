@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/net/atom_cookie_delegate.h"
@@ -15,6 +16,7 @@
 
 namespace base {
 class DictionaryValue;
+class ListValue;
 }
 
 namespace net {
@@ -54,10 +56,17 @@ class Cookies : public mate::TrackableObject<Cookies>,
               const base::Closure& callback);
   void Set(const base::DictionaryValue& details, const SetCallback& callback);
 
+  // Applies a list of changes in one IO thread task, the changes are reported
+  // by a single "changed-batch" event instead of "changed" events.
+  void SetMany(const base::ListValue& list, const SetCallback& callback);
+  void RemoveMany(const base::ListValue& list, const SetCallback& callback);
+
   // AtomCookieDelegate::Observer:
   void OnCookieChanged(const net::CanonicalCookie& cookie,
                        bool removed,
                        AtomCookieDelegate::ChangeCause cause) override;
+  void OnCookiesChanged(
+      const std::vector<AtomCookieDelegate::CookieChange>& changes) override;
 
  private:
   net::URLRequestContextGetter* request_context_getter_;
@@ -0,0 +1,112 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_node_worker.h"
+
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/node_includes.h"
+#include "native_mate/constructor.h"
+#include "native_mate/dictionary.h"
+
+namespace atom {
+
+namespace api {
+
+NodeWorker::NodeWorker(v8::Isolate* isolate, v8::Local<v8::Object> wrapper,
+                       const base::FilePath& script_path)
+    : worker_(new NodeWorkerThread(this, script_path)) {
+  InitWith(isolate, wrapper);
+
+  worker_->Start();
+  Pin();
+}
+
+NodeWorker::~NodeWorker() {
+}
+
+// static
+mate::WrappableBase* NodeWorker::New(const base::FilePath& script_path,
+                                     mate::Arguments* args) {
+  if (!script_path.IsAbsolute()) {
+    args->ThrowError("The script path must be absolute");
+    return nullptr;
+  }
+  return new NodeWorker(args->isolate(), args->GetThis(), script_path);
+}
+
+void NodeWorker::OnWorkerMessage(const std::string& message) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> value;
+  v8::Local<v8::String> json = mate::StringToV8(isolate(), message);
+  if (!v8::JSON::Parse(isolate(), json).ToLocal(&value))
+    return;
+  Emit("message", value);
+}
+
+void NodeWorker::OnWorkerError(const std::string& error) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  Emit("uncaught-exception", error);
+}
+
+void NodeWorker::OnWorkerExit(int exit_code) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  Emit("exit", exit_code);
+  Unpin();
+}
+
+void NodeWorker::PostMessage(const std::string& message) {
+  worker_->PostMessage(message);
+}
+
+void NodeWorker::Terminate() {
+  worker_->Terminate();
+}
+
+bool NodeWorker::IsRunning() const {
+  return worker_->is_running();
+}
+
+void NodeWorker::Pin() {
+  if (wrapper_.IsEmpty())
+    wrapper_.Reset(isolate(), GetWrapper());
+}
+
+void NodeWorker::Unpin() {
+  wrapper_.Reset();
+}
+
+// static
+void NodeWorker::BuildPrototype(v8::Isolate* isolate,
+                                v8::Local<v8::FunctionTemplate> prototype) {
+  prototype->SetClassName(mate::StringToV8(isolate, "NodeWorker"));
+  mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
+      .SetMethod("_postMessage", &NodeWorker::PostMessage)
+      .SetMethod("terminate", &NodeWorker::Terminate)
+      .SetMethod("isRunning", &NodeWorker::IsRunning);
+}
+
+}  // namespace api
+
+}  // namespace atom
+
+
+namespace {
+
+using atom::api::NodeWorker;
+
+void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context, void* priv) {
+  v8::Isolate* isolate = context->GetIsolate();
+  NodeWorker::SetConstructor(isolate, base::Bind(&NodeWorker::New));
+
+  mate::Dictionary dict(isolate, exports);
+  dict.Set("NodeWorker", NodeWorker::GetConstructor(isolate)->GetFunction());
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_browser_node_worker, Initialize)
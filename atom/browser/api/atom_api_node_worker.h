@@ -0,0 +1,67 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_NODE_WORKER_H_
+#define ATOM_BROWSER_API_ATOM_API_NODE_WORKER_H_
+
+#include <memory>
+#include <string>
+
+#include "atom/browser/api/trackable_object.h"
+#include "atom/browser/node_worker_thread.h"
+#include "native_mate/handle.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace mate {
+class Arguments;
+}
+
+namespace atom {
+
+namespace api {
+
+class NodeWorker : public mate::TrackableObject<NodeWorker>,
+                   public NodeWorkerThread::Delegate {
+ public:
+  static mate::WrappableBase* New(const base::FilePath& script_path,
+                                  mate::Arguments* args);
+
+  static void BuildPrototype(v8::Isolate* isolate,
+                             v8::Local<v8::FunctionTemplate> prototype);
+
+ protected:
+  NodeWorker(v8::Isolate* isolate, v8::Local<v8::Object> wrapper,
+             const base::FilePath& script_path);
+  ~NodeWorker() override;
+
+  // NodeWorkerThread::Delegate:
+  void OnWorkerMessage(const std::string& message) override;
+  void OnWorkerError(const std::string& error) override;
+  void OnWorkerExit(int exit_code) override;
+
+  void PostMessage(const std::string& message);
+  void Terminate();
+  bool IsRunning() const;
+
+ private:
+  // Keeps the JavaScript object alive while the worker is running.
+  void Pin();
+  void Unpin();
+
+  std::unique_ptr<NodeWorkerThread> worker_;
+
+  // Used to implement pin/unpin.
+  v8::Global<v8::Object> wrapper_;
+
+  DISALLOW_COPY_AND_ASSIGN(NodeWorker);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_NODE_WORKER_H_
@@ -4,6 +4,9 @@
 
 #include "atom/browser/api/atom_api_protocol.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/browser.h"
@@ -12,11 +15,14 @@
 #include "atom/browser/net/url_request_fetch_job.h"
 #include "atom/browser/net/url_request_string_job.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
 #include "base/command_line.h"
 #include "base/strings/string_util.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "content/public/browser/child_process_security_policy.h"
 #include "native_mate/dictionary.h"
 #include "url/url_util.h"
@@ -29,6 +35,9 @@ namespace api {
 
 namespace {
 
+// The default size of the response cache of a protocol.
+const int kDefaultResponseCacheSize = 16 * 1024 * 1024;
+
 // List of registered custom standard schemes.
 std::vector<std::string> g_standard_schemes;
 
@@ -86,8 +95,110 @@ void Protocol::RegisterServiceWorkerSchemes(
   atom::AtomBrowserClient::SetCustomServiceWorkerSchemes(schemes);
 }
 
+scoped_refptr<ResponseCache> Protocol::CreateResponseCache(
+    mate::Arguments* args) {
+  // The options are optional, the next argument may be the callback.
+  v8::Local<v8::Value> next = args->PeekNext();
+  mate::Dictionary options;
+  if (next.IsEmpty() || next->IsFunction() || !args->GetNext(&options))
+    return nullptr;
+
+  mate::Dictionary cache;
+  if (!options.Get("cache", &cache))
+    return nullptr;
+  int max_size = kDefaultResponseCacheSize;
+  cache.Get("maxSize", &max_size);
+  std::vector<std::string> vary_headers;
+  cache.Get("varyHeaders", &vary_headers);
+  return new ResponseCache(std::max(max_size, 0), vary_headers);
+}
+
+void Protocol::OnRegistered(const std::string& scheme,
+                            scoped_refptr<ResponseCache> response_cache,
+                            const CompletionCallback& callback,
+                            ProtocolError error) {
+  if (error == PROTOCOL_OK && response_cache)
+    response_caches_[scheme] = response_cache;
+  OnIOCompleted(callback, error);
+}
+
+void Protocol::ClearResponseCache(const std::string& scheme,
+                                  mate::Arguments* args) {
+  GURL url;
+  if (args->PeekNext()->IsString())
+    args->GetNext(&url);
+  CompletionCallback callback;
+  args->GetNext(&callback);
+
+  auto iter = response_caches_.find(scheme);
+  if (iter == response_caches_.end()) {
+    OnIOCompleted(callback, PROTOCOL_NOT_REGISTERED);
+    return;
+  }
+  content::BrowserThread::PostTaskAndReply(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&ResponseCache::Invalidate, iter->second, url),
+      base::Bind(&Protocol::OnIOCompleted,
+                 GetWeakPtr(), callback, PROTOCOL_OK));
+}
+
+void Protocol::RegisterFileSystemProtocol(const std::string& scheme,
+                                          const mate::Dictionary& options,
+                                          mate::Arguments* args) {
+  FileSystemProtocolOptions file_system_options;
+  if (!options.Get("root", &file_system_options.root) ||
+      !file_system_options.root.IsAbsolute()) {
+    args->ThrowError("root must be an absolute path");
+    return;
+  }
+  if (options.Get("spaFallback", &file_system_options.fallback) &&
+      file_system_options.fallback.IsAbsolute()) {
+    args->ThrowError("spaFallback must be relative to root");
+    return;
+  }
+  base::DictionaryValue headers;
+  if (options.Get("headers", &headers)) {
+    for (base::DictionaryValue::Iterator it(headers); !it.IsAtEnd();
+         it.Advance()) {
+      std::string value;
+      if (it.value().GetAsString(&value))
+        file_system_options.headers.push_back(std::make_pair(it.key(), value));
+    }
+  }
+
+  CompletionCallback callback;
+  args->GetNext(&callback);
+  content::BrowserThread::PostTaskAndReplyWithResult(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&Protocol::RegisterFileSystemProtocolInIO,
+                 request_context_getter_, scheme, file_system_options),
+      base::Bind(&Protocol::OnIOCompleted,
+                 GetWeakPtr(), callback));
+}
+
+// static
+Protocol::ProtocolError Protocol::RegisterFileSystemProtocolInIO(
+    scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
+    const std::string& scheme,
+    const FileSystemProtocolOptions& options) {
+  auto job_factory = static_cast<AtomURLRequestJobFactory*>(
+      request_context_getter->job_factory());
+  if (job_factory->IsHandledProtocol(scheme))
+    return PROTOCOL_REGISTERED;
+  std::unique_ptr<FileSystemProtocolHandler> protocol_handler(
+      new FileSystemProtocolHandler(
+          options,
+          BrowserThread::GetBlockingPool()->GetTaskRunnerWithShutdownBehavior(
+              base::SequencedWorkerPool::SKIP_ON_SHUTDOWN)));
+  if (job_factory->SetProtocolHandler(scheme, std::move(protocol_handler)))
+    return PROTOCOL_OK;
+  else
+    return PROTOCOL_FAIL;
+}
+
 void Protocol::UnregisterProtocol(
     const std::string& scheme, mate::Arguments* args) {
+  response_caches_.erase(scheme);
   CompletionCallback callback;
   args->GetNext(&callback);
   content::BrowserThread::PostTaskAndReplyWithResult(
@@ -203,6 +314,9 @@ void Protocol::BuildPrototype(
                  &Protocol::RegisterProtocol<URLRequestAsyncAsarJob>)
       .SetMethod("registerHttpProtocol",
                  &Protocol::RegisterProtocol<URLRequestFetchJob>)
+      .SetMethod("registerFileSystemProtocol",
+                 &Protocol::RegisterFileSystemProtocol)
+      .SetMethod("clearResponseCache", &Protocol::ClearResponseCache)
       .SetMethod("unregisterProtocol", &Protocol::UnregisterProtocol)
       .SetMethod("isProtocolHandled", &Protocol::IsProtocolHandled)
       .SetMethod("interceptStringProtocol",
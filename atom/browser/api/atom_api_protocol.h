@@ -11,6 +11,8 @@
 
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/atom_browser_context.h"
+#include "atom/browser/net/file_system_protocol_handler.h"
+#include "atom/browser/net/response_cache.h"
 #include "atom/browser/net/atom_url_request_job_factory.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
@@ -69,17 +71,20 @@ class Protocol : public mate::TrackableObject<Protocol> {
     CustomProtocolHandler(
         v8::Isolate* isolate,
         net::URLRequestContextGetter* request_context,
-        const Handler& handler)
+        const Handler& handler,
+        ResponseCache* response_cache)
         : isolate_(isolate),
           request_context_(request_context),
-          handler_(handler) {}
+          handler_(handler),
+          response_cache_(response_cache) {}
     ~CustomProtocolHandler() override {}
 
     net::URLRequestJob* MaybeCreateJob(
         net::URLRequest* request,
         net::NetworkDelegate* network_delegate) const override {
       RequestJob* request_job = new RequestJob(request, network_delegate);
-      request_job->SetHandlerInfo(isolate_, request_context_.get(), handler_);
+      request_job->SetHandlerInfo(isolate_, request_context_.get(), handler_,
+                                  response_cache_.get());
       return request_job;
     }
 
@@ -87,6 +92,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
     v8::Isolate* isolate_;
     scoped_refptr<net::URLRequestContextGetter> request_context_;
     Protocol::Handler handler_;
+    scoped_refptr<ResponseCache> response_cache_;
 
     DISALLOW_COPY_AND_ASSIGN(CustomProtocolHandler);
   };
@@ -99,34 +105,60 @@ class Protocol : public mate::TrackableObject<Protocol> {
   void RegisterProtocol(const std::string& scheme,
                         const Handler& handler,
                         mate::Arguments* args) {
+    scoped_refptr<ResponseCache> response_cache = CreateResponseCache(args);
     CompletionCallback callback;
     args->GetNext(&callback);
     content::BrowserThread::PostTaskAndReplyWithResult(
         content::BrowserThread::IO, FROM_HERE,
         base::Bind(&Protocol::RegisterProtocolInIO<RequestJob>,
-                   request_context_getter_, isolate(), scheme, handler),
-        base::Bind(&Protocol::OnIOCompleted,
-                   GetWeakPtr(), callback));
+                   request_context_getter_, isolate(), scheme, handler,
+                   response_cache),
+        base::Bind(&Protocol::OnRegistered,
+                   GetWeakPtr(), scheme, response_cache, callback));
   }
   template<typename RequestJob>
   static ProtocolError RegisterProtocolInIO(
       scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
       v8::Isolate* isolate,
       const std::string& scheme,
-      const Handler& handler) {
+      const Handler& handler,
+      scoped_refptr<ResponseCache> response_cache) {
     auto job_factory = static_cast<AtomURLRequestJobFactory*>(
         request_context_getter->job_factory());
     if (job_factory->IsHandledProtocol(scheme))
       return PROTOCOL_REGISTERED;
     std::unique_ptr<CustomProtocolHandler<RequestJob>> protocol_handler(
         new CustomProtocolHandler<RequestJob>(
-            isolate, request_context_getter.get(), handler));
+            isolate, request_context_getter.get(), handler,
+            response_cache.get()));
     if (job_factory->SetProtocolHandler(scheme, std::move(protocol_handler)))
       return PROTOCOL_OK;
     else
       return PROTOCOL_FAIL;
   }
 
+  // Create the response cache when the options of registering a protocol ask
+  // for it.
+  scoped_refptr<ResponseCache> CreateResponseCache(mate::Arguments* args);
+
+  // Keep the response cache of a registered protocol for clearing it.
+  void OnRegistered(const std::string& scheme,
+                    scoped_refptr<ResponseCache> response_cache,
+                    const CompletionCallback& callback,
+                    ProtocolError error);
+
+  // Drop the cached responses of |scheme|.
+  void ClearResponseCache(const std::string& scheme, mate::Arguments* args);
+
+  // Register the protocol serving the files under a directory.
+  void RegisterFileSystemProtocol(const std::string& scheme,
+                                  const mate::Dictionary& options,
+                                  mate::Arguments* args);
+  static ProtocolError RegisterFileSystemProtocolInIO(
+      scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
+      const std::string& scheme,
+      const FileSystemProtocolOptions& options);
+
   // Unregister the protocol handler that handles |scheme|.
   void UnregisterProtocol(const std::string& scheme, mate::Arguments* args);
   static ProtocolError UnregisterProtocolInIO(
@@ -169,7 +201,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
       return PROTOCOL_FAIL;
     std::unique_ptr<CustomProtocolHandler<RequestJob>> protocol_handler(
         new CustomProtocolHandler<RequestJob>(
-            isolate, request_context_getter.get(), handler));
+            isolate, request_context_getter.get(), handler, nullptr));
     if (!job_factory->InterceptProtocol(scheme, std::move(protocol_handler)))
       return PROTOCOL_INTERCEPTED;
     return PROTOCOL_OK;
@@ -194,6 +226,10 @@ class Protocol : public mate::TrackableObject<Protocol> {
   }
 
   scoped_refptr<brightray::URLRequestContextGetter> request_context_getter_;
+
+  // The response caches of registered protocols.
+  std::map<std::string, scoped_refptr<ResponseCache>> response_caches_;
+
   base::WeakPtrFactory<Protocol> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Protocol);
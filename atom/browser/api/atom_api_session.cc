@@ -8,10 +8,12 @@
 #include <string>
 #include <vector>
 
+#include "atom/browser/api/atom_api_cache.h"
 #include "atom/browser/api/atom_api_cookies.h"
 #include "atom/browser/api/atom_api_download_item.h"
 #include "atom/browser/api/atom_api_protocol.h"
 #include "atom/browser/api/atom_api_web_request.h"
+#include "atom/browser/api/spare_renderer_pool.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/atom_permission_manager.h"
@@ -39,13 +41,19 @@
 #include "content/public/browser/storage_partition.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "net/base/address_list.h"
 #include "net/base/load_flags.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/dns/host_cache.h"
+#include "net/dns/host_resolver.h"
 #include "net/http/http_auth_handler_factory.h"
 #include "net/http/http_auth_preferences.h"
+#include "net/http/http_network_session.h"
+#include "net/http/http_request_info.h"
+#include "net/http/http_stream_factory.h"
 #include "net/proxy/proxy_config_service_fixed.h"
 #include "net/proxy/proxy_service.h"
+#include "net/url_request/http_user_agent_settings.h"
 #include "net/url_request/static_http_user_agent_settings.h"
 #include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_context_getter.h"
@@ -214,6 +222,9 @@ namespace {
 
 const char kPersistPrefix[] = "persist:";
 
+// Same with the maximum sockets per group of the socket pools.
+const int kMaxPreconnectSockets = 6;
+
 // Referenced session objects.
 std::map<uint32_t, v8::Global<v8::Object>> g_sessions;
 
@@ -356,6 +367,66 @@ void ClearHostResolverCacheInIO(
   }
 }
 
+// Resolves a host speculatively so the result is in the host cache when the
+// first request starts. It deletes itself when done.
+class HostPrefetcher {
+ public:
+  static void Start(net::HostResolver* host_resolver, const std::string& host) {
+    auto* prefetcher = new HostPrefetcher;
+    net::HostResolver::RequestInfo info(net::HostPortPair(host, 80));
+    info.set_is_speculative(true);
+    int rv = host_resolver->Resolve(
+        info, net::IDLE, &prefetcher->addresses_,
+        base::Bind(&HostPrefetcher::OnResolved,
+                   base::Unretained(prefetcher)),
+        &prefetcher->request_, net::BoundNetLog());
+    if (rv != net::ERR_IO_PENDING)
+      delete prefetcher;
+  }
+
+ private:
+  HostPrefetcher() {}
+
+  void OnResolved(int result) {
+    delete this;
+  }
+
+  net::AddressList addresses_;
+  std::unique_ptr<net::HostResolver::Request> request_;
+
+  DISALLOW_COPY_AND_ASSIGN(HostPrefetcher);
+};
+
+void PrefetchDNSInIO(
+    const scoped_refptr<net::URLRequestContextGetter>& context_getter,
+    const std::vector<std::string>& hosts) {
+  auto host_resolver = context_getter->GetURLRequestContext()->host_resolver();
+  for (const std::string& host : hosts)
+    HostPrefetcher::Start(host_resolver, host);
+}
+
+void PreconnectInIO(
+    const scoped_refptr<net::URLRequestContextGetter>& context_getter,
+    const GURL& url,
+    int num_sockets) {
+  auto request_context = context_getter->GetURLRequestContext();
+  auto network_session =
+      request_context->http_transaction_factory()->GetSession();
+  if (!network_session)
+    return;
+
+  net::HttpRequestInfo request_info;
+  request_info.url = url;
+  request_info.method = "GET";
+  // The user agent is sent in the CONNECT requests of proxy tunnels.
+  auto user_agent_settings = request_context->http_user_agent_settings();
+  if (user_agent_settings)
+    request_info.extra_headers.SetHeader(net::HttpRequestHeaders::kUserAgent,
+                                         user_agent_settings->GetUserAgent());
+  network_session->http_stream_factory()->PreconnectStreams(num_sockets,
+                                                            request_info);
+}
+
 void ClearAuthCacheInIO(
     const scoped_refptr<net::URLRequestContextGetter>& context_getter,
     const ClearAuthCacheOptions& options,
@@ -553,6 +624,21 @@ void Session::SetCertVerifyProc(v8::Local<v8::Value> val,
                  proc));
 }
 
+void Session::SetSpareRendererPool(size_t size, mate::Arguments* args) {
+  base::DictionaryValue web_preferences;
+  if (args->Length() > 1 && !args->GetNext(&web_preferences)) {
+    args->ThrowError("Must pass an object as webPreferences");
+    return;
+  }
+
+  if (!spare_renderer_pool_) {
+    if (size == 0)
+      return;
+    spare_renderer_pool_.reset(new SpareRendererPool(isolate(), this));
+  }
+  spare_renderer_pool_->SetSize(web_preferences, size);
+}
+
 void Session::SetPermissionRequestHandler(v8::Local<v8::Value> val,
                                           mate::Arguments* args) {
   AtomPermissionManager::RequestHandler handler;
@@ -575,6 +661,33 @@ void Session::ClearHostResolverCache(mate::Arguments* args) {
                  callback));
 }
 
+void Session::Preconnect(const mate::Dictionary& options,
+                         mate::Arguments* args) {
+  GURL url;
+  if (!options.Get("url", &url) || !url.SchemeIsHTTPOrHTTPS()) {
+    args->ThrowError("Must pass an http or https url");
+    return;
+  }
+  int num_sockets = 1;
+  options.Get("numSockets", &num_sockets);
+  if (num_sockets < 1 || num_sockets > kMaxPreconnectSockets) {
+    args->ThrowError("numSockets must be between 1 and 6");
+    return;
+  }
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&PreconnectInIO,
+                 make_scoped_refptr(browser_context_->GetRequestContext()),
+                 url, num_sockets));
+}
+
+void Session::PrefetchDNS(const std::vector<std::string>& hosts) {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&PrefetchDNSInIO,
+                 make_scoped_refptr(browser_context_->GetRequestContext()),
+                 hosts));
+}
+
 void Session::ClearAuthCache(mate::Arguments* args) {
   ClearAuthCacheOptions options;
   if (!args->GetNext(&options)) {
@@ -661,6 +774,14 @@ void Session::CreateInterruptedDownload(const mate::Dictionary& options) {
       length, last_modified, etag, base::Time::FromDoubleT(start_time)));
 }
 
+v8::Local<v8::Value> Session::Cache(v8::Isolate* isolate) {
+  if (cache_.IsEmpty()) {
+    auto handle = atom::api::Cache::Create(isolate, browser_context());
+    cache_.Reset(isolate, handle.ToV8());
+  }
+  return v8::Local<v8::Value>::New(isolate, cache_);
+}
+
 v8::Local<v8::Value> Session::Cookies(v8::Isolate* isolate) {
   if (cookies_.IsEmpty()) {
     auto handle = Cookies::Create(isolate, browser_context());
@@ -739,6 +860,8 @@ void Session::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setPermissionRequestHandler",
                  &Session::SetPermissionRequestHandler)
       .SetMethod("clearHostResolverCache", &Session::ClearHostResolverCache)
+      .SetMethod("preconnect", &Session::Preconnect)
+      .SetMethod("prefetchDNS", &Session::PrefetchDNS)
       .SetMethod("clearAuthCache", &Session::ClearAuthCache)
       .SetMethod("allowNTLMCredentialsForDomains",
                  &Session::AllowNTLMCredentialsForDomains)
@@ -747,6 +870,8 @@ void Session::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("getBlobData", &Session::GetBlobData)
       .SetMethod("createInterruptedDownload",
                  &Session::CreateInterruptedDownload)
+      .SetMethod("setSpareRendererPool", &Session::SetSpareRendererPool)
+      .SetProperty("cache", &Session::Cache)
       .SetProperty("cookies", &Session::Cookies)
       .SetProperty("protocol", &Session::Protocol)
       .SetProperty("webRequest", &Session::WebRequest);
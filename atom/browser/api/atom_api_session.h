@@ -5,7 +5,9 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_SESSION_H_
 #define ATOM_BROWSER_API_ATOM_API_SESSION_H_
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/atom_blob_reader.h"
@@ -35,6 +37,8 @@ class AtomBrowserContext;
 
 namespace api {
 
+class SpareRendererPool;
+
 class Session: public mate::TrackableObject<Session>,
                public content::DownloadManager::Observer {
  public:
@@ -56,6 +60,11 @@ class Session: public mate::TrackableObject<Session>,
 
   AtomBrowserContext* browser_context() const { return browser_context_.get(); }
 
+  // Returns null when no spare renderers have been requested.
+  SpareRendererPool* spare_renderer_pool() const {
+    return spare_renderer_pool_.get();
+  }
+
   // mate::TrackableObject:
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
@@ -74,6 +83,8 @@ class Session: public mate::TrackableObject<Session>,
   void SetPermissionRequestHandler(v8::Local<v8::Value> val,
                                    mate::Arguments* args);
   void ClearHostResolverCache(mate::Arguments* args);
+  void Preconnect(const mate::Dictionary& options, mate::Arguments* args);
+  void PrefetchDNS(const std::vector<std::string>& hosts);
   void ClearAuthCache(mate::Arguments* args);
   void AllowNTLMCredentialsForDomains(const std::string& domains);
   void SetUserAgent(const std::string& user_agent, mate::Arguments* args);
@@ -81,6 +92,8 @@ class Session: public mate::TrackableObject<Session>,
   void GetBlobData(const std::string& uuid,
                    const AtomBlobReader::CompletionCallback& callback);
   void CreateInterruptedDownload(const mate::Dictionary& options);
+  void SetSpareRendererPool(size_t size, mate::Arguments* args);
+  v8::Local<v8::Value> Cache(v8::Isolate* isolate);
   v8::Local<v8::Value> Cookies(v8::Isolate* isolate);
   v8::Local<v8::Value> Protocol(v8::Isolate* isolate);
   v8::Local<v8::Value> WebRequest(v8::Isolate* isolate);
@@ -95,6 +108,7 @@ class Session: public mate::TrackableObject<Session>,
 
  private:
   // Cached object.
+  v8::Global<v8::Value> cache_;
   v8::Global<v8::Value> cookies_;
   v8::Global<v8::Value> protocol_;
   v8::Global<v8::Value> web_request_;
@@ -104,6 +118,8 @@ class Session: public mate::TrackableObject<Session>,
 
   scoped_refptr<AtomBrowserContext> browser_context_;
 
+  std::unique_ptr<SpareRendererPool> spare_renderer_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(Session);
 };
 
@@ -6,6 +6,8 @@
 
 #include <set>
 #include <string>
+#include <tuple>
+#include <utility>
 
 #include "atom/browser/api/atom_api_debugger.h"
 #include "atom/browser/api/atom_api_session.h"
@@ -15,6 +17,7 @@
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/atom_security_state_model_client.h"
 #include "atom/browser/lib/bluetooth_chooser.h"
+#include "atom/browser/message_port_filter.h"
 #include "atom/browser/native_window.h"
 #include "atom/browser/net/atom_network_delegate.h"
 #include "atom/browser/osr/osr_output_device.h"
@@ -239,7 +242,10 @@ WebContents::WebContents(v8::Isolate* isolate,
       type_(type),
       request_id_(0),
       background_throttling_(true),
-      enable_devtools_(true) {
+      ipc_subscriptions_reported_(false),
+      enable_devtools_(true),
+      reuse_renderer_process_(false),
+      next_script_request_id_(0) {
 
   if (type == REMOTE) {
     web_contents->SetUserAgentOverride(GetBrowserContext()->GetUserAgent());
@@ -255,11 +261,20 @@ WebContents::WebContents(v8::Isolate* isolate,
 
 WebContents::WebContents(v8::Isolate* isolate,
                          const mate::Dictionary& options)
+    : WebContents(isolate, options, nullptr) {
+}
+
+WebContents::WebContents(v8::Isolate* isolate,
+                         const mate::Dictionary& options,
+                         std::unique_ptr<content::WebContents> spare)
     : embedder_(nullptr),
       type_(BROWSER_WINDOW),
       request_id_(0),
       background_throttling_(true),
-      enable_devtools_(true) {
+      ipc_subscriptions_reported_(false),
+      enable_devtools_(true),
+      reuse_renderer_process_(false),
+      next_script_request_id_(0) {
   // Read options.
   options.Get("backgroundThrottling", &background_throttling_);
 
@@ -313,12 +328,21 @@ WebContents::WebContents(v8::Isolate* isolate,
 
     web_contents = content::WebContents::Create(params);
     view->SetWebContents(web_contents);
+  } else if (spare) {
+    // The first LoadURL keeps the launched renderer process.
+    web_contents = spare.release();
+    reuse_renderer_process_ = true;
   } else {
     content::WebContents::CreateParams params(session->browser_context());
     web_contents = content::WebContents::Create(params);
   }
 
   InitWithSessionAndOptions(isolate, web_contents, session, options);
+
+  // The pages loaded from now on are the window's, which get node and the
+  // preload script.
+  if (reuse_renderer_process_)
+    Send(new AtomViewMsg_ClaimSpare(routing_id()));
 }
 
 void WebContents::InitWithSessionAndOptions(v8::Isolate* isolate,
@@ -625,10 +649,47 @@ void WebContents::RenderViewCreated(content::RenderViewHost* render_view_host) {
 }
 
 void WebContents::RenderViewDeleted(content::RenderViewHost* render_view_host) {
+  MessagePortFilter::ClosePortsOfView(render_view_host->GetProcess()->GetID(),
+                                      render_view_host->GetRoutingID());
   Emit("render-view-deleted", render_view_host->GetProcess()->GetID());
 }
 
+void WebContents::RenderFrameDeleted(
+    content::RenderFrameHost* render_frame_host) {
+  std::vector<ExecuteJavaScriptCallback> callbacks;
+  for (auto it = pending_scripts_.begin(); it != pending_scripts_.end();) {
+    if (it->second.frame == render_frame_host) {
+      callbacks.push_back(it->second.callback);
+      it = pending_scripts_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (callbacks.empty())
+    return;
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  for (const auto& callback : callbacks)
+    callback.Run(v8::Exception::Error(mate::StringToV8(
+                     isolate(), "The frame has been destroyed")),
+                 v8::Null(isolate()));
+}
+
+void WebContents::RenderViewHostChanged(content::RenderViewHost* old_host,
+                                        content::RenderViewHost* new_host) {
+  // The ports were connected to the document of the old render view.
+  if (old_host)
+    MessagePortFilter::ClosePortsOfView(old_host->GetProcess()->GetID(),
+                                        old_host->GetRoutingID());
+  // The new render view reports its own listeners.
+  ipc_subscriptions_.clear();
+  ipc_subscriptions_reported_ = false;
+}
+
 void WebContents::RenderProcessGone(base::TerminationStatus status) {
+  ipc_subscriptions_.clear();
+  ipc_subscriptions_reported_ = false;
   Emit("crashed", status == base::TERMINATION_STATUS_PROCESS_WAS_KILLED);
 }
 
@@ -717,6 +778,10 @@ void WebContents::DidFinishNavigation(
     auto url = navigation_handle->GetURL();
     bool is_in_page = navigation_handle->IsSamePage();
     if (is_main_frame && !is_in_page) {
+      // The ports were connected to the previous document of the view.
+      auto host = navigation_handle->GetRenderFrameHost()->GetRenderViewHost();
+      MessagePortFilter::ClosePortsOfView(host->GetProcess()->GetID(),
+                                          host->GetRoutingID());
       Emit("did-navigate", url);
     } else if (is_in_page) {
       Emit("did-navigate-in-page", url, is_main_frame);
@@ -796,6 +861,11 @@ bool WebContents::OnMessageReceived(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message, OnRendererMessage)
     IPC_MESSAGE_HANDLER_DELAY_REPLY(AtomViewHostMsg_Message_Sync,
                                     OnRendererMessageSync)
+    IPC_MESSAGE_HANDLER_GENERIC(AtomViewHostMsg_SetChannelSubscribed,
+                                OnSetChannelSubscribed(message))
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_ReportJank, OnReportJank)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_ReportMemoryPurge,
+                        OnReportMemoryPurge)
     IPC_MESSAGE_HANDLER_CODE(ViewHostMsg_SetCursor, OnCursorChange,
       handled = false)
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -804,6 +874,19 @@ bool WebContents::OnMessageReceived(const IPC::Message& message) {
   return handled;
 }
 
+bool WebContents::OnMessageReceived(
+    const IPC::Message& message,
+    content::RenderFrameHost* render_frame_host) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP_WITH_PARAM(WebContents, message, render_frame_host)
+    IPC_MESSAGE_HANDLER(AtomFrameHostMsg_ExecuteJavaScriptResponse,
+                        OnExecuteJavaScriptResponse)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+
+  return handled;
+}
+
 // There are three ways of destroying a webContents:
 // 1. call webContents.destroy();
 // 2. garbage collection;
@@ -894,6 +977,11 @@ void WebContents::LoadURL(const GURL& url, const mate::Dictionary& options) {
   params.transition_type = ui::PAGE_TRANSITION_TYPED;
   params.should_clear_history_list = true;
   params.override_user_agent = content::NavigationController::UA_OVERRIDE_TRUE;
+  if (reuse_renderer_process_) {
+    reuse_renderer_process_ = false;
+    atom::AtomBrowserClient::SuppressRendererProcessRestartForOnce(
+        web_contents());
+  }
   web_contents()->GetController().LoadURLWithParams(params);
 
   // Set the background color of RenderWidgetHostView.
@@ -1248,12 +1336,110 @@ void WebContents::TabTraverse(bool reverse) {
   web_contents()->FocusThroughTabTraversal(reverse);
 }
 
+std::vector<mate::Dictionary> WebContents::GetFrames(v8::Isolate* isolate) {
+  std::vector<mate::Dictionary> frames;
+  for (content::RenderFrameHost* frame : web_contents()->GetAllFrames()) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+    dict.Set("routingId", frame->GetRoutingID());
+    dict.Set("name", frame->GetFrameName());
+    dict.Set("url", frame->GetLastCommittedURL());
+    dict.Set("isMainFrame", frame->GetParent() == nullptr);
+    if (frame->GetParent())
+      dict.Set("parentRoutingId", frame->GetParent()->GetRoutingID());
+    frames.push_back(dict);
+  }
+  return frames;
+}
+
+void WebContents::ExecuteJavaScriptInFrame(
+    int frame_routing_id,
+    const std::vector<base::string16>& scripts,
+    bool has_user_gesture,
+    const ExecuteJavaScriptCallback& callback,
+    mate::Arguments* args) {
+  content::RenderFrameHost* target = nullptr;
+  for (content::RenderFrameHost* frame : web_contents()->GetAllFrames()) {
+    if (frame->GetRoutingID() == frame_routing_id) {
+      target = frame;
+      break;
+    }
+  }
+  if (!target || !target->IsRenderFrameLive()) {
+    args->ThrowError("No live frame has the routing id");
+    return;
+  }
+
+  int request_id = ++next_script_request_id_;
+  pending_scripts_[request_id] = {target, callback};
+  target->Send(new AtomFrameMsg_ExecuteJavaScript(
+      frame_routing_id, request_id, scripts, has_user_gesture));
+}
+
 bool WebContents::SendIPCMessage(bool all_frames,
                                  const base::string16& channel,
                                  const base::ListValue& args) {
+  // Nobody would receive the message.
+  if (!IsChannelSubscribed(channel))
+    return true;
   return Send(new AtomViewMsg_Message(routing_id(), all_frames, channel, args));
 }
 
+// static
+std::vector<int> WebContents::CreateMessagePorts(v8::Isolate* isolate,
+                                                 int32_t id1,
+                                                 int32_t id2) {
+  std::vector<int> ports;
+  auto contents1 = FromWeakMapID(isolate, id1);
+  auto contents2 = FromWeakMapID(isolate, id2);
+  if (!contents1 || !contents1->web_contents() ||
+      !contents2 || !contents2->web_contents())
+    return ports;
+
+  auto host1 = contents1->web_contents()->GetRenderViewHost();
+  auto host2 = contents2->web_contents()->GetRenderViewHost();
+  if (!host1 || !host2)
+    return ports;
+
+  int port1, port2;
+  MessagePortFilter::CreatePortPair(
+      host1->GetProcess()->GetID(), host1->GetRoutingID(),
+      host2->GetProcess()->GetID(), host2->GetRoutingID(),
+      &port1, &port2);
+  ports.push_back(port1);
+  ports.push_back(port2);
+  return ports;
+}
+
+bool WebContents::IsChannelSubscribed(const base::string16& channel) const {
+  // Until the render view reports its first listener, the messages are sent
+  // anyway, so the ones sent while the report is on its way are not lost.
+  if (!ipc_subscriptions_reported_)
+    return true;
+  return ipc_subscriptions_.find(channel) != ipc_subscriptions_.end();
+}
+
+// static
+int WebContents::BroadcastIPCMessage(v8::Isolate* isolate,
+                                     const std::vector<int32_t>& ids,
+                                     bool all_frames,
+                                     const base::string16& channel,
+                                     const base::ListValue& args) {
+  // Each target gets a copy of the pickled message, with its own routing id.
+  AtomViewMsg_Message message(MSG_ROUTING_NONE, all_frames, channel, args);
+  int sent = 0;
+  for (int32_t id : ids) {
+    auto contents = FromWeakMapID(isolate, id);
+    if (!contents || !contents->web_contents() ||
+        !contents->IsChannelSubscribed(channel))
+      continue;
+    std::unique_ptr<IPC::Message> copy(new IPC::Message(message));
+    copy->set_routing_id(contents->routing_id());
+    if (contents->Send(copy.release()))
+      ++sent;
+  }
+  return sent;
+}
+
 void WebContents::SendInputEvent(v8::Isolate* isolate,
                                  v8::Local<v8::Value> input_event) {
   const auto view = web_contents()->GetRenderWidgetHostView();
@@ -1594,6 +1780,9 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isFocused", &WebContents::IsFocused)
       .SetMethod("tabTraverse", &WebContents::TabTraverse)
       .SetMethod("_send", &WebContents::SendIPCMessage)
+      .SetMethod("getFrames", &WebContents::GetFrames)
+      .SetMethod("_executeJavaScriptInFrame",
+                 &WebContents::ExecuteJavaScriptInFrame)
       .SetMethod("sendInputEvent", &WebContents::SendInputEvent)
       .SetMethod("beginFrameSubscription",
                  &WebContents::BeginFrameSubscription)
@@ -1648,6 +1837,55 @@ void WebContents::OnRendererMessageSync(const base::string16& channel,
   EmitWithSender(base::UTF16ToUTF8(channel), web_contents(), message, args);
 }
 
+void WebContents::OnSetChannelSubscribed(const IPC::Message& message) {
+  // Ignore the messages of a render view that has been swapped out.
+  auto host = web_contents()->GetRenderViewHost();
+  if (!host || host->GetRoutingID() != message.routing_id())
+    return;
+
+  AtomViewHostMsg_SetChannelSubscribed::Param param;
+  if (!AtomViewHostMsg_SetChannelSubscribed::Read(&message, &param))
+    return;
+  const base::string16& channel = std::get<0>(param);
+  ipc_subscriptions_reported_ = true;
+  if (std::get<1>(param))
+    ipc_subscriptions_.insert(channel);
+  else
+    ipc_subscriptions_.erase(channel);
+}
+
+void WebContents::OnReportJank(const base::DictionaryValue& details) {
+  Emit("jank", details);
+}
+
+void WebContents::OnReportMemoryPurge(const base::DictionaryValue& details) {
+  Emit("memory-purged", details);
+}
+
+void WebContents::OnExecuteJavaScriptResponse(
+    content::RenderFrameHost* render_frame_host,
+    int request_id,
+    const base::ListValue& results,
+    const std::vector<std::string>& errors) {
+  auto it = pending_scripts_.find(request_id);
+  if (it == pending_scripts_.end() || it->second.frame != render_frame_host)
+    return;
+  ExecuteJavaScriptCallback callback = it->second.callback;
+  pending_scripts_.erase(it);
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  // The batch fails with the error of its first failed script.
+  v8::Local<v8::Value> error = v8::Null(isolate());
+  for (const std::string& message : errors) {
+    if (!message.empty()) {
+      error = v8::Exception::Error(mate::StringToV8(isolate(), message));
+      break;
+    }
+  }
+  callback.Run(error, mate::ConvertToV8(isolate(), results));
+}
+
 // static
 mate::Handle<WebContents> WebContents::CreateFrom(
     v8::Isolate* isolate, content::WebContents* web_contents) {
@@ -1674,6 +1912,15 @@ mate::Handle<WebContents> WebContents::Create(
   return mate::CreateHandle(isolate, new WebContents(isolate, options));
 }
 
+// static
+mate::Handle<WebContents> WebContents::CreateWithSpare(
+    v8::Isolate* isolate,
+    const mate::Dictionary& options,
+    std::unique_ptr<content::WebContents> web_contents) {
+  return mate::CreateHandle(
+      isolate, new WebContents(isolate, options, std::move(web_contents)));
+}
+
 }  // namespace api
 
 }  // namespace atom
@@ -1691,6 +1938,8 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("fromId", &mate::TrackableObject<WebContents>::FromWeakMapID);
   dict.SetMethod("getAllWebContents",
                  &mate::TrackableObject<WebContents>::GetAll);
+  dict.SetMethod("_broadcast", &WebContents::BroadcastIPCMessage);
+  dict.SetMethod("_createMessagePorts", &WebContents::CreateMessagePorts);
 }
 
 }  // namespace
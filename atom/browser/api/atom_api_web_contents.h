@@ -5,6 +5,9 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 #define ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -59,6 +62,10 @@ class WebContents : public mate::TrackableObject<WebContents>,
   using PrintToPDFCallback =
       base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>;
 
+  // For node.js callback function type: function(error, results)
+  using ExecuteJavaScriptCallback =
+      base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>;
+
   // Create from an existing WebContents.
   static mate::Handle<WebContents> CreateFrom(
       v8::Isolate* isolate, content::WebContents* web_contents);
@@ -69,6 +76,21 @@ class WebContents : public mate::TrackableObject<WebContents>,
   static mate::Handle<WebContents> Create(
       v8::Isolate* isolate, const mate::Dictionary& options);
 
+  // Create a new WebContents with a spare |web_contents| whose renderer process
+  // has been launched, its first LoadURL keeps that process.
+  static mate::Handle<WebContents> CreateWithSpare(
+      v8::Isolate* isolate,
+      const mate::Dictionary& options,
+      std::unique_ptr<content::WebContents> web_contents);
+
+  // Send the same message to all WebContents in |ids|, the arguments are only
+  // serialized once. Returns the number of WebContents the message was sent.
+  static int BroadcastIPCMessage(v8::Isolate* isolate,
+                                 const std::vector<int32_t>& ids,
+                                 bool all_frames,
+                                 const base::string16& channel,
+                                 const base::ListValue& args);
+
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
@@ -141,11 +163,31 @@ class WebContents : public mate::TrackableObject<WebContents>,
   bool IsFocused() const;
   void TabTraverse(bool reverse);
 
+  // Returns the routing ids, names and URLs of the frames in the page.
+  std::vector<mate::Dictionary> GetFrames(v8::Isolate* isolate);
+
+  // Runs |scripts| in the frame of |frame_routing_id|, |callback| is called
+  // with the results of all scripts.
+  void ExecuteJavaScriptInFrame(int frame_routing_id,
+                                const std::vector<base::string16>& scripts,
+                                bool has_user_gesture,
+                                const ExecuteJavaScriptCallback& callback,
+                                mate::Arguments* args);
+
   // Send messages to browser.
   bool SendIPCMessage(bool all_frames,
                       const base::string16& channel,
                       const base::ListValue& args);
 
+  // Connects the render views of two WebContents with a pair of message
+  // ports, returns the ids of the ports, or an empty list on failure.
+  static std::vector<int> CreateMessagePorts(v8::Isolate* isolate,
+                                             int32_t id1,
+                                             int32_t id2);
+
+  // Whether the renderer has listeners for |channel|.
+  bool IsChannelSubscribed(const base::string16& channel) const;
+
   // Send WebInputEvent to the page.
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
 
@@ -205,6 +247,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
               content::WebContents* web_contents,
               Type type);
   WebContents(v8::Isolate* isolate, const mate::Dictionary& options);
+  WebContents(v8::Isolate* isolate,
+              const mate::Dictionary& options,
+              std::unique_ptr<content::WebContents> spare);
   ~WebContents();
 
   void InitWithSessionAndOptions(v8::Isolate* isolate,
@@ -280,6 +325,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void BeforeUnloadFired(const base::TimeTicks& proceed_time) override;
   void RenderViewCreated(content::RenderViewHost*) override;
   void RenderViewDeleted(content::RenderViewHost*) override;
+  void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
+  void RenderViewHostChanged(content::RenderViewHost* old_host,
+                             content::RenderViewHost* new_host) override;
   void RenderProcessGone(base::TerminationStatus status) override;
   void DocumentLoadedInFrame(
       content::RenderFrameHost* render_frame_host) override;
@@ -300,6 +348,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void DidFinishNavigation(
       content::NavigationHandle* navigation_handle) override;
   bool OnMessageReceived(const IPC::Message& message) override;
+  bool OnMessageReceived(const IPC::Message& message,
+                         content::RenderFrameHost* render_frame_host) override;
   void WebContentsDestroyed() override;
   void NavigationEntryCommitted(
       const content::LoadCommittedDetails& load_details) override;
@@ -339,6 +389,21 @@ class WebContents : public mate::TrackableObject<WebContents>,
                              const base::ListValue& args,
                              IPC::Message* message);
 
+  // Called when the renderer's listeners of a channel change.
+  void OnSetChannelSubscribed(const IPC::Message& message);
+
+  // Called when a task of the renderer's main thread was janky.
+  void OnReportJank(const base::DictionaryValue& details);
+
+  // Called when the renderer has purged its memory.
+  void OnReportMemoryPurge(const base::DictionaryValue& details);
+
+  // Called when a frame has finished the scripts of executeJavaScriptInFrame.
+  void OnExecuteJavaScriptResponse(content::RenderFrameHost* render_frame_host,
+                                   int request_id,
+                                   const base::ListValue& results,
+                                   const std::vector<std::string>& errors);
+
   v8::Global<v8::Value> session_;
   v8::Global<v8::Value> devtools_web_contents_;
   v8::Global<v8::Value> debugger_;
@@ -357,9 +422,27 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // Whether background throttling is disabled.
   bool background_throttling_;
 
+  // The channels that have listeners in the current render view, messages of
+  // other channels are dropped instead of being sent.
+  std::set<base::string16> ipc_subscriptions_;
+
+  // Whether the current render view has reported its listeners.
+  bool ipc_subscriptions_reported_;
+
   // Whether to enable devtools.
   bool enable_devtools_;
 
+  // Whether the next LoadURL should keep the current renderer process.
+  bool reuse_renderer_process_;
+
+  // The scripts of executeJavaScriptInFrame waiting for their results.
+  struct PendingScripts {
+    content::RenderFrameHost* frame;
+    ExecuteJavaScriptCallback callback;
+  };
+  std::map<int, PendingScripts> pending_scripts_;
+  int next_script_request_id_;
+
   DISALLOW_COPY_AND_ASSIGN(WebContents);
 };
 
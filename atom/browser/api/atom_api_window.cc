@@ -7,6 +7,7 @@
 
 #include "atom/browser/api/atom_api_menu.h"
 #include "atom/browser/api/atom_api_web_contents.h"
+#include "atom/browser/api/spare_renderer_pool.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/native_window.h"
 #include "atom/common/native_mate_converters/callback.h"
@@ -98,8 +99,11 @@ Window::Window(v8::Isolate* isolate, v8::Local<v8::Object> wrapper,
       window_options.Set(options::kFrame, false);
     }
 
-    // Creates the WebContents used by BrowserWindow.
-    web_contents = WebContents::Create(isolate, web_preferences);
+    // Creates the WebContents used by BrowserWindow, a spare one of the
+    // session with the same webPreferences is taken when there is one.
+    web_contents = SpareRendererPool::Take(isolate, web_preferences);
+    if (web_contents.IsEmpty())
+      web_contents = WebContents::Create(isolate, web_preferences);
   }
 
   Init(isolate, wrapper, options, web_contents);
@@ -0,0 +1,208 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/spare_renderer_pool.h"
+
+#include <string>
+#include <utility>
+
+#include "atom/browser/api/atom_api_session.h"
+#include "atom/browser/api/atom_api_web_contents.h"
+#include "atom/browser/web_contents_preferences.h"
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/memory/ptr_util.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/values.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/web_contents.h"
+#include "native_mate/dictionary.h"
+#include "url/url_constants.h"
+
+#include "atom/common/node_includes.h"
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+// Returns the webPreferences without the keys choosing the session, which is
+// how pool profiles are compared.
+std::unique_ptr<base::DictionaryValue> GetProfile(
+    const base::DictionaryValue& web_preferences) {
+  std::unique_ptr<base::DictionaryValue> profile =
+      web_preferences.CreateDeepCopy();
+  profile->RemoveWithoutPathExpansion("session", nullptr);
+  profile->RemoveWithoutPathExpansion("partition", nullptr);
+  return profile;
+}
+
+}  // namespace
+
+SpareRendererPool::Profile::Profile() : size(0) {}
+
+SpareRendererPool::Profile::~Profile() {}
+
+SpareRendererPool::SpareRendererPool(v8::Isolate* isolate, Session* session)
+    : isolate_(isolate),
+      session_(session),
+      refill_scheduled_(false),
+      under_memory_pressure_(false),
+      memory_pressure_listener_(
+          base::Bind(&SpareRendererPool::OnMemoryPressure,
+                     base::Unretained(this))),
+      weak_factory_(this) {}
+
+SpareRendererPool::~SpareRendererPool() {
+  DestroySpares(nullptr);
+}
+
+// static
+mate::Handle<WebContents> SpareRendererPool::Take(
+    v8::Isolate* isolate, const mate::Dictionary& web_preferences) {
+  // Find the session like how the WebContents would be created.
+  std::string partition;
+  mate::Handle<Session> session;
+  if (web_preferences.Get("session", &session)) {
+  } else if (web_preferences.Get("partition", &partition)) {
+    session = Session::FromPartition(isolate, partition);
+  } else {
+    session = Session::FromPartition(isolate, "");
+  }
+  if (session.IsEmpty() || !session->spare_renderer_pool())
+    return mate::Handle<WebContents>();
+
+  base::DictionaryValue dict;
+  if (!mate::ConvertFromV8(isolate, web_preferences.GetHandle(), &dict))
+    return mate::Handle<WebContents>();
+  return session->spare_renderer_pool()->TakeSpare(web_preferences, dict);
+}
+
+void SpareRendererPool::SetSize(const base::DictionaryValue& web_preferences,
+                                size_t size) {
+  Profile* profile = FindProfile(web_preferences);
+  if (size == 0) {
+    if (!profile)
+      return;
+    DestroySpares(profile);
+    for (auto it = profiles_.begin(); it != profiles_.end(); ++it) {
+      if (it->get() == profile) {
+        profiles_.erase(it);
+        break;
+      }
+    }
+    return;
+  }
+
+  if (!profile) {
+    profile = new Profile;
+    profile->web_preferences = GetProfile(web_preferences);
+    profiles_.push_back(base::WrapUnique(profile));
+  }
+  profile->size = size;
+  while (profile->spares.size() > size)
+    profile->spares.pop_back();
+
+  under_memory_pressure_ = false;
+  ScheduleRefill();
+}
+
+SpareRendererPool::Profile* SpareRendererPool::FindProfile(
+    const base::DictionaryValue& web_preferences) {
+  std::unique_ptr<base::DictionaryValue> key = GetProfile(web_preferences);
+  for (const auto& profile : profiles_) {
+    if (profile->web_preferences->Equals(key.get()))
+      return profile.get();
+  }
+  return nullptr;
+}
+
+mate::Handle<WebContents> SpareRendererPool::TakeSpare(
+    const mate::Dictionary& options, const base::DictionaryValue& dict) {
+  Profile* profile = FindProfile(dict);
+  if (!profile)
+    return mate::Handle<WebContents>();
+
+  under_memory_pressure_ = false;
+  ScheduleRefill();
+
+  while (!profile->spares.empty()) {
+    std::unique_ptr<content::WebContents> spare =
+        std::move(profile->spares.front());
+    profile->spares.pop_front();
+    // The renderer of the spare has gone, it is no better than a new one.
+    if (spare->IsCrashed())
+      continue;
+    return WebContents::CreateWithSpare(isolate_, options, std::move(spare));
+  }
+  return mate::Handle<WebContents>();
+}
+
+void SpareRendererPool::ScheduleRefill() {
+  if (refill_scheduled_ || under_memory_pressure_)
+    return;
+  refill_scheduled_ = true;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&SpareRendererPool::Refill, weak_factory_.GetWeakPtr()));
+}
+
+void SpareRendererPool::Refill() {
+  refill_scheduled_ = false;
+  if (under_memory_pressure_)
+    return;
+
+  for (const auto& profile : profiles_) {
+    if (profile->spares.size() >= profile->size)
+      continue;
+
+    // The spare is a bare content::WebContents, so it is not seen by
+    // getAllWebContents or broadcasts until a window takes it.
+    content::WebContents::CreateParams params(session_->browser_context());
+    std::unique_ptr<content::WebContents> spare(
+        content::WebContents::Create(params));
+
+    // The preferences decide the switches of the renderer process, which is
+    // launched by loading the blank page.
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    mate::Dictionary web_preferences(
+        isolate_,
+        mate::ConvertToV8(isolate_, *profile->web_preferences)
+            ->ToObject(isolate_->GetCurrentContext())
+            .ToLocalChecked());
+    web_preferences.Set(options::kSpareRenderer, true);
+    new WebContentsPreferences(spare.get(), web_preferences);
+
+    spare->GetController().LoadURL(
+        GURL(url::kAboutBlankURL), content::Referrer(),
+        ui::PAGE_TRANSITION_AUTO_TOPLEVEL, std::string());
+    profile->spares.push_back(std::move(spare));
+
+    // Create one spare per task.
+    ScheduleRefill();
+    return;
+  }
+}
+
+void SpareRendererPool::DestroySpares(Profile* profile) {
+  for (const auto& entry : profiles_) {
+    if (!profile || entry.get() == profile)
+      entry->spares.clear();
+  }
+}
+
+void SpareRendererPool::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+  under_memory_pressure_ = true;
+  DestroySpares(nullptr);
+}
+
+}  // namespace api
+
+}  // namespace atom
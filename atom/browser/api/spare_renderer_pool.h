@@ -0,0 +1,101 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_SPARE_RENDERER_POOL_H_
+#define ATOM_BROWSER_API_SPARE_RENDERER_POOL_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "native_mate/handle.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace content {
+class WebContents;
+}
+
+namespace mate {
+class Dictionary;
+}
+
+namespace atom {
+
+namespace api {
+
+class Session;
+class WebContents;
+
+// Keeps hidden WebContents of a session whose renderer processes have already
+// been launched, so a BrowserWindow created with the same webPreferences can
+// take one instead of waiting for a new renderer process. The spares are not
+// exposed to JavaScript until they are taken.
+class SpareRendererPool {
+ public:
+  SpareRendererPool(v8::Isolate* isolate, Session* session);
+  // Destroys the spares.
+  ~SpareRendererPool();
+
+  // Takes a spare WebContents for a BrowserWindow created with
+  // |web_preferences|, returns an empty handle if there is none.
+  static mate::Handle<WebContents> Take(
+      v8::Isolate* isolate, const mate::Dictionary& web_preferences);
+
+  // Keeps |size| spare WebContents created with |web_preferences|, the
+  // "session" and "partition" keys are ignored. A |size| of 0 removes the
+  // spares of |web_preferences|.
+  void SetSize(const base::DictionaryValue& web_preferences, size_t size);
+
+ private:
+  struct Profile {
+    Profile();
+    ~Profile();
+
+    std::unique_ptr<base::DictionaryValue> web_preferences;
+    size_t size;
+    std::deque<std::unique_ptr<content::WebContents>> spares;
+  };
+
+  Profile* FindProfile(const base::DictionaryValue& web_preferences);
+  mate::Handle<WebContents> TakeSpare(const mate::Dictionary& options,
+                                      const base::DictionaryValue& dict);
+
+  // Creates the missing spares one by one in later tasks, so creating a window
+  // never waits for the pool.
+  void ScheduleRefill();
+  void Refill();
+
+  // Destroys the spares of |profile|, or all spares when it is null.
+  void DestroySpares(Profile* profile);
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  v8::Isolate* isolate_;
+  Session* session_;
+
+  std::vector<std::unique_ptr<Profile>> profiles_;
+  bool refill_scheduled_;
+
+  // Refilling stops after the spares are trimmed for memory pressure, until a
+  // window takes a spare or the pool is configured again.
+  bool under_memory_pressure_;
+
+  base::MemoryPressureListener memory_pressure_listener_;
+
+  base::WeakPtrFactory<SpareRendererPool> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpareRendererPool);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_SPARE_RENDERER_POOL_H_
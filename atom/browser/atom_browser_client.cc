@@ -15,13 +15,16 @@
 #include "atom/browser/atom_quota_permission_context.h"
 #include "atom/browser/atom_resource_dispatcher_host_delegate.h"
 #include "atom/browser/atom_speech_recognition_manager_delegate.h"
+#include "atom/browser/message_port_filter.h"
 #include "atom/browser/native_window.h"
+#include "atom/browser/preload_script_filter.h"
 #include "atom/browser/web_contents_permission_helper.h"
 #include "atom/browser/web_contents_preferences.h"
 #include "atom/browser/window_list.h"
 #include "atom/common/options_switches.h"
 #include "base/command_line.h"
 #include "base/files/file_util.h"
+#include "base/lazy_instance.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
@@ -51,6 +54,10 @@ namespace {
 // Next navigation should not restart renderer process.
 bool g_suppress_renderer_process_restart = false;
 
+// The renderer processes that should not restart for their next navigation.
+base::LazyInstance<std::set<int>> g_suppressed_restart_processes =
+    LAZY_INSTANCE_INITIALIZER;
+
 // Custom schemes to be registered to handle service worker.
 std::string g_custom_service_worker_schemes = "";
 
@@ -64,6 +71,13 @@ void AtomBrowserClient::SuppressRendererProcessRestartForOnce() {
   g_suppress_renderer_process_restart = true;
 }
 
+// static
+void AtomBrowserClient::SuppressRendererProcessRestartForOnce(
+    content::WebContents* web_contents) {
+  g_suppressed_restart_processes.Get().insert(
+      web_contents->GetRenderProcessHost()->GetID());
+}
+
 void AtomBrowserClient::SetCustomServiceWorkerSchemes(
     const std::vector<std::string>& schemes) {
   g_custom_service_worker_schemes = base::JoinString(schemes, ",");
@@ -131,9 +145,13 @@ void AtomBrowserClient::RenderProcessWillLaunch(
   host->AddFilter(new TtsMessageFilter(process_id, host->GetBrowserContext()));
   host->AddFilter(
       new WidevineCdmMessageFilter(process_id, host->GetBrowserContext()));
+  host->AddFilter(new MessagePortFilter(process_id));
 
   content::WebContents* web_contents = GetWebContentsFromProcessID(process_id);
   if (WebContentsPreferences::IsSandboxed(web_contents)) {
+    base::FilePath preload_path;
+    if (WebContentsPreferences::GetPreloadPath(web_contents, &preload_path))
+      host->AddFilter(new PreloadScriptFilter(preload_path));
     AddSandboxedRendererId(host->GetID());
     // ensure the sandboxed renderer id is removed later
     host->AddObserver(this);
@@ -181,6 +199,9 @@ void AtomBrowserClient::OverrideSiteInstanceForNavigation(
     g_suppress_renderer_process_restart = false;
     return;
   }
+  if (g_suppressed_restart_processes.Get().erase(
+          current_instance->GetProcess()->GetID()) > 0)
+    return;
 
   if (!ShouldCreateNewSiteInstance(browser_context, current_instance, url))
     return;
@@ -215,7 +236,8 @@ void AtomBrowserClient::AppendExtraCommandLineSwitches(
   static const char* const kCommonSwitchNames[] = {
     switches::kStandardSchemes,
     switches::kEnableSandbox,
-    switches::kSecureSchemes
+    switches::kSecureSchemes,
+    switches::kJankThreshold
   };
   command_line->CopySwitchesFrom(
       *base::CommandLine::ForCurrentProcess(),
@@ -41,6 +41,11 @@ class AtomBrowserClient : public brightray::BrowserClient,
   // Don't force renderer process to restart for once.
   static void SuppressRendererProcessRestartForOnce();
 
+  // Don't force the renderer process of |web_contents| to restart for its next
+  // navigation, the navigations of other WebContents are not affected.
+  static void SuppressRendererProcessRestartForOnce(
+      content::WebContents* web_contents);
+
   // Custom schemes to be registered to handle service worker.
   static void SetCustomServiceWorkerSchemes(
       const std::vector<std::string>& schemes);
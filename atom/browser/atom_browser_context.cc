@@ -4,6 +4,8 @@
 
 #include "atom/browser/atom_browser_context.h"
 
+#include <algorithm>
+
 #include "atom/browser/api/atom_api_protocol.h"
 #include "atom/browser/atom_blob_reader.h"
 #include "atom/browser/atom_browser_main_parts.h"
@@ -38,6 +40,7 @@
 #include "content/public/browser/storage_partition.h"
 #include "content/public/common/url_constants.h"
 #include "content/public/common/user_agent.h"
+#include "net/base/cache_type.h"
 #include "net/ftp/ftp_network_layer.h"
 #include "net/url_request/data_protocol_handler.h"
 #include "net/url_request/ftp_protocol_handler.h"
@@ -95,6 +98,9 @@ AtomBrowserContext::AtomBrowserContext(const std::string& partition,
   // Read options.
   use_cache_ = true;
   options.GetBoolean("cache", &use_cache_);
+  options.GetString("cacheType", &cache_type_);
+  max_cache_size_ = 0;
+  options.GetInteger("maxCacheSize", &max_cache_size_);
 
   // Initialize Pref Registry in brightray.
   InitPrefs();
@@ -168,8 +174,19 @@ AtomBrowserContext::CreateHttpCacheBackendFactory(
   base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
   if (!use_cache_ || command_line->HasSwitch(switches::kDisableHttpCache))
     return new NoCacheBackend;
-  else
+  if (cache_type_.empty() && max_cache_size_ <= 0)
     return brightray::BrowserContext::CreateHttpCacheBackendFactory(base_path);
+
+  // In-memory partitions never write the cache to disk.
+  net::CacheType type = net::DISK_CACHE;
+  if (cache_type_ == "memory" || IsOffTheRecord())
+    type = net::MEMORY_CACHE;
+  return new net::HttpCache::DefaultBackend(
+      type,
+      net::CACHE_BACKEND_DEFAULT,
+      base_path.Append(FILE_PATH_LITERAL("Cache")),
+      std::max(max_cache_size_, 0),
+      BrowserThread::GetTaskRunnerForThread(BrowserThread::CACHE));
 }
 
 content::DownloadManagerDelegate*
@@ -73,6 +73,10 @@ class AtomBrowserContext : public brightray::BrowserContext {
   std::unique_ptr<AtomCTDelegate> ct_delegate_;
   std::string user_agent_;
   bool use_cache_;
+  // "disk" or "memory", empty to use the default backend of the partition.
+  std::string cache_type_;
+  // Maximum bytes of the HTTP cache, 0 to let the backend decide.
+  int max_cache_size_;
 
   // Managed by brightray::BrowserContext.
   AtomNetworkDelegate* network_delegate_;
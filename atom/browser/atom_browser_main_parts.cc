@@ -13,6 +13,7 @@
 #include "atom/browser/javascript_environment.h"
 #include "atom/browser/node_debugger.h"
 #include "atom/common/api/atom_bindings.h"
+#include "atom/common/jank_monitor.h"
 #include "atom/common/node_bindings.h"
 #include "atom/common/node_includes.h"
 #include "base/command_line.h"
@@ -165,6 +166,11 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
       base::Bind(&v8::Isolate::LowMemoryNotification,
                  base::Unretained(js_env_->isolate())));
 
+  // Watch the UI thread when --jank-threshold is set.
+  jank_monitor_ = JankMonitor::CreateFromCommandLine(
+      js_env_->isolate(),
+      base::Bind(&Browser::ReportJank, base::Unretained(browser_.get())));
+
   brightray::BrowserMainParts::PreMainMessageLoopRun();
   bridge_task_runner_->MessageLoopIsReady();
   bridge_task_runner_ = nullptr;
@@ -196,6 +202,7 @@ void AtomBrowserMainParts::PostMainMessageLoopStart() {
 }
 
 void AtomBrowserMainParts::PostMainMessageLoopRun() {
+  jank_monitor_.reset();
   brightray::BrowserMainParts::PostMainMessageLoopRun();
 
   js_env_->OnMessageLoopDestroying();
@@ -19,6 +19,7 @@ namespace atom {
 
 class AtomBindings;
 class Browser;
+class JankMonitor;
 class JavascriptEnvironment;
 class NodeBindings;
 class NodeDebugger;
@@ -82,6 +83,7 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
   std::unique_ptr<NodeBindings> node_bindings_;
   std::unique_ptr<AtomBindings> atom_bindings_;
   std::unique_ptr<NodeDebugger> node_debugger_;
+  std::unique_ptr<JankMonitor> jank_monitor_;
 
   base::Timer gc_timer_;
 
@@ -165,6 +165,10 @@ void Browser::OnAccessibilitySupportChanged() {
                     OnAccessibilitySupportChanged());
 }
 
+void Browser::ReportJank(const base::DictionaryValue& details) {
+  FOR_EACH_OBSERVER(BrowserObserver, observers_, OnJank(details));
+}
+
 void Browser::RequestLogin(
     LoginHandler* login_handler,
     std::unique_ptr<base::DictionaryValue> request_details) {
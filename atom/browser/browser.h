@@ -191,6 +191,9 @@ class Browser : public WindowListObserver {
 
   void OnAccessibilitySupportChanged();
 
+  // A task of the UI thread ran longer than the --jank-threshold.
+  void ReportJank(const base::DictionaryValue& details);
+
   // Request basic auth login.
   void RequestLogin(LoginHandler* login_handler,
                     std::unique_ptr<base::DictionaryValue> request_details);
@@ -0,0 +1,185 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/message_port_filter.h"
+
+#include <map>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+struct PortEndpoint {
+  int process_id;
+  int routing_id;
+  int peer_port_id;
+};
+
+// The connected ports and the filters of renderer processes, only used on IO
+// thread.
+struct PortRegistry {
+  std::map<int, PortEndpoint> ports;
+  std::map<int, MessagePortFilter*> filters;
+};
+
+base::LazyInstance<PortRegistry> g_registry = LAZY_INSTANCE_INITIALIZER;
+
+// Only used on UI thread.
+int g_next_port_id = 0;
+
+bool SendToProcess(int process_id, IPC::Message* message) {
+  auto& filters = g_registry.Get().filters;
+  auto it = filters.find(process_id);
+  if (it == filters.end()) {
+    delete message;
+    return false;
+  }
+  return it->second->Send(message);
+}
+
+void RegisterPortPair(int port1, PortEndpoint endpoint1,
+                      int port2, PortEndpoint endpoint2) {
+  auto& ports = g_registry.Get().ports;
+  ports[port1] = endpoint1;
+  ports[port2] = endpoint2;
+}
+
+// Closes |port_id| and its peer, the peer's renderer is notified.
+void ClosePort(int port_id) {
+  auto& ports = g_registry.Get().ports;
+  auto it = ports.find(port_id);
+  if (it == ports.end())
+    return;
+  int peer_port_id = it->second.peer_port_id;
+  ports.erase(it);
+
+  auto peer = ports.find(peer_port_id);
+  if (peer == ports.end())
+    return;
+  PortEndpoint endpoint = peer->second;
+  ports.erase(peer);
+  SendToProcess(endpoint.process_id,
+                new AtomViewMsg_PortClosed(endpoint.routing_id, peer_port_id));
+}
+
+// Closes the ports matching |predicate| and their peers.
+template <typename Predicate>
+void ClosePortsIf(const Predicate& predicate) {
+  std::vector<int> port_ids;
+  for (const auto& port : g_registry.Get().ports) {
+    if (predicate(port.second))
+      port_ids.push_back(port.first);
+  }
+  for (int port_id : port_ids)
+    ClosePort(port_id);
+}
+
+void ClosePortsOfViewOnIO(int process_id, int routing_id) {
+  ClosePortsIf([process_id, routing_id](const PortEndpoint& endpoint) {
+    return endpoint.process_id == process_id &&
+           endpoint.routing_id == routing_id;
+  });
+}
+
+}  // namespace
+
+MessagePortFilter::MessagePortFilter(int render_process_id)
+    : content::BrowserMessageFilter(ShellMsgStart),
+      render_process_id_(render_process_id) {
+}
+
+MessagePortFilter::~MessagePortFilter() {
+}
+
+// static
+void MessagePortFilter::CreatePortPair(int process_id1, int routing_id1,
+                                       int process_id2, int routing_id2,
+                                       int* port1, int* port2) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  *port1 = ++g_next_port_id;
+  *port2 = ++g_next_port_id;
+  PortEndpoint endpoint1 = { process_id1, routing_id1, *port2 };
+  PortEndpoint endpoint2 = { process_id2, routing_id2, *port1 };
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&RegisterPortPair, *port1, endpoint1, *port2, endpoint2));
+}
+
+// static
+void MessagePortFilter::ClosePortsOfView(int process_id, int routing_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&ClosePortsOfViewOnIO, process_id, routing_id));
+}
+
+void MessagePortFilter::OnFilterAdded(IPC::Channel* channel) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  content::BrowserMessageFilter::OnFilterAdded(channel);
+  g_registry.Get().filters[render_process_id_] = this;
+}
+
+void MessagePortFilter::OnChannelClosing() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  PortRegistry& registry = g_registry.Get();
+  auto filter = registry.filters.find(render_process_id_);
+  if (filter != registry.filters.end() && filter->second == this)
+    registry.filters.erase(filter);
+
+  // Close the ports of this process.
+  int process_id = render_process_id_;
+  ClosePortsIf([process_id](const PortEndpoint& endpoint) {
+    return endpoint.process_id == process_id;
+  });
+}
+
+bool MessagePortFilter::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP_WITH_PARAM(MessagePortFilter, message,
+                                   message.routing_id())
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_PortMessage, OnPortMessage)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_ClosePort, OnClosePort)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void MessagePortFilter::OnPortMessage(int routing_id,
+                                      int port_id,
+                                      const base::ListValue& args) {
+  if (!OwnsPort(routing_id, port_id))
+    return;
+
+  auto& ports = g_registry.Get().ports;
+  int peer_port_id = ports[port_id].peer_port_id;
+  auto peer = ports.find(peer_port_id);
+  if (peer == ports.end())
+    return;
+  SendToProcess(peer->second.process_id,
+                new AtomViewMsg_PortMessage(peer->second.routing_id,
+                                            peer_port_id, args));
+}
+
+void MessagePortFilter::OnClosePort(int routing_id, int port_id) {
+  if (OwnsPort(routing_id, port_id))
+    ClosePort(port_id);
+}
+
+bool MessagePortFilter::OwnsPort(int routing_id, int port_id) const {
+  const auto& ports = g_registry.Get().ports;
+  auto it = ports.find(port_id);
+  return it != ports.end() &&
+         it->second.process_id == render_process_id_ &&
+         it->second.routing_id == routing_id;
+}
+
+}  // namespace atom
@@ -0,0 +1,57 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_MESSAGE_PORT_FILTER_H_
+#define ATOM_BROWSER_MESSAGE_PORT_FILTER_H_
+
+#include "content/public/browser/browser_message_filter.h"
+
+namespace base {
+class ListValue;
+}
+
+namespace atom {
+
+// Forwards the messages of message ports from one renderer process to
+// another on IO thread, so they never go through the UI thread or the main
+// process' JavaScript.
+class MessagePortFilter : public content::BrowserMessageFilter {
+ public:
+  explicit MessagePortFilter(int render_process_id);
+
+  // Connects a new pair of ports, one for each render view, and writes their
+  // ids to |port1| and |port2|. Must be called on UI thread.
+  static void CreatePortPair(int process_id1, int routing_id1,
+                             int process_id2, int routing_id2,
+                             int* port1, int* port2);
+
+  // Closes the ports of the render view |routing_id|, called when the view is
+  // deleted or navigates to another document. Must be called on UI thread.
+  static void ClosePortsOfView(int process_id, int routing_id);
+
+  // content::BrowserMessageFilter:
+  void OnFilterAdded(IPC::Channel* channel) override;
+  void OnChannelClosing() override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  ~MessagePortFilter() override;
+
+  void OnPortMessage(int routing_id,
+                     int port_id,
+                     const base::ListValue& args);
+  void OnClosePort(int routing_id, int port_id);
+
+  // Whether |port_id| belongs to the render view |routing_id| of this
+  // process.
+  bool OwnsPort(int routing_id, int port_id) const;
+
+  int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessagePortFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_MESSAGE_PORT_FILTER_H_
@@ -15,6 +15,7 @@
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
+#include "base/task_runner_util.h"
 #include "net/base/file_stream.h"
 #include "net/base/filename_util.h"
 #include "net/base/io_buffer.h"
@@ -31,6 +32,27 @@
 
 namespace asar {
 
+namespace {
+
+bool VerifyIntegrity(std::shared_ptr<Archive> archive,
+                     const Archive::FileInfo& file_info,
+                     uint64_t start,
+                     uint64_t length) {
+  return archive->VerifyIntegrity(file_info, start, length, nullptr);
+}
+
+int ReadCompressed(std::shared_ptr<Archive> archive,
+                   const Archive::FileInfo& file_info,
+                   uint64_t start,
+                   scoped_refptr<net::IOBuffer> buf,
+                   int length) {
+  if (!archive->Read(file_info, start, length, buf->data()))
+    return net::ERR_FAILED;
+  return length;
+}
+
+}  // namespace
+
 URLRequestAsarJob::FileMetaInfo::FileMetaInfo()
     : file_size(0),
       mime_type_result(false),
@@ -100,7 +122,10 @@ void URLRequestAsarJob::InitializeFileJob(
 }
 
 void URLRequestAsarJob::Start() {
-  if (type_ == TYPE_ASAR) {
+  if (type_ == TYPE_ASAR && file_info_.frames) {
+    // Compressed files are read through the archive.
+    DidOpen(net::OK);
+  } else if (type_ == TYPE_ASAR) {
     int flags = base::File::FLAG_OPEN |
                 base::File::FLAG_READ |
                 base::File::FLAG_ASYNC;
@@ -140,6 +165,20 @@ int URLRequestAsarJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
   if (!dest_size)
     return 0;
 
+  if (type_ == TYPE_ASAR && file_info_.frames) {
+    // Only the frames overlapping the range are inflated, and the archive
+    // keeps the recently inflated frames so the next read usually hits.
+    int64_t position = byte_range_.last_byte_position() + 1 - remaining_bytes_;
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::Bind(&ReadCompressed, archive_, file_info_, position,
+                   make_scoped_refptr(dest), dest_size),
+        base::Bind(&URLRequestAsarJob::DidRead,
+                   weak_ptr_factory_.GetWeakPtr(),
+                   make_scoped_refptr(dest)));
+    return net::ERR_IO_PENDING;
+  }
+
   int rv = stream_->Read(dest,
                          dest_size,
                          base::Bind(&URLRequestAsarJob::DidRead,
@@ -293,7 +332,37 @@ void URLRequestAsarJob::DidOpen(int result) {
                      byte_range_.first_byte_position() + 1;
   seek_offset_ = byte_range_.first_byte_position() + read_offset;
 
-  if (remaining_bytes_ > 0 && seek_offset_ != 0) {
+  // Only the blocks in the requested range are checked, compressed files are
+  // checked when their frames are read.
+  if (type_ == TYPE_ASAR && file_info_.blocks && !file_info_.frames &&
+      remaining_bytes_ > 0) {
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::Bind(&VerifyIntegrity, archive_, file_info_,
+                   byte_range_.first_byte_position(), remaining_bytes_),
+        base::Bind(&URLRequestAsarJob::DidVerifyIntegrity,
+                   weak_ptr_factory_.GetWeakPtr()));
+    return;
+  }
+
+  SeekToRange();
+}
+
+void URLRequestAsarJob::DidVerifyIntegrity(bool result) {
+  if (!result) {
+    NotifyStartError(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                           net::ERR_FAILED));
+    return;
+  }
+
+  SeekToRange();
+}
+
+void URLRequestAsarJob::SeekToRange() {
+  if (type_ == TYPE_ASAR && file_info_.frames) {
+    // There is no stream to seek for compressed files.
+    DidSeek(seek_offset_);
+  } else if (remaining_bytes_ > 0 && seek_offset_ != 0) {
     int rv = stream_->Seek(seek_offset_,
                            base::Bind(&URLRequestAsarJob::DidSeek,
                                       weak_ptr_factory_.GetWeakPtr()));
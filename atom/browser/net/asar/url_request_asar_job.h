@@ -93,6 +93,13 @@ class URLRequestAsarJob : public net::URLRequestJob {
   // Callback after opening file on a background thread.
   void DidOpen(int result);
 
+  // Callback after checking the integrity of the range to read on a
+  // background thread.
+  void DidVerifyIntegrity(bool result);
+
+  // Seeks to the beginning of |byte_range_|.
+  void SeekToRange();
+
   // Callback after seeking to the beginning of |byte_range_| in the file
   // on a background thread.
   void DidSeek(int64_t result);
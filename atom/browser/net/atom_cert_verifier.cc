@@ -4,10 +4,17 @@
 
 #include "atom/browser/net/atom_cert_verifier.h"
 
+#include <list>
+#include <tuple>
+#include <utility>
+
 #include "atom/browser/browser.h"
 #include "atom/browser/net/atom_ct_delegate.h"
 #include "atom/common/native_mate_converters/net_converter.h"
+#include "base/callback_helpers.h"
+#include "base/memory/ptr_util.h"
 #include "content/public/browser/browser_thread.h"
+#include "net/base/hash_value.h"
 #include "net/base/net_errors.h"
 #include "net/cert/cert_verify_result.h"
 #include "net/cert/crl_set.h"
@@ -19,25 +26,109 @@ namespace atom {
 
 namespace {
 
+// The maximum number of cached results.
+const size_t kMaxCachedResults = 256;
+
+class CertVerifierRequest;
+
+}  // namespace
+
+// A verification of one (hostname, certificate chain) that is waiting for the
+// verify proc, all the requests of the same key wait for the same job.
+class CertVerifierJob {
+ public:
+  CertVerifierJob() {}
+
+  ~CertVerifierJob();
+
+  void AddRequest(CertVerifierRequest* request) {
+    requests_.push_back(request);
+  }
+
+  void RemoveRequest(CertVerifierRequest* request) {
+    requests_.remove(request);
+  }
+
+  // Runs the callbacks of all requests.
+  void Complete(bool trusted);
+
+ private:
+  std::list<CertVerifierRequest*> requests_;
+
+  DISALLOW_COPY_AND_ASSIGN(CertVerifierJob);
+};
+
+namespace {
+
+class CertVerifierRequest : public net::CertVerifier::Request {
+ public:
+  CertVerifierRequest(CertVerifierJob* job,
+                      const net::CompletionCallback& callback)
+      : job_(job), callback_(callback) {
+    job_->AddRequest(this);
+  }
+
+  // Cancels the request by removing it from the job.
+  ~CertVerifierRequest() override {
+    if (job_)
+      job_->RemoveRequest(this);
+  }
+
+  void OnJobCompleted(bool trusted) {
+    job_ = nullptr;
+    // The request may be deleted by the callback.
+    base::ResetAndReturn(&callback_).Run(trusted ? net::OK : net::ERR_FAILED);
+  }
+
+  void OnJobDeleted() {
+    job_ = nullptr;
+  }
+
+ private:
+  CertVerifierJob* job_;
+  net::CompletionCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(CertVerifierRequest);
+};
+
 void OnResult(
-    net::CertVerifyResult* verify_result,
-    const net::CompletionCallback& callback,
-    bool result) {
+    const base::Callback<void(bool, int)>& callback,
+    bool result,
+    int cache_time) {
   BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
-      base::Bind(callback, result ? net::OK : net::ERR_FAILED));
+      base::Bind(callback, result, cache_time));
 }
 
 }  // namespace
 
+CertVerifierJob::~CertVerifierJob() {
+  for (CertVerifierRequest* request : requests_)
+    request->OnJobDeleted();
+}
+
+void CertVerifierJob::Complete(bool trusted) {
+  // Callbacks may delete other requests of this job, so take them one by one.
+  while (!requests_.empty()) {
+    CertVerifierRequest* request = requests_.front();
+    requests_.pop_front();
+    request->OnJobCompleted(trusted);
+  }
+}
+
 AtomCertVerifier::AtomCertVerifier(AtomCTDelegate* ct_delegate)
     : default_cert_verifier_(net::CertVerifier::CreateDefault()),
-      ct_delegate_(ct_delegate) {}
+      ct_delegate_(ct_delegate),
+      generation_(0),
+      cache_(kMaxCachedResults),
+      weak_factory_(this) {}
 
 AtomCertVerifier::~AtomCertVerifier() {}
 
 void AtomCertVerifier::SetVerifyProc(const VerifyProc& proc) {
   verify_proc_ = proc;
+  ++generation_;
+  cache_.Clear();
 }
 
 int AtomCertVerifier::Verify(
@@ -59,10 +150,30 @@ int AtomCertVerifier::Verify(
   verify_result->verified_cert = params.certificate();
   ct_delegate_->AddCTExcludedHost(params.hostname());
 
+  Key key = KeyOf(params);
+  auto cached = cache_.Get(key);
+  if (cached != cache_.end()) {
+    if (cached->second.expiration > base::TimeTicks::Now())
+      return cached->second.trusted ? net::OK : net::ERR_FAILED;
+    cache_.Erase(cached);
+  }
+
+  auto inflight = inflight_.find(key);
+  if (inflight != inflight_.end()) {
+    out_req->reset(new CertVerifierRequest(inflight->second.get(), callback));
+    return net::ERR_IO_PENDING;
+  }
+
+  CertVerifierJob* job = new CertVerifierJob;
+  inflight_[key] = base::WrapUnique(job);
+  out_req->reset(new CertVerifierRequest(job, callback));
+
+  auto on_result = base::Bind(&AtomCertVerifier::OnVerifyProcResult,
+                              weak_factory_.GetWeakPtr(), key);
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(verify_proc_, params.hostname(), params.certificate(),
-                 base::Bind(OnResult, verify_result, callback)));
+                 base::Bind(OnResult, on_result)));
   return net::ERR_IO_PENDING;
 }
 
@@ -70,4 +181,54 @@ bool AtomCertVerifier::SupportsOCSPStapling() {
   return true;
 }
 
+bool AtomCertVerifier::Key::operator<(const Key& other) const {
+  return std::tie(generation, hostname, fingerprint, flags, ocsp_response) <
+         std::tie(other.generation, other.hostname, other.fingerprint,
+                  other.flags, other.ocsp_response);
+}
+
+AtomCertVerifier::Key AtomCertVerifier::KeyOf(
+    const RequestParams& params) const {
+  const net::X509Certificate* cert = params.certificate().get();
+  net::SHA256HashValue fingerprint =
+      net::X509Certificate::CalculateChainFingerprint256(
+          cert->os_cert_handle(), cert->GetIntermediateCertificates());
+  Key key;
+  key.generation = generation_;
+  key.hostname = params.hostname();
+  key.fingerprint = std::string(reinterpret_cast<const char*>(fingerprint.data),
+                                sizeof(fingerprint.data));
+  key.flags = params.flags();
+  key.ocsp_response = params.ocsp_response();
+  return key;
+}
+
+void AtomCertVerifier::OnVerifyProcResult(const Key& key,
+                                          bool trusted,
+                                          int cache_time) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  auto inflight = inflight_.find(key);
+  if (inflight == inflight_.end())
+    return;
+
+  if (key.generation == generation_ && cache_time > 0)
+    AddToCache(key, trusted, base::TimeDelta::FromMilliseconds(cache_time));
+
+  // Remove the job before running the callbacks, which may start new
+  // verifications of the same key.
+  std::unique_ptr<CertVerifierJob> job = std::move(inflight->second);
+  inflight_.erase(inflight);
+  job->Complete(trusted);
+}
+
+void AtomCertVerifier::AddToCache(const Key& key,
+                                  bool trusted,
+                                  base::TimeDelta cache_time) {
+  CachedResult result;
+  result.trusted = trusted;
+  result.expiration = base::TimeTicks::Now() + cache_time;
+  cache_.Put(key, result);
+}
+
 }  // namespace atom
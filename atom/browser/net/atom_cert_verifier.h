@@ -5,25 +5,34 @@
 #ifndef ATOM_BROWSER_NET_ATOM_CERT_VERIFIER_H_
 #define ATOM_BROWSER_NET_ATOM_CERT_VERIFIER_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
+#include "base/containers/mru_cache.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "net/cert/cert_verifier.h"
 
 namespace atom {
 
 class AtomCTDelegate;
+class CertVerifierJob;
 
 class AtomCertVerifier : public net::CertVerifier {
  public:
   explicit AtomCertVerifier(AtomCTDelegate* ct_delegate);
   virtual ~AtomCertVerifier();
 
+  // The result callback receives whether the certificate is trusted, and for
+  // how many milliseconds the result can be reused for the same hostname and
+  // certificate chain, 0 means the result is not cached.
   using VerifyProc =
       base::Callback<void(const std::string& hostname,
                           scoped_refptr<net::X509Certificate>,
-                          const base::Callback<void(bool)>&)>;
+                          const base::Callback<void(bool, int)>&)>;
 
+  // Also drops the results cached for the previous proc.
   void SetVerifyProc(const VerifyProc& proc);
 
  protected:
@@ -37,10 +46,52 @@ class AtomCertVerifier : public net::CertVerifier {
   bool SupportsOCSPStapling() override;
 
  private:
+  // Identifies a verification. It includes the generation of |verify_proc_|,
+  // so the verifications started after the proc changes never join the jobs
+  // of the previous proc, and all the inputs of the verification besides the
+  // certificate chain, so requests only share results when they would be
+  // verified the same way. This version of RequestParams carries no SCT list,
+  // SCTs are checked by the CT verifier after the certificate is verified.
+  struct Key {
+    bool operator<(const Key& other) const;
+
+    int generation;
+    std::string hostname;
+    // SHA-256 fingerprint of the certificate chain.
+    std::string fingerprint;
+    int flags;
+    std::string ocsp_response;
+  };
+
+  struct CachedResult {
+    bool trusted;
+    base::TimeTicks expiration;
+  };
+
+  Key KeyOf(const RequestParams& params) const;
+
+  // Called in IO thread when |verify_proc_| returns the result of |key|.
+  void OnVerifyProcResult(const Key& key, bool trusted, int cache_time);
+
+  void AddToCache(const Key& key, bool trusted, base::TimeDelta cache_time);
+
   VerifyProc verify_proc_;
   std::unique_ptr<net::CertVerifier> default_cert_verifier_;
   AtomCTDelegate* ct_delegate_;
 
+  // Increased whenever |verify_proc_| changes, so results returned by an old
+  // proc are not cached and only reach the requests made before the change.
+  int generation_;
+
+  // The least recently used results are evicted when it is full.
+  base::MRUCache<Key, CachedResult> cache_;
+
+  // The verifications waiting for |verify_proc_|, concurrent requests of the
+  // same key join the same job.
+  std::map<Key, std::unique_ptr<CertVerifierJob>> inflight_;
+
+  base::WeakPtrFactory<AtomCertVerifier> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomCertVerifier);
 };
 
@@ -4,14 +4,26 @@
 
 #include "atom/browser/net/atom_cookie_delegate.h"
 
+#include "atom/browser/net/cookie_index.h"
 #include "content/public/browser/browser_thread.h"
 
 namespace atom {
 
-AtomCookieDelegate::AtomCookieDelegate() {
+AtomCookieDelegate::CookieChange::CookieChange(
+    const net::CanonicalCookie& cookie, bool removed, ChangeCause cause)
+    : cookie(cookie), removed(removed), cause(cause) {
+}
+
+AtomCookieDelegate::CookieChange::~CookieChange() {
+}
+
+AtomCookieDelegate::AtomCookieDelegate()
+    : cookie_index_(new CookieIndex) {
 }
 
 AtomCookieDelegate::~AtomCookieDelegate() {
+  content::BrowserThread::DeleteSoon(
+      content::BrowserThread::IO, FROM_HERE, cookie_index_.release());
 }
 
 void AtomCookieDelegate::AddObserver(Observer* observer) {
@@ -22,6 +34,30 @@ void AtomCookieDelegate::RemoveObserver(Observer* observer) {
   observers_.RemoveObserver(observer);
 }
 
+void AtomCookieDelegate::AddIOObserver(IOObserver* observer) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  io_observers_.AddObserver(observer);
+}
+
+void AtomCookieDelegate::RemoveIOObserver(IOObserver* observer) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  io_observers_.RemoveObserver(observer);
+}
+
+void AtomCookieDelegate::NotifyBatch(
+    const std::vector<CookieChange>& changes) {
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(&AtomCookieDelegate::NotifyObserversOfBatch,
+                 this, changes));
+}
+
+void AtomCookieDelegate::NotifyObserversOfBatch(
+    const std::vector<CookieChange>& changes) {
+  FOR_EACH_OBSERVER(Observer, observers_, OnCookiesChanged(changes));
+}
+
 void AtomCookieDelegate::NotifyObservers(
   const net::CanonicalCookie& cookie, bool removed, ChangeCause cause) {
   FOR_EACH_OBSERVER(Observer,
@@ -31,6 +67,15 @@ void AtomCookieDelegate::NotifyObservers(
 
 void AtomCookieDelegate::OnCookieChanged(
     const net::CanonicalCookie& cookie, bool removed, ChangeCause cause) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  cookie_index_->OnCookieChanged(cookie, removed);
+  base::ObserverList<IOObserver>::Iterator it(&io_observers_);
+  IOObserver* observer;
+  while ((observer = it.GetNext()) != nullptr) {
+    if (observer->OnCookieChangedOnIO(cookie, removed, cause))
+      return;
+  }
+
   content::BrowserThread::PostTask(
       content::BrowserThread::UI,
       FROM_HERE,
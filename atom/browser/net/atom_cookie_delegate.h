@@ -5,28 +5,70 @@
 #ifndef ATOM_BROWSER_NET_ATOM_COOKIE_DELEGATE_H_
 #define ATOM_BROWSER_NET_ATOM_COOKIE_DELEGATE_H_
 
+#include <memory>
+#include <vector>
+
 #include "base/observer_list.h"
 #include "net/cookies/cookie_monster.h"
 
 namespace atom {
 
+class CookieIndex;
+
 class AtomCookieDelegate : public net::CookieMonsterDelegate {
  public:
   AtomCookieDelegate();
   ~AtomCookieDelegate() override;
 
+  struct CookieChange {
+    CookieChange(const net::CanonicalCookie& cookie,
+                 bool removed,
+                 ChangeCause cause);
+    ~CookieChange();
+
+    net::CanonicalCookie cookie;
+    bool removed;
+    ChangeCause cause;
+  };
+
   class Observer {
    public:
     virtual void OnCookieChanged(const net::CanonicalCookie& cookie,
                                  bool removed,
                                  ChangeCause cause) {}
+    // Called once with the changes made by a batch of operations.
+    virtual void OnCookiesChanged(const std::vector<CookieChange>& changes) {}
    protected:
     virtual ~Observer() {}
   };
 
+  // Sees the changes in IO thread before they are notified, it is used to
+  // collect the changes made by a batch of operations.
+  class IOObserver {
+   public:
+    // Returns true when the observer takes the change, which is then left to
+    // it and not notified to the Observers on its own.
+    virtual bool OnCookieChangedOnIO(const net::CanonicalCookie& cookie,
+                                     bool removed,
+                                     ChangeCause cause) = 0;
+   protected:
+    virtual ~IOObserver() {}
+  };
+
   void AddObserver(Observer* observer);
   void RemoveObserver(Observer* observer);
 
+  // Must be called on IO thread.
+  void AddIOObserver(IOObserver* observer);
+  void RemoveIOObserver(IOObserver* observer);
+
+  // Notifies the observers of the |changes| made by a batch of operations
+  // in UI thread, can be called on any thread.
+  void NotifyBatch(const std::vector<CookieChange>& changes);
+
+  // Returns the index of cookies, must only be used on IO thread.
+  CookieIndex* cookie_index() const { return cookie_index_.get(); }
+
   // net::CookieMonsterDelegate:
   void OnCookieChanged(const net::CanonicalCookie& cookie,
                        bool removed,
@@ -36,9 +78,14 @@ class AtomCookieDelegate : public net::CookieMonsterDelegate {
  private:
   base::ObserverList<Observer> observers_;
 
+  // Lives on IO thread.
+  base::ObserverList<IOObserver> io_observers_;
+  std::unique_ptr<CookieIndex> cookie_index_;
+
   void NotifyObservers(const net::CanonicalCookie& cookie,
                        bool removed,
                        ChangeCause cause);
+  void NotifyObserversOfBatch(const std::vector<CookieChange>& changes);
 
   DISALLOW_COPY_AND_ASSIGN(AtomCookieDelegate);
 };
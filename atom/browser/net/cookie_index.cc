@@ -0,0 +1,207 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/cookie_index.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "net/cookies/cookie_store.h"
+#include "net/cookies/cookie_util.h"
+
+namespace atom {
+
+namespace {
+
+// Converts "www.example.com" or ".www.example.com" to "com.example.www".
+std::string ReverseDomain(const std::string& domain) {
+  std::vector<base::StringPiece> labels = base::SplitStringPiece(
+      domain, ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  std::string reversed;
+  reversed.reserve(domain.size());
+  for (auto it = labels.rbegin(); it != labels.rend(); ++it) {
+    if (!reversed.empty())
+      reversed.push_back('.');
+    it->AppendToString(&reversed);
+  }
+  return reversed;
+}
+
+}  // namespace
+
+CookieFilter::CookieFilter()
+    : has_name(false),
+      has_path(false),
+      has_domain(false),
+      has_secure(false),
+      secure(false),
+      has_session(false),
+      session(false) {
+}
+
+CookieFilter::~CookieFilter() {
+}
+
+void CookieFilter::Parse(const base::DictionaryValue& dict) {
+  dict.GetString("url", &url);
+  has_name = dict.GetString("name", &name);
+  has_path = dict.GetString("path", &path);
+  has_domain = dict.GetString("domain", &domain);
+  // Add a leading '.' character to the filter domain if it doesn't exist.
+  if (has_domain && net::cookie_util::DomainIsHostOnly(domain))
+    domain.insert(0, ".");
+  has_secure = dict.GetBoolean("secure", &secure);
+  has_session = dict.GetBoolean("session", &session);
+}
+
+bool CookieFilter::Matches(const net::CanonicalCookie& cookie) const {
+  if (has_name && name != cookie.Name())
+    return false;
+  if (has_path && path != cookie.Path())
+    return false;
+  if (has_domain && !CookieDomainMatches(domain, cookie.Domain()))
+    return false;
+  if (has_secure && secure != cookie.IsSecure())
+    return false;
+  if (has_session && session != !cookie.IsPersistent())
+    return false;
+  return true;
+}
+
+bool CookieDomainMatches(const std::string& filter, const std::string& domain) {
+  DCHECK(!filter.empty() && filter[0] == '.');
+  // Compare as if |domain| had a leading '.', without copying it.
+  bool host_only = net::cookie_util::DomainIsHostOnly(domain);
+  size_t length = domain.size() + (host_only ? 1 : 0);
+  if (length < filter.size())
+    return false;
+  if (length == filter.size())
+    return host_only ? filter.compare(1, std::string::npos, domain) == 0
+                     : filter == domain;
+  // |filter| starts with a '.', so a suffix match is on a label boundary.
+  return base::EndsWith(domain, filter, base::CompareCase::SENSITIVE);
+}
+
+CookieIndex::CookieIndex()
+    : state_(State::NOT_LOADED),
+      weak_factory_(this) {
+}
+
+CookieIndex::~CookieIndex() {
+}
+
+void CookieIndex::Query(net::CookieStore* cookie_store,
+                        const CookieFilter& filter,
+                        const QueryCallback& callback) {
+  if (state_ == State::LOADED) {
+    RunQuery(filter, callback);
+    return;
+  }
+
+  pending_queries_.push_back(std::make_pair(filter, callback));
+  if (state_ == State::NOT_LOADED) {
+    state_ = State::LOADING;
+    cookie_store->GetAllCookiesAsync(
+        base::Bind(&CookieIndex::OnLoaded, weak_factory_.GetWeakPtr()));
+  }
+}
+
+void CookieIndex::OnCookieChanged(const net::CanonicalCookie& cookie,
+                                  bool removed) {
+  // The cookie store serializes its tasks, so the snapshot received by
+  // OnLoaded already contains the changes made before it.
+  if (state_ != State::LOADED)
+    return;
+
+  if (removed)
+    Remove(cookie);
+  else
+    Add(cookie);
+}
+
+// static
+CookieIndex::Key CookieIndex::KeyOf(const net::CanonicalCookie& cookie) {
+  return std::make_tuple(ReverseDomain(cookie.Domain()), cookie.Domain(),
+                         cookie.Name(), cookie.Path());
+}
+
+void CookieIndex::OnLoaded(const net::CookieList& list) {
+  cookies_.clear();
+  names_.clear();
+  state_ = State::LOADED;
+  for (const auto& cookie : list)
+    Add(cookie);
+
+  std::vector<std::pair<CookieFilter, QueryCallback>> queries;
+  queries.swap(pending_queries_);
+  for (const auto& query : queries)
+    RunQuery(query.first, query.second);
+}
+
+void CookieIndex::RunQuery(const CookieFilter& filter,
+                           const QueryCallback& callback) {
+  // Expired cookies are only removed from the store when it is touched.
+  base::Time now = base::Time::Now();
+  auto matches = [&filter, now](const net::CanonicalCookie& cookie) {
+    return !cookie.IsExpired(now) && filter.Matches(cookie);
+  };
+
+  net::CookieList result;
+  if (filter.has_domain) {
+    // Walk the range of the domain and all its subdomains.
+    std::string prefix = ReverseDomain(filter.domain);
+    for (auto it = cookies_.lower_bound(Key(prefix, "", "", ""));
+         it != cookies_.end(); ++it) {
+      const std::string& reversed = std::get<0>(it->first);
+      if (!base::StartsWith(reversed, prefix, base::CompareCase::SENSITIVE))
+        break;
+      if (matches(it->second))
+        result.push_back(it->second);
+    }
+  } else if (filter.has_name) {
+    auto range = names_.equal_range(filter.name);
+    for (auto it = range.first; it != range.second; ++it) {
+      const net::CanonicalCookie& cookie = cookies_.find(it->second)->second;
+      if (matches(cookie))
+        result.push_back(cookie);
+    }
+  } else {
+    for (const auto& iter : cookies_) {
+      if (matches(iter.second))
+        result.push_back(iter.second);
+    }
+  }
+  callback.Run(result);
+}
+
+void CookieIndex::Add(const net::CanonicalCookie& cookie) {
+  Key key = KeyOf(cookie);
+  auto iter = cookies_.find(key);
+  if (iter != cookies_.end()) {
+    iter->second = cookie;
+    return;
+  }
+  cookies_.insert(std::make_pair(key, cookie));
+  names_.insert(std::make_pair(cookie.Name(), key));
+}
+
+void CookieIndex::Remove(const net::CanonicalCookie& cookie) {
+  Key key = KeyOf(cookie);
+  if (!cookies_.erase(key))
+    return;
+  auto range = names_.equal_range(cookie.Name());
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == key) {
+      names_.erase(it);
+      break;
+    }
+  }
+}
+
+}  // namespace atom
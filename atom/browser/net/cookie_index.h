@@ -0,0 +1,117 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_COOKIE_INDEX_H_
+#define ATOM_BROWSER_NET_COOKIE_INDEX_H_
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "net/cookies/canonical_cookie.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace net {
+class CookieStore;
+}
+
+namespace atom {
+
+// The filter of cookies.get, parsed once so matching a cookie does not need
+// to read the DictionaryValue or build strings.
+struct CookieFilter {
+  CookieFilter();
+  ~CookieFilter();
+
+  // Reads the fields present in |dict|.
+  void Parse(const base::DictionaryValue& dict);
+
+  bool Matches(const net::CanonicalCookie& cookie) const;
+
+  std::string url;
+  bool has_name;
+  std::string name;
+  bool has_path;
+  std::string path;
+  // Always starts with a '.'.
+  bool has_domain;
+  std::string domain;
+  bool has_secure;
+  bool secure;
+  bool has_session;
+  bool session;
+};
+
+// Returns whether the |domain| of a cookie is |filter| or a subdomain of it,
+// |filter| must start with a '.'.
+bool CookieDomainMatches(const std::string& filter, const std::string& domain);
+
+// A copy of the cookie store indexed by domain and name, used to answer
+// cookies.get queries without copying and scanning all the cookies.
+// It is created and used on IO thread only, and kept up to date by the
+// AtomCookieDelegate's change notifications.
+class CookieIndex {
+ public:
+  using QueryCallback = base::Callback<void(const net::CookieList&)>;
+
+  CookieIndex();
+  ~CookieIndex();
+
+  // Runs |callback| with the cookies matching |filter|, the index is loaded
+  // from |cookie_store| the first time it is used.
+  void Query(net::CookieStore* cookie_store,
+             const CookieFilter& filter,
+             const QueryCallback& callback);
+
+  // Updates the index, changes are ignored until the index is loaded.
+  void OnCookieChanged(const net::CanonicalCookie& cookie, bool removed);
+
+  size_t size() const { return cookies_.size(); }
+
+ private:
+  // (reversed domain, domain, name, path), which identifies a cookie, the
+  // domain is kept to tell host-only cookies from domain cookies.
+  using Key = std::tuple<std::string, std::string, std::string, std::string>;
+
+  enum class State {
+    NOT_LOADED,
+    LOADING,
+    LOADED,
+  };
+
+  static Key KeyOf(const net::CanonicalCookie& cookie);
+
+  void OnLoaded(const net::CookieList& list);
+  void RunQuery(const CookieFilter& filter, const QueryCallback& callback);
+  void Add(const net::CanonicalCookie& cookie);
+  void Remove(const net::CanonicalCookie& cookie);
+
+  State state_;
+
+  // Cookies ordered by their reversed domains, so cookies of a domain and its
+  // subdomains are stored in a contiguous range.
+  std::map<Key, net::CanonicalCookie> cookies_;
+
+  // Cookie name => keys of the cookies with that name.
+  std::multimap<std::string, Key> names_;
+
+  // Queries received while loading.
+  std::vector<std::pair<CookieFilter, QueryCallback>> pending_queries_;
+
+  base::WeakPtrFactory<CookieIndex> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieIndex);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_COOKIE_INDEX_H_
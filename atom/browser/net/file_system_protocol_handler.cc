@@ -0,0 +1,40 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/file_system_protocol_handler.h"
+
+#include "atom/browser/net/url_request_file_system_job.h"
+#include "base/task_runner.h"
+
+namespace atom {
+
+FileSystemProtocolOptions::FileSystemProtocolOptions() {}
+
+FileSystemProtocolOptions::FileSystemProtocolOptions(
+    const FileSystemProtocolOptions& other) = default;
+
+FileSystemProtocolOptions::~FileSystemProtocolOptions() {}
+
+FileSystemProtocolHandler::FileSystemProtocolHandler(
+    const FileSystemProtocolOptions& options,
+    const scoped_refptr<base::TaskRunner>& file_task_runner)
+    : options_(options),
+      file_task_runner_(file_task_runner) {}
+
+FileSystemProtocolHandler::~FileSystemProtocolHandler() {
+}
+
+net::URLRequestJob* FileSystemProtocolHandler::MaybeCreateJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate) const {
+  return new URLRequestFileSystemJob(
+      request, network_delegate, options_, file_task_runner_);
+}
+
+bool FileSystemProtocolHandler::IsSafeRedirectTarget(
+    const GURL& location) const {
+  return false;
+}
+
+}  // namespace atom
@@ -0,0 +1,58 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_FILE_SYSTEM_PROTOCOL_HANDLER_H_
+#define ATOM_BROWSER_NET_FILE_SYSTEM_PROTOCOL_HANDLER_H_
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_split.h"
+#include "net/url_request/url_request_job_factory.h"
+
+namespace base {
+class TaskRunner;
+}
+
+namespace atom {
+
+struct FileSystemProtocolOptions {
+  FileSystemProtocolOptions();
+  FileSystemProtocolOptions(const FileSystemProtocolOptions& other);
+  ~FileSystemProtocolOptions();
+
+  // The directory that the paths of URLs are resolved against, it can be in
+  // an asar archive.
+  base::FilePath root;
+  // The file under |root| served for paths that are not found, empty to fail
+  // them.
+  base::FilePath fallback;
+  // Added to every response.
+  base::StringPairs headers;
+};
+
+// Serves the files under a directory without asking JS for each request.
+class FileSystemProtocolHandler
+    : public net::URLRequestJobFactory::ProtocolHandler {
+ public:
+  FileSystemProtocolHandler(
+      const FileSystemProtocolOptions& options,
+      const scoped_refptr<base::TaskRunner>& file_task_runner);
+  ~FileSystemProtocolHandler() override;
+
+  // net::URLRequestJobFactory::ProtocolHandler:
+  net::URLRequestJob* MaybeCreateJob(
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate) const override;
+  bool IsSafeRedirectTarget(const GURL& location) const override;
+
+ private:
+  const FileSystemProtocolOptions options_;
+  const scoped_refptr<base::TaskRunner> file_task_runner_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileSystemProtocolHandler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_FILE_SYSTEM_PROTOCOL_HANDLER_H_
@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_NET_JS_ASKER_H_
 #define ATOM_BROWSER_NET_JS_ASKER_H_
 
+#include "atom/browser/net/response_cache.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
@@ -51,23 +52,40 @@ class JsAsker : public RequestJob {
   void SetHandlerInfo(
       v8::Isolate* isolate,
       net::URLRequestContextGetter* request_context_getter,
-      const JavaScriptHandler& handler) {
+      const JavaScriptHandler& handler,
+      ResponseCache* response_cache) {
     isolate_ = isolate;
     request_context_getter_ = request_context_getter;
     handler_ = handler;
+    response_cache_ = response_cache;
   }
 
   // Subclass should do initailze work here.
   virtual void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) {}
   virtual void StartAsync(std::unique_ptr<base::Value> options) = 0;
 
+  // Subclass that can serve a cached response should start with it here and
+  // return true, otherwise the handler is asked.
+  virtual bool StartFromCache(const ResponseCache::Entry& entry) {
+    return false;
+  }
+
   net::URLRequestContextGetter* request_context_getter() const {
     return request_context_getter_;
   }
 
+  // The cache of the handler's responses, null when it is not enabled.
+  ResponseCache* response_cache() const { return response_cache_.get(); }
+
  private:
   // RequestJob:
   void Start() override {
+    ResponseCache::Entry entry;
+    if (response_cache_ &&
+        response_cache_->Get(RequestJob::request(), &entry) &&
+        StartFromCache(entry))
+      return;
+
     std::unique_ptr<base::DictionaryValue> request_details(
         new base::DictionaryValue);
     FillRequestDetails(request_details.get(), RequestJob::request());
@@ -101,6 +119,7 @@ class JsAsker : public RequestJob {
   v8::Isolate* isolate_;
   net::URLRequestContextGetter* request_context_getter_;
   JavaScriptHandler handler_;
+  scoped_refptr<ResponseCache> response_cache_;
 
   base::WeakPtrFactory<JsAsker> weak_factory_;
 
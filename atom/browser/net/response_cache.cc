@@ -0,0 +1,132 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/response_cache.h"
+
+#include <utility>
+
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/http/http_response_headers.h"
+#include "net/url_request/url_request.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+size_t GetDataSize(const ResponseCache::Entry& entry) {
+  return entry.data ? entry.data->size() : 0;
+}
+
+}  // namespace
+
+ResponseCache::Entry::Entry() {}
+
+ResponseCache::Entry::Entry(const Entry& other) = default;
+
+ResponseCache::Entry::~Entry() {}
+
+ResponseCache::ResponseCache(size_t max_size,
+                             const std::vector<std::string>& vary_headers)
+    : max_size_(max_size),
+      vary_headers_(vary_headers),
+      responses_(ResponseMap::NO_AUTO_EVICT),
+      size_(0) {
+}
+
+ResponseCache::~ResponseCache() {
+}
+
+bool ResponseCache::Get(const net::URLRequest* request, Entry* entry) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (request->method() != "GET")
+    return false;
+
+  auto iter = responses_.Get(GetKey(request));
+  if (iter == responses_.end())
+    return false;
+  if (iter->second.expires <= base::TimeTicks::Now()) {
+    Erase(iter);
+    return false;
+  }
+  *entry = iter->second.entry;
+  return true;
+}
+
+void ResponseCache::Put(const net::URLRequest* request, const Entry& entry) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (request->method() != "GET" || GetDataSize(entry) > max_size_)
+    return;
+
+  scoped_refptr<net::HttpResponseHeaders> headers(
+      new net::HttpResponseHeaders("HTTP/1.1 200 OK"));
+  for (const auto& header : entry.headers)
+    headers->AddHeader(header.first + ": " + header.second);
+  base::TimeDelta max_age;
+  if (headers->HasHeaderValue("cache-control", "no-store") ||
+      headers->HasHeaderValue("cache-control", "no-cache") ||
+      !headers->GetMaxAgeValue(&max_age) ||
+      max_age <= base::TimeDelta())
+    return;
+
+  std::string key = GetKey(request);
+  auto iter = responses_.Peek(key);
+  if (iter != responses_.end())
+    Erase(iter);
+
+  CachedResponse response;
+  response.url = request->url();
+  response.entry = entry;
+  response.expires = base::TimeTicks::Now() + max_age;
+  responses_.Put(key, response);
+  size_ += GetDataSize(entry);
+
+  while (size_ > max_size_)
+    Erase(--responses_.end());
+}
+
+void ResponseCache::Invalidate(const GURL& url) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  for (auto iter = responses_.begin(); iter != responses_.end();) {
+    if (url.is_empty() || iter->second.url == url)
+      iter = Erase(iter);
+    else
+      ++iter;
+  }
+}
+
+// static
+void ResponseCache::ReadHeaders(const base::DictionaryValue& options,
+                                base::StringPairs* headers) {
+  const base::DictionaryValue* dict;
+  if (!options.GetDictionary("headers", &dict))
+    return;
+  for (base::DictionaryValue::Iterator it(*dict); !it.IsAtEnd();
+       it.Advance()) {
+    std::string value;
+    if (it.value().GetAsString(&value))
+      headers->push_back(std::make_pair(it.key(), value));
+  }
+}
+
+std::string ResponseCache::GetKey(const net::URLRequest* request) const {
+  std::string key = request->url().spec();
+  for (const std::string& name : vary_headers_) {
+    std::string value;
+    request->extra_request_headers().GetHeader(name, &value);
+    key.append("\n");
+    key.append(value);
+  }
+  return key;
+}
+
+ResponseCache::ResponseMap::iterator ResponseCache::Erase(
+    ResponseMap::iterator iter) {
+  size_ -= GetDataSize(iter->second.entry);
+  return responses_.Erase(iter);
+}
+
+}  // namespace atom
@@ -0,0 +1,91 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_RESPONSE_CACHE_H_
+#define ATOM_BROWSER_NET_RESPONSE_CACHE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_split.h"
+#include "base/time/time.h"
+#include "url/gurl.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace net {
+class URLRequest;
+}
+
+namespace atom {
+
+// Keeps the responses of a JS protocol handler in memory, so repeated requests
+// are answered on IO thread without asking the handler again. Only responses
+// with a max-age in their Cache-Control header are kept, and the least
+// recently used ones are dropped when the cache grows over its size.
+//
+// It is created on UI thread and then only used on IO thread.
+class ResponseCache : public base::RefCountedThreadSafe<ResponseCache> {
+ public:
+  struct Entry {
+    Entry();
+    Entry(const Entry& other);
+    ~Entry();
+
+    std::string mime_type;
+    std::string charset;
+    scoped_refptr<base::RefCountedMemory> data;
+    base::StringPairs headers;
+  };
+
+  // The responses are told apart by their URL and the values of
+  // |vary_headers| in the request.
+  ResponseCache(size_t max_size, const std::vector<std::string>& vary_headers);
+
+  // Gets the fresh response for |request|.
+  bool Get(const net::URLRequest* request, Entry* entry);
+
+  // Keeps |entry| as the response for |request| when its headers allow.
+  void Put(const net::URLRequest* request, const Entry& entry);
+
+  // Drops the responses of |url|, or all responses when it is empty.
+  void Invalidate(const GURL& url);
+
+  // Reads the "headers" object of the options returned by a handler.
+  static void ReadHeaders(const base::DictionaryValue& options,
+                          base::StringPairs* headers);
+
+ private:
+  friend class base::RefCountedThreadSafe<ResponseCache>;
+
+  struct CachedResponse {
+    GURL url;
+    Entry entry;
+    base::TimeTicks expires;
+  };
+  using ResponseMap = base::MRUCache<std::string, CachedResponse>;
+
+  ~ResponseCache();
+
+  std::string GetKey(const net::URLRequest* request) const;
+  ResponseMap::iterator Erase(ResponseMap::iterator iter);
+
+  const size_t max_size_;
+  const std::vector<std::string> vary_headers_;
+
+  ResponseMap responses_;
+  // Total bytes of the data in |responses_|.
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResponseCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_RESPONSE_CACHE_H_
@@ -40,6 +40,7 @@ void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
     dict->GetBinary("data", &binary);
+    ResponseCache::ReadHeaders(*dict, &headers_);
   } else if (options->IsType(base::Value::TYPE_BINARY)) {
     options->GetAsBinary(&binary);
   }
@@ -63,7 +64,27 @@ void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
       reinterpret_cast<const unsigned char*>(binary->GetBuffer()),
       binary->GetSize());
   status_code_ = net::HTTP_OK;
+
+  if (response_cache()) {
+    ResponseCache::Entry entry;
+    entry.mime_type = mime_type_;
+    entry.charset = charset_;
+    entry.data = data_;
+    entry.headers = headers_;
+    response_cache()->Put(request(), entry);
+  }
+
+  net::URLRequestSimpleJob::Start();
+}
+
+bool URLRequestBufferJob::StartFromCache(const ResponseCache::Entry& entry) {
+  mime_type_ = entry.mime_type;
+  charset_ = entry.charset;
+  data_ = entry.data;
+  headers_ = entry.headers;
+  status_code_ = net::HTTP_OK;
   net::URLRequestSimpleJob::Start();
+  return true;
 }
 
 void URLRequestBufferJob::GetResponseInfo(net::HttpResponseInfo* info) {
@@ -83,6 +104,9 @@ void URLRequestBufferJob::GetResponseInfo(net::HttpResponseInfo* info) {
     headers->AddHeader(content_type_header);
   }
 
+  for (const auto& header : headers_)
+    headers->AddHeader(header.first + ": " + header.second);
+
   info->headers = headers;
 }
 
@@ -20,6 +20,7 @@ class URLRequestBufferJob : public JsAsker<net::URLRequestSimpleJob> {
 
   // JsAsker:
   void StartAsync(std::unique_ptr<base::Value> options) override;
+  bool StartFromCache(const ResponseCache::Entry& entry) override;
 
   // URLRequestJob:
   void GetResponseInfo(net::HttpResponseInfo* info) override;
@@ -33,7 +34,8 @@ class URLRequestBufferJob : public JsAsker<net::URLRequestSimpleJob> {
  private:
   std::string mime_type_;
   std::string charset_;
-  scoped_refptr<base::RefCountedBytes> data_;
+  scoped_refptr<base::RefCountedMemory> data_;
+  base::StringPairs headers_;
   net::HttpStatusCode status_code_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestBufferJob);
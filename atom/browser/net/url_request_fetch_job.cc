@@ -6,14 +6,24 @@
 
 #include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "atom/browser/api/atom_api_session.h"
 #include "atom/browser/atom_browser_context.h"
+#include "atom/browser/atom_browser_main_parts.h"
+#include "base/lazy_instance.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/string_util.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "browser/url_request_context_getter.h"
 #include "native_mate/dictionary.h"
+#include "net/base/elements_upload_data_stream.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
+#include "net/base/upload_bytes_element_reader.h"
+#include "net/base/upload_file_element_reader.h"
+#include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 #include "net/url_request/url_fetcher.h"
 #include "net/url_request/url_fetcher_response_writer.h"
@@ -43,6 +53,79 @@ net::URLFetcher::RequestType GetRequestType(const std::string& raw) {
     return net::URLFetcher::GET;
 }
 
+// The request context shared by the fetch jobs that do not use a session. It
+// lives until the browser quits, so the jobs reuse connections, host
+// resolutions and TLS sessions.
+class SharedContextDelegate
+    : public brightray::URLRequestContextGetter::Delegate {};
+
+base::LazyInstance<SharedContextDelegate>::Leaky g_shared_context_delegate =
+    LAZY_INSTANCE_INITIALIZER;
+scoped_refptr<net::URLRequestContextGetter>* g_shared_context = nullptr;
+
+void ReleaseSharedRequestContext() {
+  delete g_shared_context;
+  g_shared_context = nullptr;
+}
+
+net::URLRequestContextGetter* GetSharedRequestContext() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!g_shared_context) {
+    // We have to create the URLRequestContextGetter on UI thread.
+    g_shared_context = new scoped_refptr<net::URLRequestContextGetter>(
+        new brightray::URLRequestContextGetter(
+            g_shared_context_delegate.Pointer(), nullptr, nullptr,
+            base::FilePath(), true,
+            BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::IO),
+            BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::FILE),
+            nullptr, content::URLRequestInterceptorScopedVector()));
+    AtomBrowserMainParts::Get()->RegisterDestructionCallback(
+        base::Bind(&ReleaseSharedRequestContext));
+  }
+  return g_shared_context->get();
+}
+
+// Whether the body of |request| is made of bytes and files only, which
+// CreateUploadStream can read again. Blobs and chunked uploads can not.
+bool CanCopyUpload(net::URLRequest* request) {
+  const net::UploadDataStream* upload = request->get_upload();
+  if (!upload || !upload->GetElementReaders())
+    return false;
+  for (const auto& reader : *upload->GetElementReaders()) {
+    if (!reader->AsBytesReader() && !reader->AsFileReader())
+      return false;
+  }
+  return true;
+}
+
+// Creates a stream that reads the body of |request| again. The bytes in memory
+// are not copied, and the files are read as they are sent.
+std::unique_ptr<net::UploadDataStream> CreateUploadStream(
+    net::URLRequest* request) {
+  std::vector<std::unique_ptr<net::UploadElementReader>> readers;
+  const net::UploadDataStream* upload = request->get_upload();
+  if (upload && upload->GetElementReaders()) {
+    for (const auto& reader : *upload->GetElementReaders()) {
+      if (const net::UploadBytesElementReader* bytes_reader =
+              reader->AsBytesReader()) {
+        readers.push_back(base::WrapUnique(new net::UploadBytesElementReader(
+            bytes_reader->bytes(), bytes_reader->length())));
+      } else if (const net::UploadFileElementReader* file_reader =
+                     reader->AsFileReader()) {
+        readers.push_back(base::WrapUnique(new net::UploadFileElementReader(
+            BrowserThread::GetBlockingPool()
+                ->GetTaskRunnerWithShutdownBehavior(
+                    base::SequencedWorkerPool::SKIP_ON_SHUTDOWN).get(),
+            file_reader->path(), file_reader->range_offset(),
+            file_reader->range_length(),
+            file_reader->expected_modification_time())));
+      }
+    }
+  }
+  return base::WrapUnique(new net::ElementsUploadDataStream(
+      std::move(readers), upload ? upload->identifier() : 0));
+}
+
 // Pipe the response writer back to URLRequestFetchJob.
 class ResponsePiper : public net::URLFetcherResponseWriter {
  public:
@@ -90,16 +173,12 @@ void URLRequestFetchJob::BeforeStartInUI(
   if (!mate::ConvertFromV8(isolate, value, &options))
     return;
 
-  // When |session| is set to |null| we use a new request context for fetch job.
+  // When |session| is set to |null| we use the request context shared by the
+  // fetch jobs without session.
   v8::Local<v8::Value> val;
   if (options.Get("session", &val)) {
     if (val->IsNull()) {
-      // We have to create the URLRequestContextGetter on UI thread.
-      url_request_context_getter_ = new brightray::URLRequestContextGetter(
-          this, nullptr, nullptr, base::FilePath(), true,
-          BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::IO),
-          BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::FILE),
-          nullptr, content::URLRequestInterceptorScopedVector());
+      url_request_context_getter_ = GetSharedRequestContext();
     } else {
       mate::Handle<api::Session> session;
       if (mate::ConvertFromV8(isolate, val, &session) && !session.IsEmpty()) {
@@ -157,12 +236,30 @@ void URLRequestFetchJob::StartAsync(std::unique_ptr<base::Value> options) {
   else
     fetcher_->SetReferrer(referrer);
 
-  // Set the data needed for POSTs.
+  // Set the data needed for POSTs, or send the body of |request| when it is
+  // not specified.
+  bool has_body = request_type == net::URLFetcher::POST ||
+                  request_type == net::URLFetcher::PUT ||
+                  request_type == net::URLFetcher::PATCH;
   if (upload_data && request_type == net::URLFetcher::POST) {
     std::string content_type, data;
     upload_data->GetString("contentType", &content_type);
     upload_data->GetString("data", &data);
     fetcher_->SetUploadData(content_type, data);
+  } else if (has_body && request()->has_upload()) {
+    // Fail rather than sending the request without the parts of its body
+    // that can not be read again.
+    if (!CanCopyUpload(request())) {
+      NotifyStartError(net::URLRequestStatus(
+          net::URLRequestStatus::FAILED, net::ERR_NOT_IMPLEMENTED));
+      return;
+    }
+    std::string content_type;
+    request()->extra_request_headers().GetHeader(
+        net::HttpRequestHeaders::kContentType, &content_type);
+    fetcher_->SetUploadStreamFactory(
+        content_type,
+        base::Bind(&CreateUploadStream, base::Unretained(request())));
   }
 
   // Use |request|'s headers.
@@ -8,14 +8,12 @@
 #include <string>
 
 #include "atom/browser/net/js_asker.h"
-#include "browser/url_request_context_getter.h"
 #include "net/url_request/url_fetcher_delegate.h"
 
 namespace atom {
 
 class URLRequestFetchJob : public JsAsker<net::URLRequestJob>,
-                           public net::URLFetcherDelegate,
-                           public brightray::URLRequestContextGetter::Delegate {
+                           public net::URLFetcherDelegate {
  public:
   URLRequestFetchJob(net::URLRequest*, net::NetworkDelegate*);
 
@@ -0,0 +1,268 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_file_system_job.h"
+
+#include <string>
+#include <vector>
+
+#include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/atom_constants.h"
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/format_macros.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_runner.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "net/base/escape.h"
+#include "net/base/mime_util.h"
+#include "net/base/net_errors.h"
+#include "net/filter/filter.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/http/http_util.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+const base::FilePath::CharType kIndexFile[] = FILE_PATH_LITERAL("index.html");
+const base::FilePath::CharType kGzipExtension[] = FILE_PATH_LITERAL(".gz");
+
+// Gets the size and the entity tag of the file at |path|, returns false when
+// it is not a file.
+bool StatFile(const base::FilePath& path,
+              bool in_archive,
+              int64_t* size,
+              std::string* etag) {
+  if (in_archive) {
+    base::FilePath asar_path, relative_path;
+    if (!asar::GetAsarArchivePath(path, &asar_path, &relative_path))
+      return false;
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(asar_path);
+    asar::Archive::FileInfo info;
+    if (!archive || !archive->GetFileInfo(relative_path, &info))
+      return false;
+    *size = info.size;
+    // The hash of the first block covers most files entirely, otherwise the
+    // position is unique while the archive is open.
+    std::string hash;
+    if (info.blocks && info.blocks->GetString(0, &hash))
+      *etag = base::StringPrintf("\"%s-%x\"", hash.substr(0, 16).c_str(),
+                                 info.size);
+    else
+      *etag = base::StringPrintf("\"%" PRIx64 "-%x\"", info.offset, info.size);
+    return true;
+  }
+
+  base::File::Info info;
+  if (!base::GetFileInfo(path, &info) || info.is_directory)
+    return false;
+  *size = info.size;
+  *etag = base::StringPrintf(
+      "\"%" PRIx64 "-%" PRIx64 "\"",
+      static_cast<uint64_t>(info.last_modified.ToInternalValue()),
+      static_cast<uint64_t>(info.size));
+  return true;
+}
+
+// Picks the first of |candidates| that is a file.
+void ResolveFile(const std::vector<base::FilePath>& candidates,
+                 bool in_archive,
+                 bool allow_gzip,
+                 URLRequestFileSystemJob::ResolvedFile* file) {
+  for (const base::FilePath& path : candidates) {
+    if (!StatFile(path, in_archive, &file->size, &file->etag))
+      continue;
+    file->found = true;
+    file->path = path;
+    file->read_path = path;
+    base::FilePath gzip_path = path.AddExtension(kGzipExtension);
+    if (allow_gzip &&
+        StatFile(gzip_path, in_archive, &file->size, &file->etag)) {
+      file->read_path = gzip_path;
+      file->gzipped = true;
+    }
+    // On Windows GetMimeTypeFromFile() goes to the registry.
+    net::GetMimeTypeFromFile(path, &file->mime_type);
+    return;
+  }
+}
+
+bool MatchesETag(const std::string& if_none_match, const std::string& etag) {
+  for (base::StringPiece tag : base::SplitStringPiece(
+           if_none_match, ",", base::TRIM_WHITESPACE,
+           base::SPLIT_WANT_NONEMPTY)) {
+    if (tag.starts_with("W/"))
+      tag.remove_prefix(2);
+    if (tag == "*" || tag == etag)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+URLRequestFileSystemJob::ResolvedFile::ResolvedFile()
+    : found(false), gzipped(false), size(0) {}
+
+URLRequestFileSystemJob::URLRequestFileSystemJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate,
+    const FileSystemProtocolOptions& options,
+    const scoped_refptr<base::TaskRunner>& file_task_runner)
+    : asar::URLRequestAsarJob(request, network_delegate),
+      options_(options),
+      file_task_runner_(file_task_runner),
+      has_range_(false),
+      not_modified_(false),
+      weak_factory_(this) {}
+
+URLRequestFileSystemJob::~URLRequestFileSystemJob() {}
+
+void URLRequestFileSystemJob::Start() {
+  // A range applies to the decompressed content, so only whole files are
+  // read from the gzipped siblings.
+  bool allow_gzip = !has_range_;
+
+  // The archives are only opened on IO thread, where their headers are kept
+  // in memory.
+  base::FilePath asar_path, relative_path;
+  bool in_archive =
+      asar::GetAsarArchivePath(options_.root, &asar_path, &relative_path);
+  scoped_refptr<base::TaskRunner> task_runner =
+      in_archive ? base::ThreadTaskRunnerHandle::Get() : file_task_runner_;
+
+  auto* file = new ResolvedFile;
+  task_runner->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&ResolveFile, GetCandidates(), in_archive, allow_gzip,
+                 base::Unretained(file)),
+      base::Bind(&URLRequestFileSystemJob::DidResolve,
+                 weak_factory_.GetWeakPtr(),
+                 base::Owned(file)));
+}
+
+void URLRequestFileSystemJob::Kill() {
+  weak_factory_.InvalidateWeakPtrs();
+  asar::URLRequestAsarJob::Kill();
+}
+
+std::unique_ptr<net::Filter> URLRequestFileSystemJob::SetupFilter() const {
+  if (file_.gzipped)
+    return net::Filter::GZipFactory();
+  return asar::URLRequestAsarJob::SetupFilter();
+}
+
+bool URLRequestFileSystemJob::GetMimeType(std::string* mime_type) const {
+  if (file_.mime_type.empty())
+    return false;
+  *mime_type = file_.mime_type;
+  return true;
+}
+
+void URLRequestFileSystemJob::SetExtraRequestHeaders(
+    const net::HttpRequestHeaders& headers) {
+  asar::URLRequestAsarJob::SetExtraRequestHeaders(headers);
+
+  headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch, &if_none_match_);
+
+  // The range is read by the base class, it is only kept here to tell the
+  // status of the response.
+  std::string range_header;
+  std::vector<net::HttpByteRange> ranges;
+  if (headers.GetHeader(net::HttpRequestHeaders::kRange, &range_header) &&
+      net::HttpUtil::ParseRangeHeader(range_header, &ranges) &&
+      ranges.size() == 1) {
+    has_range_ = true;
+    byte_range_ = ranges[0];
+  }
+}
+
+int URLRequestFileSystemJob::GetResponseCode() const {
+  if (not_modified_)
+    return 304;
+  return has_range_ ? 206 : 200;
+}
+
+void URLRequestFileSystemJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  std::string status("HTTP/1.1 200 OK");
+  if (not_modified_)
+    status = "HTTP/1.1 304 Not Modified";
+  else if (has_range_)
+    status = "HTTP/1.1 206 Partial Content";
+  auto* headers = new net::HttpResponseHeaders(status);
+
+  headers->AddHeader(kCORSHeader);
+  headers->AddHeader("Accept-Ranges: bytes");
+  headers->AddHeader("ETag: " + file_.etag);
+  if (has_range_ && !not_modified_) {
+    headers->AddHeader(base::StringPrintf(
+        "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRId64,
+        byte_range_.first_byte_position(), byte_range_.last_byte_position(),
+        file_.size));
+  }
+  for (const auto& header : options_.headers)
+    headers->AddHeader(header.first + ": " + header.second);
+  info->headers = headers;
+}
+
+std::vector<base::FilePath> URLRequestFileSystemJob::GetCandidates() const {
+  std::vector<base::FilePath> candidates;
+
+  // The host is not in the path for standard schemes, others keep it there
+  // like "file:" does.
+  std::string path = net::UnescapeURLComponent(
+      request()->url().path(),
+      net::UnescapeRule::SPACES |
+      net::UnescapeRule::URL_SPECIAL_CHARS_EXCEPT_PATH_SEPARATORS);
+  base::FilePath file_path = options_.root;
+  for (const std::string& component : base::SplitString(
+           path, "/", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    if (component == ".")
+      continue;
+    if (component == "..")
+      return candidates;
+#if defined(OS_WIN)
+    if (component.find_first_of("\\:") != std::string::npos)
+      return candidates;
+#endif
+    file_path = file_path.Append(base::FilePath::FromUTF8Unsafe(component));
+  }
+
+  candidates.push_back(file_path);
+  candidates.push_back(file_path.Append(kIndexFile));
+  if (!options_.fallback.empty())
+    candidates.push_back(options_.root.Append(options_.fallback));
+  return candidates;
+}
+
+void URLRequestFileSystemJob::DidResolve(const ResolvedFile* file) {
+  file_ = *file;
+  if (!file_.found) {
+    NotifyStartError(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                           net::ERR_FILE_NOT_FOUND));
+    return;
+  }
+
+  if (!if_none_match_.empty() && MatchesETag(if_none_match_, file_.etag)) {
+    not_modified_ = true;
+    NotifyHeadersComplete();
+    return;
+  }
+
+  // An unsatisfiable range fails the request in the base class.
+  if (has_range_)
+    has_range_ = byte_range_.ComputeBounds(file_.size);
+
+  asar::URLRequestAsarJob::Initialize(file_task_runner_, file_.read_path);
+  asar::URLRequestAsarJob::Start();
+}
+
+}  // namespace atom
@@ -0,0 +1,81 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_FILE_SYSTEM_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_FILE_SYSTEM_JOB_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "atom/browser/net/asar/url_request_asar_job.h"
+#include "atom/browser/net/file_system_protocol_handler.h"
+#include "base/memory/weak_ptr.h"
+#include "net/http/http_byte_range.h"
+
+namespace atom {
+
+// Serves the file that the path of the URL points to under the root of a
+// FileSystemProtocolHandler.
+class URLRequestFileSystemJob : public asar::URLRequestAsarJob {
+ public:
+  URLRequestFileSystemJob(
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate,
+      const FileSystemProtocolOptions& options,
+      const scoped_refptr<base::TaskRunner>& file_task_runner);
+
+  // The file picked for the request.
+  struct ResolvedFile {
+    ResolvedFile();
+
+    bool found;
+    // The file that was asked for, which decides the mime type.
+    base::FilePath path;
+    // The file to read, which is the ".gz" sibling of |path| when there is
+    // one.
+    base::FilePath read_path;
+    bool gzipped;
+    int64_t size;
+    std::string etag;
+    std::string mime_type;
+  };
+
+ protected:
+  ~URLRequestFileSystemJob() override;
+
+  // net::URLRequestJob:
+  void Start() override;
+  void Kill() override;
+  std::unique_ptr<net::Filter> SetupFilter() const override;
+  bool GetMimeType(std::string* mime_type) const override;
+  void SetExtraRequestHeaders(const net::HttpRequestHeaders& headers) override;
+  int GetResponseCode() const override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+
+ private:
+  // Returns the files that may serve the request in the order of preference,
+  // empty when the path of the URL goes out of the root.
+  std::vector<base::FilePath> GetCandidates() const;
+
+  // Callback after picking the file to serve.
+  void DidResolve(const ResolvedFile* file);
+
+  const FileSystemProtocolOptions options_;
+  const scoped_refptr<base::TaskRunner> file_task_runner_;
+
+  ResolvedFile file_;
+  std::string if_none_match_;
+  bool has_range_;
+  net::HttpByteRange byte_range_;
+  bool not_modified_;
+
+  base::WeakPtrFactory<URLRequestFileSystemJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestFileSystemJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_FILE_SYSTEM_JOB_H_
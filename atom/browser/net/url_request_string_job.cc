@@ -7,6 +7,7 @@
 #include <string>
 
 #include "atom/common/atom_constants.h"
+#include "base/memory/ref_counted_memory.h"
 #include "net/base/net_errors.h"
 
 namespace atom {
@@ -23,12 +24,33 @@ void URLRequestStringJob::StartAsync(std::unique_ptr<base::Value> options) {
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
     dict->GetString("data", &data_);
+    ResponseCache::ReadHeaders(*dict, &headers_);
   } else if (options->IsType(base::Value::TYPE_STRING)) {
     options->GetAsString(&data_);
   }
+
+  if (response_cache()) {
+    std::string data(data_);
+    ResponseCache::Entry entry;
+    entry.mime_type = mime_type_;
+    entry.charset = charset_;
+    entry.data = base::RefCountedString::TakeString(&data);
+    entry.headers = headers_;
+    response_cache()->Put(request(), entry);
+  }
+
   net::URLRequestSimpleJob::Start();
 }
 
+bool URLRequestStringJob::StartFromCache(const ResponseCache::Entry& entry) {
+  mime_type_ = entry.mime_type;
+  charset_ = entry.charset;
+  data_.assign(entry.data->front_as<char>(), entry.data->size());
+  headers_ = entry.headers;
+  net::URLRequestSimpleJob::Start();
+  return true;
+}
+
 void URLRequestStringJob::GetResponseInfo(net::HttpResponseInfo* info) {
   std::string status("HTTP/1.1 200 OK");
   auto* headers = new net::HttpResponseHeaders(status);
@@ -42,6 +64,9 @@ void URLRequestStringJob::GetResponseInfo(net::HttpResponseInfo* info) {
     headers->AddHeader(content_type_header);
   }
 
+  for (const auto& header : headers_)
+    headers->AddHeader(header.first + ": " + header.second);
+
   info->headers = headers;
 }
 
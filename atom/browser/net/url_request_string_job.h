@@ -18,6 +18,7 @@ class URLRequestStringJob : public JsAsker<net::URLRequestSimpleJob> {
 
   // JsAsker:
   void StartAsync(std::unique_ptr<base::Value> options) override;
+  bool StartFromCache(const ResponseCache::Entry& entry) override;
 
   // URLRequestJob:
   void GetResponseInfo(net::HttpResponseInfo* info) override;
@@ -32,6 +33,7 @@ class URLRequestStringJob : public JsAsker<net::URLRequestSimpleJob> {
   std::string mime_type_;
   std::string charset_;
   std::string data_;
+  base::StringPairs headers_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestStringJob);
 };
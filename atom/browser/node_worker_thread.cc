@@ -0,0 +1,318 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/node_worker_thread.h"
+
+#include <memory>
+#include <vector>
+
+#include "atom/app/uv_task_runner.h"
+#include "atom/common/api/event_emitter_caller.h"
+#include "atom/common/atom_command_line.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/node_bindings.h"
+#include "base/bind.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "content/public/browser/browser_thread.h"
+#include "gin/public/isolate_holder.h"
+#include "native_mate/dictionary.h"
+
+#include "atom/common/node_includes.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+NodeWorkerThread::NodeWorkerThread(Delegate* delegate,
+                                   const base::FilePath& script_path)
+    : delegate_(delegate),
+      script_path_(script_path),
+      running_(false),
+      isolate_(nullptr),
+      ready_(false),
+      can_terminate_(false),
+      stopping_(false),
+      exit_code_(0),
+      exit_emitted_(false),
+      env_(nullptr),
+      weak_factory_(this) {
+}
+
+NodeWorkerThread::~NodeWorkerThread() {
+  if (!running_)
+    return;
+
+  Terminate();
+  uv_thread_join(&thread_);
+}
+
+void NodeWorkerThread::Start() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  DCHECK(!running_);
+
+  // The handles are initialized before the thread starts, so they can be
+  // signalled from UI thread at any time.
+  uv_loop_init(&loop_);
+  uv_async_init(&loop_, &message_async_, OnMessageAsync);
+  message_async_.data = this;
+  uv_unref(reinterpret_cast<uv_handle_t*>(&message_async_));
+  uv_async_init(&loop_, &stop_async_, OnStopAsync);
+  stop_async_.data = this;
+  uv_unref(reinterpret_cast<uv_handle_t*>(&stop_async_));
+
+  weak_this_ = weak_factory_.GetWeakPtr();
+  running_ = true;
+  uv_thread_create(&thread_, ThreadRunner, this);
+}
+
+void NodeWorkerThread::PostMessage(const std::string& message) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!running_)
+    return;
+
+  base::AutoLock auto_lock(lock_);
+  if (stopping_)
+    return;
+  pending_messages_.push_back(message);
+  uv_async_send(&message_async_);
+}
+
+void NodeWorkerThread::Terminate() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!running_)
+    return;
+
+  base::AutoLock auto_lock(lock_);
+  if (stopping_)
+    return;
+  stopping_ = true;
+  pending_messages_.clear();
+  // Break out of any JavaScript that is currently running, the worker does it
+  // itself once node has bootstrapped.
+  if (can_terminate_)
+    isolate_->TerminateExecution();
+  uv_async_send(&stop_async_);
+}
+
+// static
+void NodeWorkerThread::ThreadRunner(void* arg) {
+  static_cast<NodeWorkerThread*>(arg)->Run();
+}
+
+void NodeWorkerThread::Run() {
+  int exit_code = 0;
+  {
+    // Feed gin::PerIsolateData with a task runner.
+    scoped_refptr<UvTaskRunner> uv_task_runner(new UvTaskRunner(&loop_));
+    base::ThreadTaskRunnerHandle handle(uv_task_runner);
+
+    gin::IsolateHolder isolate_holder;
+    v8::Isolate* isolate = isolate_holder.isolate();
+    v8::Locker locker(isolate);
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    isolate->SetMicrotasksPolicy(v8::MicrotasksPolicy::kExplicit);
+
+    {
+      base::AutoLock auto_lock(lock_);
+      isolate_ = isolate;
+    }
+
+    // Feed node the path to initialization script.
+    base::FilePath resources_path = NodeBindings::GetResourcesPath(true);
+    base::FilePath init_path =
+        resources_path.Append(FILE_PATH_LITERAL("electron.asar"))
+                      .Append(FILE_PATH_LITERAL("worker"))
+                      .Append(FILE_PATH_LITERAL("init.js"));
+    std::vector<std::string> args = {
+      AtomCommandLine::argv().empty() ? std::string()
+                                      : AtomCommandLine::argv()[0],
+      init_path.AsUTF8Unsafe(),
+      script_path_.AsUTF8Unsafe(),
+    };
+    std::unique_ptr<const char*[]> c_argv(new const char*[args.size()]);
+    for (size_t i = 0; i < args.size(); ++i)
+      c_argv[i] = args[i].c_str();
+
+    node::IsolateData isolate_data(isolate, &loop_);
+    env_ = node::CreateEnvironment(&isolate_data, context, args.size(),
+                                   c_argv.get(), 0, nullptr);
+
+    mate::Dictionary process(isolate, env_->process_object());
+    process.Set("type", "worker");
+    process.Set("resourcesPath", resources_path);
+    mate::Dictionary binding = mate::Dictionary::CreateEmpty(isolate);
+    binding.SetMethod("postMessage",
+                      base::Bind(&NodeWorkerThread::PostMessageToParent,
+                                 base::Unretained(this)));
+    binding.SetMethod("ref", base::Bind(&NodeWorkerThread::RefMessagePort,
+                                        base::Unretained(this)));
+    binding.SetMethod("unref", base::Bind(&NodeWorkerThread::UnrefMessagePort,
+                                          base::Unretained(this)));
+    binding.SetMethod("allowTermination",
+                      base::Bind(&NodeWorkerThread::AllowTermination,
+                                 base::Unretained(this)));
+    binding.SetMethod("exit", base::Bind(&NodeWorkerThread::Exit,
+                                         base::Unretained(this)));
+    binding.SetMethod("exitWithError",
+                      base::Bind(&NodeWorkerThread::ExitWithError,
+                                 base::Unretained(this)));
+    process.Set("_workerBinding", binding);
+
+    node::LoadEnvironment(env_);
+
+    {
+      base::AutoLock auto_lock(lock_);
+      ready_ = true;
+    }
+
+    // Deliver the messages posted before the script was loaded.
+    DeliverMessages();
+
+    bool more;
+    do {
+      more = uv_run(&loop_, UV_RUN_DEFAULT);
+      if (IsStopping())
+        break;
+      if (more == false) {
+        node::EmitBeforeExit(env_);
+
+        // Emit `beforeExit` if the loop became alive either after emitting
+        // event, or after running some callbacks.
+        more = uv_loop_alive(&loop_);
+        if (uv_run(&loop_, UV_RUN_NOWAIT) != 0)
+          more = true;
+      }
+    } while (more == true && !IsStopping());
+
+    // From now on nothing terminates the execution, so the exit listeners
+    // run to the end.
+    bool exit_emitted;
+    {
+      base::AutoLock auto_lock(lock_);
+      stopping_ = true;
+      can_terminate_ = false;
+      exit_emitted = exit_emitted_;
+    }
+    isolate->CancelTerminateExecution();
+    if (!exit_emitted)
+      exit_code = node::EmitExit(env_);
+    if (exit_code_ != 0)
+      exit_code = exit_code_;
+    node::RunAtExit(env_);
+
+    {
+      base::AutoLock auto_lock(lock_);
+      ready_ = false;
+      isolate_ = nullptr;
+    }
+
+    node::FreeEnvironment(env_);
+    env_ = nullptr;
+  }
+
+  uv_close(reinterpret_cast<uv_handle_t*>(&message_async_), nullptr);
+  uv_close(reinterpret_cast<uv_handle_t*>(&stop_async_), nullptr);
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  uv_loop_close(&loop_);
+
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&NodeWorkerThread::NotifyExit, weak_this_, exit_code));
+}
+
+bool NodeWorkerThread::IsStopping() {
+  base::AutoLock auto_lock(lock_);
+  return stopping_;
+}
+
+void NodeWorkerThread::DeliverMessages() {
+  std::deque<std::string> messages;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!ready_)
+      return;
+    messages.swap(pending_messages_);
+  }
+
+  v8::Isolate* isolate = env_->isolate();
+  v8::HandleScope handle_scope(isolate);
+  for (const std::string& message : messages)
+    mate::EmitEvent(isolate, env_->process_object(),
+                    "ELECTRON_WORKER_MESSAGE", message);
+}
+
+void NodeWorkerThread::PostMessageToParent(const std::string& message) {
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&NodeWorkerThread::NotifyMessage, weak_this_, message));
+}
+
+void NodeWorkerThread::RefMessagePort() {
+  uv_ref(reinterpret_cast<uv_handle_t*>(&message_async_));
+}
+
+void NodeWorkerThread::UnrefMessagePort() {
+  uv_unref(reinterpret_cast<uv_handle_t*>(&message_async_));
+}
+
+void NodeWorkerThread::AllowTermination() {
+  base::AutoLock auto_lock(lock_);
+  can_terminate_ = true;
+  // The worker was terminated while node was bootstrapping.
+  if (stopping_)
+    isolate_->TerminateExecution();
+}
+
+void NodeWorkerThread::Exit(int exit_code, bool terminate) {
+  base::AutoLock auto_lock(lock_);
+  exit_code_ = exit_code;
+  // Called by an exit listener, the loop has already ended.
+  if (stopping_)
+    return;
+  stopping_ = true;
+  uv_stop(&loop_);
+  // Do not run the rest of the script.
+  if (terminate && can_terminate_)
+    isolate_->TerminateExecution();
+}
+
+void NodeWorkerThread::ExitWithError(const std::string& error) {
+  {
+    base::AutoLock auto_lock(lock_);
+    exit_emitted_ = true;
+  }
+  Exit(1, false);
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&NodeWorkerThread::NotifyError, weak_this_, error));
+}
+
+// static
+void NodeWorkerThread::OnMessageAsync(uv_async_t* handle) {
+  static_cast<NodeWorkerThread*>(handle->data)->DeliverMessages();
+}
+
+// static
+void NodeWorkerThread::OnStopAsync(uv_async_t* handle) {
+  uv_stop(handle->loop);
+}
+
+void NodeWorkerThread::NotifyMessage(const std::string& message) {
+  delegate_->OnWorkerMessage(message);
+}
+
+void NodeWorkerThread::NotifyError(const std::string& error) {
+  delegate_->OnWorkerError(error);
+}
+
+void NodeWorkerThread::NotifyExit(int exit_code) {
+  uv_thread_join(&thread_);
+  running_ = false;
+  delegate_->OnWorkerExit(exit_code);
+}
+
+}  // namespace atom
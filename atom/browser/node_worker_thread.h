@@ -0,0 +1,119 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NODE_WORKER_THREAD_H_
+#define ATOM_BROWSER_NODE_WORKER_THREAD_H_
+
+#include <deque>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
+#include "v8/include/v8.h"
+#include "vendor/node/deps/uv/include/uv.h"
+
+namespace node {
+class Environment;
+}
+
+namespace atom {
+
+// Runs a separate node::Environment, with its own isolate and uv loop, on a
+// dedicated thread, so main process code can do heavy work without blocking
+// the UI thread. The two sides talk to each other by passing JSON strings.
+class NodeWorkerThread {
+ public:
+  class Delegate {
+   public:
+    // Called in UI thread when the worker posts a message.
+    virtual void OnWorkerMessage(const std::string& message) = 0;
+
+    // Called in UI thread when the worker has stopped because of an uncaught
+    // exception, |error| is its stack.
+    virtual void OnWorkerError(const std::string& error) = 0;
+
+    // Called in UI thread after the worker's environment has been freed.
+    virtual void OnWorkerExit(int exit_code) = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  NodeWorkerThread(Delegate* delegate, const base::FilePath& script_path);
+  ~NodeWorkerThread();
+
+  // Starts the worker thread.
+  void Start();
+
+  // Sends |message| to the worker, can be called before the worker's
+  // environment is ready, pending messages are delivered once it loads.
+  void PostMessage(const std::string& message);
+
+  // Stops the worker, running JavaScript is terminated.
+  void Terminate();
+
+  bool is_running() const { return running_; }
+
+ private:
+  static void ThreadRunner(void* arg);
+  void Run();
+
+  // Called in worker thread.
+  bool IsStopping();
+  void DeliverMessages();
+  void PostMessageToParent(const std::string& message);
+  void RefMessagePort();
+  void UnrefMessagePort();
+  void AllowTermination();
+  void Exit(int exit_code, bool terminate);
+  void ExitWithError(const std::string& error);
+  static void OnMessageAsync(uv_async_t* handle);
+  static void OnStopAsync(uv_async_t* handle);
+
+  // Called in UI thread.
+  void NotifyMessage(const std::string& message);
+  void NotifyError(const std::string& error);
+  void NotifyExit(int exit_code);
+
+  Delegate* delegate_;
+  base::FilePath script_path_;
+  bool running_;
+
+  uv_thread_t thread_;
+  uv_loop_t loop_;
+  uv_async_t message_async_;
+  uv_async_t stop_async_;
+
+  // Guards the fields below, they are shared between the UI thread and the
+  // worker thread.
+  base::Lock lock_;
+  v8::Isolate* isolate_;
+  bool ready_;
+  // Whether node has finished bootstrapping, terminating the execution before
+  // it would make node exit the whole process.
+  bool can_terminate_;
+  bool stopping_;
+  int exit_code_;
+  // Whether the exit event has been emitted by node's handler of uncaught
+  // exceptions.
+  bool exit_emitted_;
+  std::deque<std::string> pending_messages_;
+
+  // Only used in worker thread.
+  node::Environment* env_;
+
+  // Weak pointer created in UI thread, the worker thread only uses it to post
+  // tasks back to UI thread.
+  base::WeakPtr<NodeWorkerThread> weak_this_;
+
+  base::WeakPtrFactory<NodeWorkerThread> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(NodeWorkerThread);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NODE_WORKER_THREAD_H_
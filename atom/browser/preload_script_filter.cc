@@ -0,0 +1,106 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/preload_script_filter.h"
+
+#include <map>
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/asar/asar_util.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+struct CachedScript {
+  base::Time last_modified;
+  std::string source;
+};
+
+// The preload scripts read by all filters, keyed by path.
+struct ScriptCache {
+  base::Lock lock;
+  std::map<base::FilePath, CachedScript> scripts;
+};
+
+base::LazyInstance<ScriptCache> g_script_cache = LAZY_INSTANCE_INITIALIZER;
+
+// Returns the modification time of |path|, or of the asar archive containing
+// it.
+base::Time GetLastModified(const base::FilePath& path) {
+  base::File::Info info;
+  if (base::GetFileInfo(path, &info))
+    return info.last_modified;
+
+  base::FilePath asar_path, relative_path;
+  if (asar::GetAsarArchivePath(path, &asar_path, &relative_path) &&
+      base::GetFileInfo(asar_path, &info))
+    return info.last_modified;
+
+  return base::Time();
+}
+
+}  // namespace
+
+PreloadScriptFilter::PreloadScriptFilter(const base::FilePath& preload_path)
+    : content::BrowserMessageFilter(ShellMsgStart),
+      preload_path_(preload_path) {
+}
+
+PreloadScriptFilter::~PreloadScriptFilter() {
+}
+
+void PreloadScriptFilter::OverrideThreadForMessage(
+    const IPC::Message& message, BrowserThread::ID* thread) {
+  if (message.type() == AtomHostMsg_ReadPreloadScript::ID)
+    *thread = BrowserThread::FILE;
+}
+
+bool PreloadScriptFilter::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(PreloadScriptFilter, message)
+    IPC_MESSAGE_HANDLER(AtomHostMsg_ReadPreloadScript, OnReadPreloadScript)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void PreloadScriptFilter::OnReadPreloadScript(const base::FilePath& path,
+                                              bool* success,
+                                              std::string* source) {
+  *success = false;
+  if (path != preload_path_)
+    return;
+
+  base::Time last_modified = GetLastModified(path);
+  ScriptCache& cache = g_script_cache.Get();
+  {
+    base::AutoLock auto_lock(cache.lock);
+    auto it = cache.scripts.find(path);
+    if (it != cache.scripts.end() &&
+        it->second.last_modified == last_modified) {
+      *success = true;
+      *source = it->second.source;
+      return;
+    }
+  }
+
+  std::string contents;
+  if (!asar::ReadFileToString(path, &contents))
+    return;
+
+  base::AutoLock auto_lock(cache.lock);
+  CachedScript& script = cache.scripts[path];
+  script.last_modified = last_modified;
+  script.source = contents;
+  *success = true;
+  source->swap(contents);
+}
+
+}  // namespace atom
@@ -0,0 +1,44 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_PRELOAD_SCRIPT_FILTER_H_
+#define ATOM_BROWSER_PRELOAD_SCRIPT_FILTER_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "content/public/browser/browser_message_filter.h"
+
+namespace atom {
+
+// Serves the preload script of sandboxed renderers on FILE thread, so they
+// don't need to wait for the main process' JavaScript. The sources are kept in
+// memory and shared by all renderer processes. The V8 code caches are never
+// taken from renderers, a compromised renderer could otherwise pass its code
+// to the others.
+class PreloadScriptFilter : public content::BrowserMessageFilter {
+ public:
+  // Only |preload_path| can be read by the renderer.
+  explicit PreloadScriptFilter(const base::FilePath& preload_path);
+
+  // content::BrowserMessageFilter:
+  void OverrideThreadForMessage(const IPC::Message& message,
+                                content::BrowserThread::ID* thread) override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  ~PreloadScriptFilter() override;
+
+  void OnReadPreloadScript(const base::FilePath& path,
+                           bool* success,
+                           std::string* source);
+
+  base::FilePath preload_path_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreloadScriptFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_PRELOAD_SCRIPT_FILTER_H_
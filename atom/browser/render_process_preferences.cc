@@ -4,7 +4,12 @@
 
 #include "atom/browser/render_process_preferences.h"
 
+#include <string>
+#include <utility>
+
 #include "atom/common/api/api_messages.h"
+#include "base/logging.h"
+#include "base/pickle.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/notification_types.h"
 #include "content/public/browser/render_process_host.h"
@@ -14,7 +19,8 @@ namespace atom {
 RenderProcessPreferences::RenderProcessPreferences(const Predicate& predicate)
     : predicate_(predicate),
       next_id_(0),
-      cache_needs_update_(true) {
+      cache_needs_update_(true),
+      content_scripts_size_(0) {
   registrar_.Add(this,
                  content::NOTIFICATION_RENDERER_PROCESS_CREATED,
                  content::NotificationService::AllBrowserContextsAndSources());
@@ -48,16 +54,105 @@ void RenderProcessPreferences::Observe(
 
   UpdateCache();
   process->Send(new AtomMsg_UpdatePreferences(cached_entries_));
+
+  base::SharedMemoryHandle handle;
+  if (content_scripts_ &&
+      content_scripts_->ShareReadOnlyToProcess(process->GetHandle(), &handle))
+    process->Send(new AtomMsg_UpdateContentScripts(handle,
+                                                   content_scripts_size_));
 }
 
 void RenderProcessPreferences::UpdateCache() {
   if (!cache_needs_update_)
     return;
 
+  // The content scripts are pickled as:
+  //   uint32 number of entries
+  //   for each entry:
+  //     string extensionId, uint32 number of scripts
+  //     for each script:
+  //       string runAt, uint32 number of matches, string match...
+  //       uint32 number of files, (string url, string code)...
+  uint32_t entries_with_scripts = 0;
+  for (const auto& iter : entries_) {
+    const base::ListValue* scripts;
+    if (iter.second->GetList("contentScripts", &scripts))
+      ++entries_with_scripts;
+  }
+
+  base::Pickle pickle;
+  pickle.WriteUInt32(entries_with_scripts);
   cached_entries_.Clear();
-  for (const auto& iter : entries_)
-    cached_entries_.Append(iter.second->CreateDeepCopy());
+  for (const auto& iter : entries_) {
+    std::unique_ptr<base::DictionaryValue> entry =
+        iter.second->CreateDeepCopy();
+    std::unique_ptr<base::Value> value;
+    base::ListValue* scripts;
+    if (entry->Remove("contentScripts", &value) &&
+        value->GetAsList(&scripts))
+      WriteContentScripts(*entry, *scripts, &pickle);
+    cached_entries_.Append(std::move(entry));
+  }
   cache_needs_update_ = false;
+
+  content_scripts_.reset();
+  content_scripts_size_ = 0;
+  if (entries_with_scripts == 0)
+    return;
+
+  base::SharedMemoryCreateOptions options;
+  options.size = pickle.size();
+  options.share_read_only = true;
+  std::unique_ptr<base::SharedMemory> shared_memory(new base::SharedMemory);
+  if (!shared_memory->Create(options) || !shared_memory->Map(options.size)) {
+    LOG(ERROR) << "Failed to create shared memory for content scripts";
+    return;
+  }
+  memcpy(shared_memory->memory(), pickle.data(), pickle.size());
+  content_scripts_ = std::move(shared_memory);
+  content_scripts_size_ = pickle.size();
+}
+
+// static
+void RenderProcessPreferences::WriteContentScripts(
+    const base::DictionaryValue& entry,
+    const base::ListValue& scripts,
+    base::Pickle* pickle) {
+  std::string extension_id;
+  entry.GetString("extensionId", &extension_id);
+  pickle->WriteString(extension_id);
+  pickle->WriteUInt32(scripts.GetSize());
+  for (size_t i = 0; i < scripts.GetSize(); ++i) {
+    const base::DictionaryValue* script = nullptr;
+    const base::ListValue* matches = nullptr;
+    const base::ListValue* files = nullptr;
+    std::string run_at;
+    if (scripts.GetDictionary(i, &script)) {
+      script->GetString("runAt", &run_at);
+      script->GetList("matches", &matches);
+      script->GetList("js", &files);
+    }
+    pickle->WriteString(run_at);
+
+    pickle->WriteUInt32(matches ? matches->GetSize() : 0);
+    for (size_t j = 0; matches && j < matches->GetSize(); ++j) {
+      std::string match;
+      matches->GetString(j, &match);
+      pickle->WriteString(match);
+    }
+
+    pickle->WriteUInt32(files ? files->GetSize() : 0);
+    for (size_t j = 0; files && j < files->GetSize(); ++j) {
+      const base::DictionaryValue* file = nullptr;
+      std::string url, code;
+      if (files->GetDictionary(j, &file)) {
+        file->GetString("url", &url);
+        file->GetString("code", &code);
+      }
+      pickle->WriteString(url);
+      pickle->WriteString(code);
+    }
+  }
 }
 
 }  // namespace atom
@@ -9,10 +9,15 @@
 #include <unordered_map>
 
 #include "base/callback.h"
+#include "base/memory/shared_memory.h"
 #include "base/values.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
 
+namespace base {
+class Pickle;
+}
+
 namespace content {
 class RenderProcessHost;
 }
@@ -20,6 +25,10 @@ class RenderProcessHost;
 namespace atom {
 
 // Sets user preferences for render processes.
+//
+// The "contentScripts" of entries are not sent with the preferences, their
+// sources are put in read-only shared memory that is mapped by every render
+// process instead of being copied into each of them.
 class RenderProcessPreferences : public content::NotificationObserver {
  public:
   using Predicate = base::Callback<bool(content::RenderProcessHost*)>;
@@ -40,6 +49,10 @@ class RenderProcessPreferences : public content::NotificationObserver {
 
   void UpdateCache();
 
+  static void WriteContentScripts(const base::DictionaryValue& entry,
+                                  const base::ListValue& scripts,
+                                  base::Pickle* pickle);
+
   // Manages our notification registrations.
   content::NotificationRegistrar registrar_;
 
@@ -52,6 +65,8 @@ class RenderProcessPreferences : public content::NotificationObserver {
   // caches is only updated when we are sending messages.
   bool cache_needs_update_;
   base::ListValue cached_entries_;
+  std::unique_ptr<base::SharedMemory> content_scripts_;
+  uint32_t content_scripts_size_;
 
   DISALLOW_COPY_AND_ASSIGN(RenderProcessPreferences);
 };
@@ -29,6 +29,14 @@ DEFINE_WEB_CONTENTS_USER_DATA_KEY(atom::WebContentsPreferences);
 
 namespace atom {
 
+namespace {
+
+// Milliseconds a page stays hidden before its memory is purged, when
+// purgeMemoryWhenHidden is true.
+const int kDefaultPurgeMemoryDelay = 10000;
+
+}  // namespace
+
 // static
 std::vector<WebContentsPreferences*> WebContentsPreferences::instances_;
 
@@ -104,20 +112,9 @@ void WebContentsPreferences::AppendExtraCommandLineSwitches(
     command_line->AppendSwitch(switches::kEnableSandbox);
 
   // The preload script.
-  base::FilePath::StringType preload;
-  if (web_preferences.GetString(options::kPreloadScript, &preload)) {
-    if (base::FilePath(preload).IsAbsolute())
-      command_line->AppendSwitchNative(switches::kPreloadScript, preload);
-    else
-      LOG(ERROR) << "preload script must have absolute path.";
-  } else if (web_preferences.GetString(options::kPreloadURL, &preload)) {
-    // Translate to file path if there is "preload-url" option.
-    base::FilePath preload_path;
-    if (net::FileURLToFilePath(GURL(preload), &preload_path))
-      command_line->AppendSwitchPath(switches::kPreloadScript, preload_path);
-    else
-      LOG(ERROR) << "preload url must be file:// protocol.";
-  }
+  base::FilePath preload_path;
+  if (GetPreloadPath(web_contents, &preload_path))
+    command_line->AppendSwitchPath(switches::kPreloadScript, preload_path);
 
   // Run Electron APIs and preload script in isolated world
   bool isolated;
@@ -180,6 +177,45 @@ void WebContentsPreferences::AppendExtraCommandLineSwitches(
     command_line->AppendSwitchASCII(::switches::kDisableBlinkFeatures,
                                     disable_blink_features);
 
+  // The memory policies, in megabytes.
+  int memory_cache_capacity;
+  if (web_preferences.GetInteger(options::kMemoryCacheCapacity,
+                                 &memory_cache_capacity) &&
+      memory_cache_capacity > 0)
+    command_line->AppendSwitchASCII(switches::kMemoryCacheCapacity,
+                                    base::IntToString(memory_cache_capacity));
+  int v8_heap_soft_limit;
+  if (web_preferences.GetInteger(options::kV8HeapSoftLimit,
+                                 &v8_heap_soft_limit) &&
+      v8_heap_soft_limit > 0)
+    command_line->AppendSwitchASCII(switches::kV8HeapSoftLimit,
+                                    base::IntToString(v8_heap_soft_limit));
+
+  // Purge the memory of hidden pages, either after the given milliseconds or
+  // after the default delay.
+  bool purge_when_hidden;
+  int purge_delay = 0;
+  if (web_preferences.GetBoolean(options::kPurgeMemoryWhenHidden,
+                                 &purge_when_hidden))
+    purge_delay = purge_when_hidden ? kDefaultPurgeMemoryDelay : 0;
+  else
+    web_preferences.GetInteger(options::kPurgeMemoryWhenHidden, &purge_delay);
+  if (purge_delay > 0)
+    command_line->AppendSwitchASCII(switches::kPurgeMemoryWhenHidden,
+                                    base::IntToString(purge_delay));
+
+  // Spare renderers do not set up node or the preload script for their blank
+  // page.
+  if (web_preferences.GetBoolean(options::kSpareRenderer, &b) && b)
+    command_line->AppendSwitch(switches::kSpareRenderer);
+
+  // Overrides the --jank-threshold copied from the browser, 0 disables it.
+  int jank_threshold;
+  if (web_preferences.GetInteger(options::kJankThreshold, &jank_threshold) &&
+      jank_threshold >= 0)
+    command_line->AppendSwitchASCII(switches::kJankThreshold,
+                                    base::IntToString(jank_threshold));
+
   // The initial visibility state.
   NativeWindow* window = NativeWindow::FromWebContents(web_contents);
 
@@ -215,6 +251,33 @@ bool WebContentsPreferences::IsSandboxed(content::WebContents* web_contents) {
   return sandboxed;
 }
 
+// static
+bool WebContentsPreferences::GetPreloadPath(
+    content::WebContents* web_contents, base::FilePath* path) {
+  if (!web_contents)
+    return false;
+
+  WebContentsPreferences* self = FromWebContents(web_contents);
+  if (!self)
+    return false;
+
+  base::DictionaryValue& web_preferences = self->web_preferences_;
+  base::FilePath::StringType preload;
+  if (web_preferences.GetString(options::kPreloadScript, &preload)) {
+    if (base::FilePath(preload).IsAbsolute()) {
+      *path = base::FilePath(preload);
+      return true;
+    }
+    LOG(ERROR) << "preload script must have absolute path.";
+  } else if (web_preferences.GetString(options::kPreloadURL, &preload)) {
+    // Translate to file path if there is "preload-url" option.
+    if (net::FileURLToFilePath(GURL(preload), path))
+      return true;
+    LOG(ERROR) << "preload url must be file:// protocol.";
+  }
+  return false;
+}
+
 // static
 void WebContentsPreferences::OverrideWebkitPrefs(
     content::WebContents* web_contents, content::WebPreferences* prefs) {
@@ -12,6 +12,7 @@
 
 namespace base {
 class CommandLine;
+class FilePath;
 }
 
 namespace content {
@@ -38,6 +39,10 @@ class WebContentsPreferences
 
   static bool IsSandboxed(content::WebContents* web_contents);
 
+  // Gets the absolute path of the preload script of |web_contents|.
+  static bool GetPreloadPath(content::WebContents* web_contents,
+                             base::FilePath* path);
+
   // Modify the WebPreferences according to |web_contents|'s preferences.
   static void OverrideWebkitPrefs(
       content::WebContents* web_contents, content::WebPreferences* prefs);
@@ -5,6 +5,8 @@
 // Multiply-included file, no traditional include guard.
 
 #include "atom/common/draggable_region.h"
+#include "base/files/file_path.h"
+#include "base/memory/shared_memory.h"
 #include "base/strings/string16.h"
 #include "base/values.h"
 #include "content/public/common/common_param_traits.h"
@@ -35,9 +37,73 @@ IPC_MESSAGE_ROUTED3(AtomViewMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
 
+// Sent by the renderer when a channel gets its first listener or loses its
+// last listener in the render view.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_SetChannelSubscribed,
+                    base::string16 /* channel */,
+                    bool /* subscribed */)
+
+// Sent by the renderer to post a message to the peer of a message port.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_PortMessage,
+                    int /* port_id */,
+                    base::ListValue /* arguments */)
+
+// Sent by the renderer to close a message port and its peer.
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_ClosePort,
+                    int /* port_id */)
+
+// Delivers a message posted by the peer of a message port.
+IPC_MESSAGE_ROUTED2(AtomViewMsg_PortMessage,
+                    int /* port_id */,
+                    base::ListValue /* arguments */)
+
+// Sent when the peer of a message port has been closed.
+IPC_MESSAGE_ROUTED1(AtomViewMsg_PortClosed,
+                    int /* port_id */)
+
+// Sent when a window takes the spare view, the pages it loads afterwards are
+// no longer the spare's blank page.
+IPC_MESSAGE_ROUTED0(AtomViewMsg_ClaimSpare)
+
+// Runs a batch of scripts in the main world of a frame.
+IPC_MESSAGE_ROUTED3(AtomFrameMsg_ExecuteJavaScript,
+                    int /* request_id */,
+                    std::vector<base::string16> /* scripts */,
+                    bool /* has_user_gesture */)
+
+// Sent by the frame once all the scripts of a batch have finished, the
+// promises among their results are waited for. An error is empty when its
+// script succeeded.
+IPC_MESSAGE_ROUTED3(AtomFrameHostMsg_ExecuteJavaScriptResponse,
+                    int /* request_id */,
+                    base::ListValue /* results */,
+                    std::vector<std::string> /* errors */)
+
 // Sent by the renderer when the draggable regions are updated.
 IPC_MESSAGE_ROUTED1(AtomViewHostMsg_UpdateDraggableRegions,
                     std::vector<atom::DraggableRegion> /* regions */)
 
+// Sent by the renderer when a task of its main thread ran longer than the
+// --jank-threshold.
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_ReportJank,
+                    base::DictionaryValue /* details */)
+
+// Sent by the renderer after purging its memory for the memory policies of
+// its webPreferences.
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_ReportMemoryPurge,
+                    base::DictionaryValue /* details */)
+
+// Reads the preload script of a sandboxed renderer.
+IPC_SYNC_MESSAGE_CONTROL1_2(AtomHostMsg_ReadPreloadScript,
+                            base::FilePath /* path */,
+                            bool /* success */,
+                            std::string /* source */)
+
 // Update renderer process preferences.
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdatePreferences, base::ListValue)
+
+// Update the content scripts of extensions, which are pickled into read-only
+// shared memory, see RenderProcessPreferences::UpdateCache for the format.
+IPC_MESSAGE_CONTROL2(AtomMsg_UpdateContentScripts,
+                     base::SharedMemoryHandle /* shared_memory */,
+                     uint32_t /* size */)
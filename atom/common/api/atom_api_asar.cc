@@ -4,14 +4,20 @@
 
 #include <stddef.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "atom_natives.h"  // NOLINT: This file is generated with coffee2c.
 
+#include "atom/common/api/locker.h"
 #include "atom/common/asar/archive.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
+#include "base/bind.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
 #include "native_mate/arguments.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
@@ -19,14 +25,39 @@
 
 namespace {
 
+using ReadFileCallback = base::Callback<void(v8::Local<v8::Value>)>;
+
+// Reads and inflates a file in a worker thread, |archive| is kept alive until
+// the read is done even if the Archive wrapper is destroyed.
+bool ReadFileInWorker(std::shared_ptr<asar::Archive> archive,
+                      const asar::Archive::FileInfo& info,
+                      std::string* data) {
+  data->resize(info.size);
+  return archive->Read(info, 0, info.size, &(*data)[0]);
+}
+
+void OnReadFile(v8::Isolate* isolate,
+                const ReadFileCallback& callback,
+                std::string* data,
+                bool success) {
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Object> buffer;
+  if (success &&
+      node::Buffer::Copy(isolate, data->data(), data->size()).ToLocal(&buffer))
+    callback.Run(buffer);
+  else
+    callback.Run(v8::False(isolate));
+}
+
 class Archive : public mate::Wrappable<Archive> {
  public:
   static v8::Local<v8::Value> Create(v8::Isolate* isolate,
                                       const base::FilePath& path) {
-    std::unique_ptr<asar::Archive> archive(new asar::Archive(path));
+    std::shared_ptr<asar::Archive> archive(new asar::Archive(path));
     if (!archive->Init())
       return v8::False(isolate);
-    return (new Archive(isolate, std::move(archive)))->GetWrapper();
+    return (new Archive(isolate, archive))->GetWrapper();
   }
 
   static void BuildPrototype(
@@ -39,13 +70,16 @@ class Archive : public mate::Wrappable<Archive> {
         .SetMethod("readdir", &Archive::Readdir)
         .SetMethod("realpath", &Archive::Realpath)
         .SetMethod("copyFileOut", &Archive::CopyFileOut)
+        .SetMethod("verifyIntegrity", &Archive::VerifyIntegrity)
+        .SetMethod("readFile", &Archive::ReadFile)
+        .SetMethod("readFileAsync", &Archive::ReadFileAsync)
         .SetMethod("getFd", &Archive::GetFD)
         .SetMethod("destroy", &Archive::Destroy);
   }
 
  protected:
-  Archive(v8::Isolate* isolate, std::unique_ptr<asar::Archive> archive)
-      : archive_(std::move(archive)) {
+  Archive(v8::Isolate* isolate, std::shared_ptr<asar::Archive> archive)
+      : archive_(archive) {
     Init(isolate);
   }
 
@@ -64,6 +98,8 @@ class Archive : public mate::Wrappable<Archive> {
     dict.Set("size", info.size);
     dict.Set("unpacked", info.unpacked);
     dict.Set("offset", info.offset);
+    dict.Set("integrity", info.blocks != nullptr);
+    dict.Set("compressed", info.frames != nullptr);
     return dict.GetHandle();
   }
 
@@ -109,6 +145,48 @@ class Archive : public mate::Wrappable<Archive> {
     return mate::ConvertToV8(isolate, new_path);
   }
 
+  // Checks the integrity of the whole file, whose content has been read into
+  // |buffer|.
+  bool VerifyIntegrity(const base::FilePath& path,
+                       v8::Local<v8::Value> buffer) {
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) ||
+        !node::Buffer::HasInstance(buffer) ||
+        node::Buffer::Length(buffer) != info.size)
+      return false;
+    return archive_->VerifyIntegrity(info, 0, info.size,
+                                     node::Buffer::Data(buffer));
+  }
+
+  // Reads the whole file into a Buffer, compressed files are inflated.
+  v8::Local<v8::Value> ReadFile(v8::Isolate* isolate,
+                                 const base::FilePath& path) {
+    asar::Archive::FileInfo info;
+    v8::Local<v8::Object> buffer;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) ||
+        !node::Buffer::New(isolate, info.size).ToLocal(&buffer) ||
+        !archive_->Read(info, 0, info.size, node::Buffer::Data(buffer)))
+      return v8::False(isolate);
+    return buffer;
+  }
+
+  // Reads the whole file like ReadFile, but inflates it in a worker thread
+  // and passes the Buffer, or false when failed, to |callback|.
+  void ReadFileAsync(v8::Isolate* isolate,
+                     const base::FilePath& path,
+                     const ReadFileCallback& callback) {
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info)) {
+      callback.Run(v8::False(isolate));
+      return;
+    }
+    std::string* data = new std::string;
+    base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+        base::Bind(&ReadFileInWorker, archive_, info, base::Unretained(data)),
+        base::Bind(&OnReadFile, isolate, callback, base::Owned(data)));
+  }
+
   // Return the file descriptor.
   int GetFD() const {
     if (!archive_)
@@ -122,7 +200,7 @@ class Archive : public mate::Wrappable<Archive> {
   }
 
  private:
-  std::unique_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
@@ -0,0 +1,154 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "base/json/json_writer.h"
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+#include "native_mate/arguments.h"
+#include "native_mate/dictionary.h"
+
+#include "atom/common/node_includes.h"
+
+using base::trace_event::TraceLog;
+
+namespace {
+
+// The arguments of an event are recorded as a single "data" argument.
+const char kDataArgName[] = "data";
+
+// Writes the arguments passed from JavaScript as JSON into the trace.
+class JSONTraceValue : public base::trace_event::ConvertableToTraceFormat {
+ public:
+  explicit JSONTraceValue(const base::DictionaryValue& value)
+      : value_(value.DeepCopy()) {}
+
+  void AppendAsTraceFormat(std::string* out) const override {
+    std::string json;
+    base::JSONWriter::Write(*value_, &json);
+    out->append(json);
+  }
+
+ private:
+  std::unique_ptr<base::DictionaryValue> value_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONTraceValue);
+};
+
+// Returns the enabled flag of |category| as a buffer, so JavaScript can check
+// whether the category is recorded without calling into native code. The flag
+// lives as long as the process and is updated when tracing starts or stops.
+//
+// Every category takes an entry of the fixed size table of TraceLog, which is
+// shared with Chromium's own categories, so trace-events.js limits how many
+// categories are registered.
+v8::Local<v8::ArrayBuffer> GetCategoryEnabledFlag(v8::Isolate* isolate,
+                                                  const std::string& category) {
+  const unsigned char* flag =
+      TraceLog::GetCategoryGroupEnabled(category.c_str());
+  return v8::ArrayBuffer::New(isolate, const_cast<unsigned char*>(flag), 1);
+}
+
+// Adds an event of |phase|, the names are copied since they do not outlive
+// the call.
+void AddTraceEvent(mate::Arguments* args) {
+  std::string phase, category, name;
+  if (!args->GetNext(&phase) || phase.size() != 1 ||
+      !args->GetNext(&category) || !args->GetNext(&name)) {
+    args->ThrowError();
+    return;
+  }
+  const unsigned char* category_enabled =
+      TraceLog::GetCategoryGroupEnabled(category.c_str());
+  if (!*category_enabled)
+    return;
+
+  double id = 0;
+  args->GetNext(&id);
+  unsigned int flags = TRACE_EVENT_FLAG_COPY;
+  // The async spans are matched by their ids, including 0.
+  if (phase[0] == TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN ||
+      phase[0] == TRACE_EVENT_PHASE_NESTABLE_ASYNC_END)
+    flags |= TRACE_EVENT_FLAG_HAS_ID;
+  if (phase[0] == TRACE_EVENT_PHASE_INSTANT)
+    flags |= TRACE_EVENT_SCOPE_THREAD;
+
+  int num_args = 0;
+  const char* arg_names[1] = { kDataArgName };
+  unsigned char arg_types[1] = { TRACE_VALUE_TYPE_CONVERTABLE };
+  unsigned long long arg_values[1] = { 0 };  // NOLINT(runtime/int)
+  std::unique_ptr<base::trace_event::ConvertableToTraceFormat>
+      convertable_values[1];
+  base::DictionaryValue data;
+  if (args->GetNext(&data)) {
+    num_args = 1;
+    convertable_values[0].reset(new JSONTraceValue(data));
+  }
+
+  TraceLog::GetInstance()->AddTraceEvent(
+      phase[0], category_enabled, name.c_str(),
+      trace_event_internal::kGlobalScope,
+      static_cast<unsigned long long>(id),  // NOLINT(runtime/int)
+      num_args, arg_names, arg_types, arg_values, convertable_values, flags);
+}
+
+// Adds a counter event with a series for each number of |values|.
+void AddCounter(mate::Arguments* args) {
+  std::string category, name;
+  base::DictionaryValue values;
+  if (!args->GetNext(&category) || !args->GetNext(&name) ||
+      !args->GetNext(&values)) {
+    args->ThrowError();
+    return;
+  }
+  const unsigned char* category_enabled =
+      TraceLog::GetCategoryGroupEnabled(category.c_str());
+  if (!*category_enabled)
+    return;
+
+  // The series names are copied by the trace log, they only need to outlive
+  // the call.
+  const size_t kMaxSeries = base::trace_event::kTraceMaxNumArgs;
+  std::vector<std::string> series_names;
+  std::vector<double> series_values;
+  for (base::DictionaryValue::Iterator it(values);
+       !it.IsAtEnd() && series_names.size() < kMaxSeries; it.Advance()) {
+    double value;
+    if (it.value().GetAsDouble(&value)) {
+      series_names.push_back(it.key());
+      series_values.push_back(value);
+    }
+  }
+
+  const char* arg_names[kMaxSeries];
+  unsigned char arg_types[kMaxSeries];
+  unsigned long long arg_values[kMaxSeries];  // NOLINT(runtime/int)
+  for (size_t i = 0; i < series_names.size(); ++i) {
+    arg_names[i] = series_names[i].c_str();
+    trace_event_internal::SetTraceValue(series_values[i], &arg_types[i],
+                                        &arg_values[i]);
+  }
+
+  TraceLog::GetInstance()->AddTraceEvent(
+      TRACE_EVENT_PHASE_COUNTER, category_enabled, name.c_str(),
+      trace_event_internal::kGlobalScope, trace_event_internal::kNoId,
+      static_cast<int>(series_names.size()), arg_names, arg_types, arg_values,
+      nullptr, TRACE_EVENT_FLAG_COPY);
+}
+
+void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context, void* priv) {
+  mate::Dictionary dict(context->GetIsolate(), exports);
+  dict.SetMethod("getCategoryEnabledFlag", &GetCategoryEnabledFlag);
+  dict.SetMethod("addTraceEvent", &AddTraceEvent);
+  dict.SetMethod("addCounter", &AddCounter);
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_common_trace_events, Initialize)
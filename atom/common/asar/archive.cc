@@ -4,6 +4,7 @@
 
 #include "atom/common/asar/archive.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -14,7 +15,10 @@
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
 #include "base/values.h"
+#include "crypto/sha2.h"
+#include "third_party/zlib/zlib.h"
 
 #if defined(OS_WIN)
 #include "atom/node/osfhandle.h"
@@ -30,6 +34,10 @@ const char kSeparators[] = "\\/";
 const char kSeparators[] = "/";
 #endif
 
+// Total size of the inflated frames kept in memory, which is enough for the
+// hot files of an app, while range reads of large files do not hold much.
+const size_t kMaxFrameCacheSize = 8 * 1024 * 1024;
+
 bool GetNodeFromPath(std::string path,
                      const base::DictionaryValue* root,
                      const base::DictionaryValue** out);
@@ -96,6 +104,7 @@ bool FillFileInfoWithNode(Archive::FileInfo* info,
   if (!node->GetInteger("size", &size))
     return false;
   info->size = static_cast<uint32_t>(size);
+  info->stored_size = info->size;
 
   if (node->GetBoolean("unpacked", &info->unpacked) && info->unpacked)
     return true;
@@ -109,6 +118,45 @@ bool FillFileInfoWithNode(Archive::FileInfo* info,
 
   node->GetBoolean("executable", &info->executable);
 
+  const base::DictionaryValue* integrity;
+  if (node->GetDictionary("integrity", &integrity)) {
+    std::string algorithm;
+    int block_size;
+    const base::ListValue* blocks;
+    if (!integrity->GetString("algorithm", &algorithm) ||
+        algorithm != "SHA256" ||
+        !integrity->GetInteger("blockSize", &block_size) ||
+        block_size <= 0 ||
+        !integrity->GetList("blocks", &blocks))
+      return false;
+    info->block_size = static_cast<uint32_t>(block_size);
+    info->blocks = blocks;
+  }
+
+  const base::DictionaryValue* compression;
+  if (node->GetDictionary("compression", &compression)) {
+    std::string algorithm;
+    int frame_size;
+    const base::ListValue* frames;
+    if (!compression->GetString("algorithm", &algorithm) ||
+        algorithm != "zlib" ||
+        !compression->GetInteger("frameSize", &frame_size) ||
+        frame_size <= 0 ||
+        !compression->GetList("frames", &frames) ||
+        frames->GetSize() !=
+            (info->size + frame_size - 1) / static_cast<uint32_t>(frame_size))
+      return false;
+    info->stored_size = 0;
+    for (size_t i = 0; i < frames->GetSize(); ++i) {
+      int stored_length;
+      if (!frames->GetInteger(i, &stored_length) || stored_length <= 0)
+        return false;
+      info->stored_size += stored_length;
+    }
+    info->frame_size = static_cast<uint32_t>(frame_size);
+    info->frames = frames;
+  }
+
   return true;
 }
 
@@ -125,7 +173,8 @@ Archive::Archive(const base::FilePath& path)
 #else
       fd_(-1),
 #endif
-      header_size_(0) {
+      header_size_(0),
+      frame_cache_size_(0) {
 }
 
 Archive::~Archive() {
@@ -285,8 +334,17 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
 
   std::unique_ptr<ScopedTemporaryFile> temp_file(new ScopedTemporaryFile);
   base::FilePath::StringType ext = path.Extension();
-  if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size))
-    return false;
+  if (info.frames) {
+    std::string contents(info.size, '\0');
+    if (!Read(info, 0, info.size, &contents[0]) ||
+        !temp_file->InitFromData(ext, contents))
+      return false;
+  } else {
+    if (!VerifyIntegrity(info, 0, info.size, nullptr))
+      return false;
+    if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size))
+      return false;
+  }
 
 #if defined(OS_POSIX)
   if (info.executable) {
@@ -300,6 +358,141 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
   return true;
 }
 
+bool Archive::Read(const FileInfo& info,
+                   uint64_t start,
+                   uint64_t length,
+                   char* out) {
+  if (info.unpacked || start + length > info.size)
+    return false;
+
+  if (!info.frames) {
+    if (length > 0 &&
+        file_.Read(info.offset + start, out, length) !=
+            static_cast<int>(length))
+      return false;
+    return VerifyIntegrity(info, start, length, out);
+  }
+
+  // Inflate the frames overlapping the range.
+  uint64_t end = start + length;
+  uint64_t stored_start = 0;
+  for (size_t index = 0; index < info.frames->GetSize(); ++index) {
+    uint64_t frame_start = static_cast<uint64_t>(index) * info.frame_size;
+    if (frame_start >= end)
+      break;
+
+    int stored_length;
+    info.frames->GetInteger(index, &stored_length);
+    if (frame_start + info.frame_size > start) {
+      std::string frame;
+      if (!ReadFrame(info, frame_start, stored_start, stored_length, &frame))
+        return false;
+      uint64_t copy_start = std::max(start, frame_start);
+      uint64_t copy_end = std::min<uint64_t>(end, frame_start + frame.size());
+      memcpy(out + (copy_start - start),
+             frame.data() + (copy_start - frame_start),
+             copy_end - copy_start);
+    }
+    stored_start += stored_length;
+  }
+  return true;
+}
+
+bool Archive::ReadFrame(const FileInfo& info,
+                        uint64_t start,
+                        uint64_t stored_start,
+                        uint32_t stored_length,
+                        std::string* frame) {
+  uint64_t frame_offset = info.offset + stored_start;
+  {
+    base::AutoLock auto_lock(lock_);
+    for (auto it = frame_cache_.begin(); it != frame_cache_.end(); ++it) {
+      if (it->first == frame_offset) {
+        *frame = it->second;
+        frame_cache_.splice(frame_cache_.begin(), frame_cache_, it);
+        return true;
+      }
+    }
+  }
+
+  std::string stored(stored_length, '\0');
+  if (file_.Read(frame_offset, &stored[0], stored_length) !=
+          static_cast<int>(stored_length) ||
+      !VerifyIntegrity(info, stored_start, stored_length, stored.data()))
+    return false;
+
+  uLongf frame_length = std::min<uint64_t>(info.frame_size, info.size - start);
+  frame->resize(frame_length);
+  if (uncompress(reinterpret_cast<Bytef*>(&(*frame)[0]), &frame_length,
+                 reinterpret_cast<const Bytef*>(stored.data()),
+                 stored.size()) != Z_OK ||
+      frame_length != frame->size()) {
+    LOG(ERROR) << "Failed to inflate the frame at " << frame_offset
+               << " of " << path_.value();
+    return false;
+  }
+
+  base::AutoLock auto_lock(lock_);
+  frame_cache_.emplace_front(frame_offset, *frame);
+  frame_cache_size_ += frame->size();
+  while (frame_cache_size_ > kMaxFrameCacheSize) {
+    frame_cache_size_ -= frame_cache_.back().second.size();
+    frame_cache_.pop_back();
+  }
+  return true;
+}
+
+bool Archive::VerifyIntegrity(const FileInfo& info,
+                              uint64_t start,
+                              uint64_t length,
+                              const char* data) {
+  if (!info.blocks || length == 0)
+    return true;
+
+  uint64_t block_size = info.block_size;
+  uint64_t end = std::min<uint64_t>(start + length, info.stored_size);
+  for (uint64_t index = start / block_size; index * block_size < end;
+       ++index) {
+    uint64_t block_start = index * block_size;
+    uint64_t block_offset = info.offset + block_start;
+    {
+      base::AutoLock auto_lock(lock_);
+      if (verified_blocks_.count(block_offset))
+        continue;
+    }
+
+    // Hash the block from |data| when it has the whole block.
+    uint64_t block_length = std::min<uint64_t>(block_size,
+                                               info.stored_size - block_start);
+    std::string buffer;
+    base::StringPiece block;
+    if (data && block_start >= start &&
+        block_start + block_length <= start + length) {
+      block.set(data + (block_start - start), block_length);
+    } else {
+      buffer.resize(block_length);
+      if (file_.Read(block_offset, &buffer[0], block_length) !=
+              static_cast<int>(block_length))
+        return false;
+      block = buffer;
+    }
+
+    std::string expected;
+    std::string hash = crypto::SHA256HashString(block);
+    if (!info.blocks->GetString(static_cast<size_t>(index), &expected) ||
+        !base::EqualsCaseInsensitiveASCII(
+            expected, base::HexEncode(hash.data(), hash.size()))) {
+      LOG(ERROR) << "Integrity check failed for the block at " << block_offset
+                 << " of " << path_.value();
+      return false;
+    }
+
+    base::AutoLock auto_lock(lock_);
+    verified_blocks_.insert(block_offset);
+  }
+  return true;
+}
+
 int Archive::GetFD() const {
   return fd_;
 }
@@ -5,15 +5,21 @@
 #ifndef ATOM_COMMON_ASAR_ARCHIVE_H_
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
+#include <list>
 #include <memory>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/containers/scoped_ptr_hash_map.h"
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
 
 namespace base {
 class DictionaryValue;
+class ListValue;
 }
 
 namespace asar {
@@ -25,11 +31,27 @@ class ScopedTemporaryFile;
 class Archive {
  public:
   struct FileInfo {
-    FileInfo() : unpacked(false), executable(false), size(0), offset(0) {}
+    FileInfo() : unpacked(false), executable(false), size(0), offset(0),
+                 stored_size(0), block_size(0), blocks(nullptr),
+                 frame_size(0), frames(nullptr) {}
     bool unpacked;
     bool executable;
     uint32_t size;
     uint64_t offset;
+    // Number of bytes stored in the archive, which is less than |size| for
+    // compressed files.
+    uint64_t stored_size;
+    // The SHA-256 hashes of every |block_size| stored bytes of the file, in
+    // hex, null if the file has no "integrity" in the header. It points into
+    // the header so it is valid as long as the Archive.
+    uint32_t block_size;
+    const base::ListValue* blocks;
+    // The sizes of the zlib streams that each holds |frame_size| bytes of the
+    // file, null if the file is not compressed. Frames are compressed
+    // separately so a range of the file can be read without inflating the
+    // frames before it. Points into the header too.
+    uint32_t frame_size;
+    const base::ListValue* frames;
   };
 
   struct Stats : public FileInfo {
@@ -61,11 +83,24 @@ class Archive {
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
+  // Reads |length| bytes at |start| of a packed file into |out|, compressed
+  // files are inflated and the integrity of the read bytes is checked. Can be
+  // called on any thread.
+  bool Read(const FileInfo& info, uint64_t start, uint64_t length, char* out);
+
+  // Checks the hashes of the blocks of a file overlapping the |length| stored
+  // bytes at |start|, blocks are only checked the first time they are read.
+  // |data| can be the bytes being read, it is used instead of reading the
+  // blocks again, or null. Can be called on any thread.
+  bool VerifyIntegrity(const FileInfo& info, uint64_t start, uint64_t length,
+                       const char* data);
+
   // Returns the file's fd.
   int GetFD() const;
 
   base::FilePath path() const { return path_; }
   base::DictionaryValue* header() const { return header_.get(); }
+  uint32_t header_size() const { return header_size_; }
 
  private:
   base::FilePath path_;
@@ -74,6 +109,20 @@ class Archive {
   uint32_t header_size_;
   std::unique_ptr<base::DictionaryValue> header_;
 
+  // Reads the frame of a compressed file that starts at |stored_start| of
+  // its stored bytes and holds the bytes at |start| of the file.
+  bool ReadFrame(const FileInfo& info, uint64_t start, uint64_t stored_start,
+                 uint32_t stored_length, std::string* frame);
+
+  // Guards the fields below.
+  base::Lock lock_;
+  // Offsets in archive of the blocks that have passed the integrity check.
+  std::set<uint64_t> verified_blocks_;
+  // The inflated frames recently read, most recent first, keyed by their
+  // offsets in archive.
+  std::list<std::pair<uint64_t, std::string>> frame_cache_;
+  size_t frame_cache_size_;
+
   // Cached external temporary files.
   base::ScopedPtrHashMap<base::FilePath, std::unique_ptr<ScopedTemporaryFile>>
       external_files_;
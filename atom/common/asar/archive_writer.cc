@@ -0,0 +1,446 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/archive_writer.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "atom/common/asar/archive.h"
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/pickle.h"
+#include "base/strings/pattern.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
+#include "base/values.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
+
+namespace asar {
+
+namespace {
+
+// Same as the asar module of npm, so the hashes of both are interchangeable.
+const uint32_t kBlockSize = 4 * 1024 * 1024;
+
+const size_t kCopyBufferSize = 1024 * 1024;
+
+// Room left after a new header, adding a few files later then only needs the
+// changed files to be appended.
+const size_t kMinHeaderReserve = 4096;
+
+// Runs a task with the next index every time a thread of the pool picks it.
+class IndexedTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit IndexedTask(const base::Callback<void(size_t)>& task)
+      : task_(task), next_index_(0) {}
+
+  void Run() override {
+    size_t index;
+    {
+      base::AutoLock auto_lock(lock_);
+      index = next_index_++;
+    }
+    task_.Run(index);
+  }
+
+ private:
+  base::Callback<void(size_t)> task_;
+  base::Lock lock_;
+  size_t next_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexedTask);
+};
+
+std::string HashToString(const std::string& hash) {
+  return base::ToLowerASCII(base::HexEncode(hash.data(), hash.size()));
+}
+
+bool BlocksEqual(const base::ListValue* list,
+                 const std::vector<std::string>& blocks) {
+  if (list->GetSize() != blocks.size())
+    return false;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    std::string block;
+    if (!list->GetString(i, &block) ||
+        !base::EqualsCaseInsensitiveASCII(block, blocks[i]))
+      return false;
+  }
+  return true;
+}
+
+base::DictionaryValue* GetOrCreateDictionary(base::DictionaryValue* dict,
+                                             const std::string& key) {
+  base::DictionaryValue* child;
+  if (!dict->GetDictionaryWithoutPathExpansion(key, &child)) {
+    child = new base::DictionaryValue;
+    dict->SetWithoutPathExpansion(key, base::WrapUnique(child));
+  }
+  return child;
+}
+
+}  // namespace
+
+struct ArchiveWriter::Entry {
+  Entry(const base::FilePath& path, const base::FilePath& source)
+      : path(path), source(source), unpacked(false), executable(false),
+        failed(false), changed(true), size(0), offset(0) {}
+
+  base::FilePath path;
+  base::FilePath source;
+  bool unpacked;
+  bool executable;
+  bool failed;
+  // Whether the bytes of the file have to be written.
+  bool changed;
+  uint64_t size;
+  // Offset after the header.
+  uint64_t offset;
+  std::string hash;
+  std::vector<std::string> blocks;
+};
+
+ArchiveWriter::ArchiveWriter(const base::FilePath& path)
+    : path_(path),
+      jobs_(base::SysInfo::NumberOfProcessors()),
+      incremental_(true),
+      header_size_(0) {
+}
+
+ArchiveWriter::~ArchiveWriter() {
+}
+
+void ArchiveWriter::AddFile(const base::FilePath& path,
+                            const base::FilePath& source) {
+  entries_.push_back(base::MakeUnique<Entry>(path, source));
+}
+
+bool ArchiveWriter::AddDirectory(const base::FilePath& source_dir) {
+  if (!base::DirectoryExists(source_dir))
+    return false;
+
+  base::FileEnumerator enumerator(source_dir, true,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath source = enumerator.Next(); !source.empty();
+       source = enumerator.Next()) {
+    base::FilePath path;
+    if (source_dir.AppendRelativePath(source, &path))
+      AddFile(path, source);
+  }
+  return true;
+}
+
+bool ArchiveWriter::Write() {
+  // Keep the order of files stable, so an unchanged tree gives the same
+  // archive.
+  std::sort(entries_.begin(), entries_.end(),
+            [](const std::unique_ptr<Entry>& a,
+               const std::unique_ptr<Entry>& b) { return a->path < b->path; });
+  for (const auto& entry : entries_) {
+    entry->unpacked = !unpack_pattern_.empty() &&
+                      base::MatchPattern(entry->path.AsUTF8Unsafe(),
+                                         unpack_pattern_);
+  }
+
+  RunInParallel(entries_.size(), &ArchiveWriter::HashEntry);
+  for (const auto& entry : entries_) {
+    if (entry->failed)
+      return false;
+  }
+
+  // Try to update the existing archive, whose header has to be large enough
+  // for the new one.
+  size_t header_length = 0;
+  if (incremental_) {
+    Archive archive(path_);
+    if (archive.Init() && ReuseArchive(&archive)) {
+      header_size_ = archive.header_size();
+      // The header is a pickled string after two uint32 and the size of the
+      // pickle, see Archive::Init.
+      header_length = header_size_ - 16;
+    }
+  }
+
+  std::string header;
+  base::JSONWriter::Write(*BuildHeader(), &header);
+  if (header.size() > header_length) {
+    header_length = 0;
+    header_size_ = 0;
+    LayOutEntries();
+    base::JSONWriter::Write(*BuildHeader(), &header);
+  }
+
+  // The archive is written aside and moved over the old one when complete.
+  // An updated archive starts as a copy of the old one, so only the changed
+  // files have to be written.
+  base::FilePath temp_path(path_.value() + FILE_PATH_LITERAL(".tmp"));
+  if (header_length > 0) {
+    if (!base::CopyFile(path_, temp_path)) {
+      LOG(ERROR) << "Failed to copy " << path_.value() << " to "
+                 << temp_path.value();
+      return false;
+    }
+    file_.Initialize(temp_path,
+                     base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  } else {
+    file_.Initialize(temp_path,
+                     base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+    if (file_.IsValid() && !WriteHeader(header, 0))
+      return false;
+  }
+  if (!file_.IsValid()) {
+    LOG(ERROR) << "Failed to open " << temp_path.value() << ": "
+               << base::File::ErrorToString(file_.error_details());
+    return false;
+  }
+
+  RunInParallel(entries_.size(), &ArchiveWriter::CopyEntry);
+  for (const auto& entry : entries_) {
+    if (entry->failed)
+      return false;
+  }
+
+  // The header of an updated archive is rewritten in the space it had.
+  bool result = header_length == 0 || WriteHeader(header, header_length);
+  file_.Close();
+  if (!result)
+    return false;
+  if (!base::ReplaceFile(temp_path, path_, nullptr)) {
+    LOG(ERROR) << "Failed to move " << temp_path.value() << " to "
+               << path_.value();
+    return false;
+  }
+  return true;
+}
+
+void ArchiveWriter::HashEntry(size_t index) {
+  Entry* entry = entries_[index].get();
+  base::File file(entry->source,
+                  base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid()) {
+    LOG(ERROR) << "Failed to open " << entry->source.value() << ": "
+               << base::File::ErrorToString(file.error_details());
+    entry->failed = true;
+    return;
+  }
+
+#if defined(OS_POSIX)
+  int mode;
+  entry->executable =
+      base::GetPosixFilePermissions(entry->source, &mode) &&
+      (mode & base::FILE_PERMISSION_EXECUTE_BY_USER);
+#endif
+
+  // Unpacked files are read from disk, they only need the size.
+  if (entry->unpacked) {
+    entry->size = file.GetLength();
+    return;
+  }
+
+  std::unique_ptr<crypto::SecureHash> hash(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+  std::vector<char> buf(kBlockSize);
+  while (true) {
+    int len = file.ReadAtCurrentPos(buf.data(), buf.size());
+    if (len < 0) {
+      PLOG(ERROR) << "Failed to read " << entry->source.value();
+      entry->failed = true;
+      return;
+    }
+    if (len == 0)
+      break;
+    entry->size += len;
+    hash->Update(buf.data(), len);
+    entry->blocks.push_back(
+        HashToString(crypto::SHA256HashString(std::string(buf.data(), len))));
+  }
+
+  // The size is an int in the header.
+  if (entry->size > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+    LOG(ERROR) << entry->source.value() << " is too large to be packed";
+    entry->failed = true;
+    return;
+  }
+
+  std::string digest(crypto::kSHA256Length, '\0');
+  hash->Finish(&digest[0], digest.size());
+  entry->hash = HashToString(digest);
+}
+
+void ArchiveWriter::CopyEntry(size_t index) {
+  Entry* entry = entries_[index].get();
+  if (!entry->changed)
+    return;
+
+  if (entry->unpacked) {
+    base::FilePath dest =
+        base::FilePath(path_.value() + FILE_PATH_LITERAL(".unpacked"))
+            .Append(entry->path);
+    if (!base::CreateDirectory(dest.DirName()) ||
+        !base::CopyFile(entry->source, dest)) {
+      LOG(ERROR) << "Failed to copy " << entry->source.value() << " to "
+                 << dest.value();
+      entry->failed = true;
+    }
+    return;
+  }
+
+  base::File source(entry->source,
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+  std::vector<char> buf(kCopyBufferSize);
+  uint64_t copied = 0;
+  while (copied < entry->size) {
+    int len = source.ReadAtCurrentPos(
+        buf.data(), std::min<uint64_t>(buf.size(), entry->size - copied));
+    if (len <= 0 ||
+        file_.Write(header_size_ + entry->offset + copied, buf.data(), len) !=
+            len) {
+      PLOG(ERROR) << "Failed to copy " << entry->source.value() << " to "
+                  << path_.value();
+      entry->failed = true;
+      return;
+    }
+    copied += len;
+  }
+}
+
+bool ArchiveWriter::ReuseArchive(Archive* archive) {
+  int64_t archive_size;
+  if (!base::GetFileSize(path_, &archive_size) ||
+      archive_size < archive->header_size())
+    return false;
+  uint64_t end = archive_size - archive->header_size();
+
+  uint64_t kept_size = 0;
+  uint64_t appended_size = 0;
+  for (const auto& entry : entries_) {
+    if (entry->unpacked)
+      continue;
+    Archive::FileInfo info;
+    if (archive->GetFileInfo(entry->path, &info) && !info.unpacked &&
+        !info.frames && info.blocks && info.block_size == kBlockSize &&
+        info.size == entry->size && BlocksEqual(info.blocks, entry->blocks)) {
+      entry->changed = false;
+      entry->offset = info.offset - archive->header_size();
+      kept_size += entry->size;
+    } else {
+      entry->changed = true;
+      entry->offset = end + appended_size;
+      appended_size += entry->size;
+    }
+  }
+
+  // Rewrite the archive when most of it would be bytes no file uses.
+  return end - std::min(end, kept_size) <= (end + appended_size) / 2;
+}
+
+void ArchiveWriter::LayOutEntries() {
+  uint64_t offset = 0;
+  for (const auto& entry : entries_) {
+    entry->changed = true;
+    if (entry->unpacked)
+      continue;
+    entry->offset = offset;
+    offset += entry->size;
+  }
+}
+
+std::unique_ptr<base::DictionaryValue> ArchiveWriter::BuildHeader() const {
+  std::unique_ptr<base::DictionaryValue> root(new base::DictionaryValue);
+  GetOrCreateDictionary(root.get(), "files");
+  for (const auto& entry : entries_) {
+    std::vector<base::FilePath::StringType> components;
+    entry->path.GetComponents(&components);
+    if (components.empty())
+      continue;
+
+    base::DictionaryValue* dir = root.get();
+    for (size_t i = 0; i < components.size() - 1; ++i) {
+      dir = GetOrCreateDictionary(
+          GetOrCreateDictionary(dir, "files"),
+          base::FilePath(components[i]).AsUTF8Unsafe());
+    }
+
+    std::unique_ptr<base::DictionaryValue> node(new base::DictionaryValue);
+    node->SetInteger("size", static_cast<int>(entry->size));
+    if (entry->executable)
+      node->SetBoolean("executable", true);
+    if (entry->unpacked) {
+      node->SetBoolean("unpacked", true);
+    } else {
+      node->SetString("offset", base::Uint64ToString(entry->offset));
+      std::unique_ptr<base::ListValue> blocks(new base::ListValue);
+      for (const std::string& block : entry->blocks)
+        blocks->AppendString(block);
+      std::unique_ptr<base::DictionaryValue> integrity(
+          new base::DictionaryValue);
+      integrity->SetString("algorithm", "SHA256");
+      integrity->SetString("hash", entry->hash);
+      integrity->SetInteger("blockSize", kBlockSize);
+      integrity->Set("blocks", std::move(blocks));
+      node->Set("integrity", std::move(integrity));
+    }
+    GetOrCreateDictionary(dir, "files")->SetWithoutPathExpansion(
+        base::FilePath(components.back()).AsUTF8Unsafe(), std::move(node));
+  }
+  return root;
+}
+
+bool ArchiveWriter::WriteHeader(const std::string& header,
+                                size_t header_length) {
+  // The header is padded with spaces, which the JSON parsers ignore.
+  if (header_length == 0) {
+    header_length = header.size() +
+                    std::max(kMinHeaderReserve, header.size() / 8);
+    header_length = (header_length + 3) / 4 * 4;
+  }
+  DCHECK_GE(header_length, header.size());
+  std::string padded(header);
+  padded.resize(header_length, ' ');
+
+  base::Pickle header_pickle;
+  header_pickle.WriteString(padded);
+  base::Pickle size_pickle;
+  size_pickle.WriteUInt32(header_pickle.size());
+
+  uint64_t header_size = size_pickle.size() + header_pickle.size();
+  DCHECK(header_size_ == 0 || header_size_ == header_size);
+  header_size_ = header_size;
+  if (file_.Write(0, static_cast<const char*>(size_pickle.data()),
+                  size_pickle.size()) !=
+          static_cast<int>(size_pickle.size()) ||
+      file_.Write(size_pickle.size(),
+                  static_cast<const char*>(header_pickle.data()),
+                  header_pickle.size()) !=
+          static_cast<int>(header_pickle.size())) {
+    PLOG(ERROR) << "Failed to write the header of " << path_.value();
+    return false;
+  }
+  return true;
+}
+
+void ArchiveWriter::RunInParallel(size_t count,
+                                  void (ArchiveWriter::*task)(size_t)) {
+  if (count == 0)
+    return;
+
+  IndexedTask indexed_task(base::Bind(task, base::Unretained(this)));
+  int threads = static_cast<int>(
+      std::max<size_t>(1, std::min<size_t>(jobs_, count)));
+  base::DelegateSimpleThreadPool pool("AsarWriter", threads);
+  pool.AddWork(&indexed_task, static_cast<int>(count));
+  pool.Start();
+  pool.JoinAll();
+}
+
+}  // namespace asar
@@ -0,0 +1,102 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_ARCHIVE_WRITER_H_
+#define ATOM_COMMON_ASAR_ARCHIVE_WRITER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace asar {
+
+class Archive;
+
+// Writes an asar archive from files on disk, the header is read back by
+// asar::Archive.
+//
+// The input files are read and hashed in parallel, every packed file gets an
+// "integrity" field so Electron can check it when reading. When the archive
+// already exists, the files that have not changed are kept where they are and
+// only the changed files are appended to a copy of it, the old bytes are
+// reclaimed by a full rewrite once they take too much of the archive. The
+// archive is always written to a temporary file that replaces it when
+// complete, so it is never seen partly written.
+class ArchiveWriter {
+ public:
+  explicit ArchiveWriter(const base::FilePath& path);
+  ~ArchiveWriter();
+
+  // Adds the file at |source| as |path| in the archive.
+  void AddFile(const base::FilePath& path, const base::FilePath& source);
+
+  // Adds all files under |source_dir|, with paths relative to it.
+  bool AddDirectory(const base::FilePath& source_dir);
+
+  // Files whose paths in the archive match |pattern| are copied to the
+  // ".unpacked" directory next to the archive instead.
+  void set_unpack_pattern(const std::string& pattern) {
+    unpack_pattern_ = pattern;
+  }
+
+  // Number of threads reading and writing files.
+  void set_jobs(int jobs) { jobs_ = jobs; }
+
+  // Whether an existing archive can be updated in place.
+  void set_incremental(bool incremental) { incremental_ = incremental; }
+
+  // Writes the archive, returns false on error.
+  bool Write();
+
+ private:
+  struct Entry;
+
+  // Reads |entry|'s file to get its size and hashes, called in parallel.
+  void HashEntry(size_t index);
+
+  // Copies the bytes of |entry|'s file to |file_|, called in parallel.
+  void CopyEntry(size_t index);
+
+  // Keeps the offsets of the files unchanged in |archive| and puts the other
+  // files after its bytes, returns false when the archive has to be
+  // rewritten.
+  bool ReuseArchive(Archive* archive);
+
+  // Puts all files one after another for a full rewrite.
+  void LayOutEntries();
+
+  // Builds the JSON header of the archive.
+  std::unique_ptr<base::DictionaryValue> BuildHeader() const;
+
+  // Writes the header padded to |header_length| characters, or with room for
+  // the header to grow when it is 0.
+  bool WriteHeader(const std::string& header, size_t header_length);
+
+  // Runs |task| with every index below |count| on |jobs_| threads.
+  void RunInParallel(size_t count, void (ArchiveWriter::*task)(size_t));
+
+  base::FilePath path_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+  std::string unpack_pattern_;
+  int jobs_;
+  bool incremental_;
+
+  // The archive being written and the size of its header.
+  base::File file_;
+  uint64_t header_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveWriter);
+};
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_ARCHIVE_WRITER_H_
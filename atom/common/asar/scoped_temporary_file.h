@@ -5,6 +5,8 @@
 #ifndef ATOM_COMMON_ASAR_SCOPED_TEMPORARY_FILE_H_
 #define ATOM_COMMON_ASAR_SCOPED_TEMPORARY_FILE_H_
 
+#include <string>
+
 #include "base/files/file_path.h"
 
 namespace base {
@@ -30,6 +32,10 @@ class ScopedTemporaryFile {
                     const base::FilePath::StringType& ext,
                     uint64_t offset, uint64_t size);
 
+  // Init an temporary file and fill it with |data|.
+  bool InitFromData(const base::FilePath::StringType& ext,
+                    const std::string& data);
+
   base::FilePath path() const { return path_; }
 
  private:
@@ -0,0 +1,182 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/jank_monitor.h"
+
+#include <sstream>
+
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/debug/stack_trace.h"
+#include "base/memory/ptr_util.h"
+#include "base/pending_task.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/values.h"
+
+namespace atom {
+
+namespace {
+
+// Number of JavaScript frames captured for a janky task.
+const int kMaxStackFrames = 32;
+
+// The watchdog checks the running task this many times per threshold.
+const int kChecksPerThreshold = 4;
+
+// There is at most one monitor per process, it is only accessed in main
+// thread.
+JankMonitor* g_jank_monitor = nullptr;
+
+void RunReportCallback(const JankMonitor::ReportCallback& callback,
+                       std::unique_ptr<base::DictionaryValue> details) {
+  callback.Run(*details);
+}
+
+std::string FormatStackTrace(v8::Local<v8::StackTrace> stack_trace) {
+  std::ostringstream stream;
+  for (int i = 0; i < stack_trace->GetFrameCount(); ++i) {
+    v8::Local<v8::StackFrame> frame = stack_trace->GetFrame(i);
+    v8::String::Utf8Value function_name(frame->GetFunctionName());
+    v8::String::Utf8Value script_name(frame->GetScriptName());
+    stream << "    at "
+           << (function_name.length() ? *function_name : "<anonymous>")
+           << " (" << (script_name.length() ? *script_name : "<unknown>")
+           << ":" << frame->GetLineNumber() << ":" << frame->GetColumn()
+           << ")\n";
+  }
+  return stream.str();
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<JankMonitor> JankMonitor::CreateFromCommandLine(
+    v8::Isolate* isolate, const ReportCallback& callback) {
+  auto command_line = base::CommandLine::ForCurrentProcess();
+  int threshold;
+  if (!base::StringToInt(
+          command_line->GetSwitchValueASCII(switches::kJankThreshold),
+          &threshold) ||
+      threshold <= 0)
+    return nullptr;
+  return base::MakeUnique<JankMonitor>(
+      isolate, base::TimeDelta::FromMilliseconds(threshold), callback);
+}
+
+JankMonitor::JankMonitor(v8::Isolate* isolate,
+                         base::TimeDelta threshold,
+                         const ReportCallback& callback)
+    : isolate_(isolate),
+      threshold_(threshold),
+      callback_(callback),
+      task_sequence_(0),
+      task_running_(false),
+      janky_sequence_(0),
+      task_name_(nullptr),
+      stacks_captured_(false),
+      watchdog_("JankMonitor") {
+  DCHECK(!g_jank_monitor);
+  g_jank_monitor = this;
+  base::MessageLoop::current()->AddTaskObserver(this);
+
+  watchdog_.Start();
+  watchdog_.task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&JankMonitor::CheckRunningTask, base::Unretained(this)));
+}
+
+JankMonitor::~JankMonitor() {
+  watchdog_.Stop();
+  base::MessageLoop::current()->RemoveTaskObserver(this);
+  g_jank_monitor = nullptr;
+}
+
+// static
+void JankMonitor::SetCurrentTaskName(const char* name) {
+  if (g_jank_monitor)
+    g_jank_monitor->task_name_ = name;
+}
+
+void JankMonitor::WillProcessTask(const base::PendingTask& pending_task) {
+  // For nested tasks the outer task stops being measured, which is what we
+  // want since it is not blocking the loop.
+  task_location_ = pending_task.posted_from;
+  task_name_ = nullptr;
+  stacks_captured_ = false;
+
+  base::AutoLock auto_lock(lock_);
+  ++task_sequence_;
+  task_running_ = true;
+  task_start_ = base::TimeTicks::Now();
+}
+
+void JankMonitor::DidProcessTask(const base::PendingTask& pending_task) {
+  base::TimeDelta duration;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!task_running_)
+      return;
+    task_running_ = false;
+    duration = base::TimeTicks::Now() - task_start_;
+    if (janky_sequence_ != task_sequence_)
+      return;
+  }
+
+  std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
+  details->SetDouble("duration", duration.InMillisecondsF());
+  details->SetString("task", task_name_ ? std::string(task_name_)
+                                        : task_location_.ToString());
+  details->SetString("jsStack", js_stack_);
+  details->SetString("nativeStack", native_stack_);
+  js_stack_.clear();
+  native_stack_.clear();
+
+  // Report in a new task, so the callback is not counted in this one.
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&RunReportCallback, callback_, base::Passed(&details)));
+}
+
+void JankMonitor::CheckRunningTask() {
+  {
+    base::AutoLock auto_lock(lock_);
+    if (task_running_ && janky_sequence_ != task_sequence_ &&
+        base::TimeTicks::Now() - task_start_ >= threshold_) {
+      janky_sequence_ = task_sequence_;
+      isolate_->RequestInterrupt(&JankMonitor::OnInterrupt, nullptr);
+    }
+  }
+
+  watchdog_.task_runner()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&JankMonitor::CheckRunningTask, base::Unretained(this)),
+      threshold_ / kChecksPerThreshold);
+}
+
+// static
+void JankMonitor::OnInterrupt(v8::Isolate* isolate, void* data) {
+  // The monitor may have gone before V8 got a chance to run the interrupt.
+  if (g_jank_monitor && g_jank_monitor->isolate_ == isolate)
+    g_jank_monitor->CaptureStacks();
+}
+
+void JankMonitor::CaptureStacks() {
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!task_running_ || janky_sequence_ != task_sequence_)
+      return;
+  }
+  if (stacks_captured_)
+    return;
+  stacks_captured_ = true;
+
+  v8::HandleScope handle_scope(isolate_);
+  js_stack_ = FormatStackTrace(v8::StackTrace::CurrentStackTrace(
+      isolate_, kMaxStackFrames, v8::StackTrace::kOverview));
+  native_stack_ = base::debug::StackTrace().ToString();
+}
+
+}  // namespace atom
@@ -0,0 +1,100 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_JANK_MONITOR_H_
+#define ATOM_COMMON_JANK_MONITOR_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/location.h"
+#include "base/macros.h"
+#include "base/message_loop/message_loop.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "v8/include/v8.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace atom {
+
+// Measures how long each task of the main thread runs, and reports the tasks
+// that run longer than a threshold together with the JavaScript and native
+// stacks captured while they were still running.
+//
+// A watchdog thread checks the running task periodically, when it exceeds the
+// threshold the stacks are captured by a V8 interrupt in main thread, so they
+// are only available when the task is blocked in JavaScript or in native code
+// called from JavaScript.
+//
+// In renderer processes Blink's scheduler runs the tasks of the page from its
+// own task posted to the message loop, so the monitor only sees the
+// scheduler's DoWork task and reports it as the location of every janky task
+// of the page.
+class JankMonitor : public base::MessageLoop::TaskObserver {
+ public:
+  // Called in main thread after the janky task has finished.
+  using ReportCallback = base::Callback<void(const base::DictionaryValue&)>;
+
+  // Returns null unless the --jank-threshold switch is set, must be called in
+  // main thread after its message loop has been created.
+  static std::unique_ptr<JankMonitor> CreateFromCommandLine(
+      v8::Isolate* isolate, const ReportCallback& callback);
+
+  JankMonitor(v8::Isolate* isolate,
+              base::TimeDelta threshold,
+              const ReportCallback& callback);
+  ~JankMonitor() override;
+
+  // Names the task currently running in main thread, e.g. the one running the
+  // uv loop, the name is reported instead of where the task was posted from.
+  // |name| must be a string literal.
+  static void SetCurrentTaskName(const char* name);
+
+ protected:
+  // base::MessageLoop::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task) override;
+  void DidProcessTask(const base::PendingTask& pending_task) override;
+
+ private:
+  // Called in watchdog thread.
+  void CheckRunningTask();
+
+  // Called in main thread by V8 while the janky task is running.
+  static void OnInterrupt(v8::Isolate* isolate, void* data);
+  void CaptureStacks();
+
+  v8::Isolate* isolate_;
+  base::TimeDelta threshold_;
+  ReportCallback callback_;
+
+  // Guards the fields below, they are shared with the watchdog thread.
+  base::Lock lock_;
+  // Increased for every task, so an interrupt that arrives after its task
+  // has finished is ignored.
+  uint64_t task_sequence_;
+  bool task_running_;
+  base::TimeTicks task_start_;
+  // The sequence of the task that has exceeded the threshold.
+  uint64_t janky_sequence_;
+
+  // Only used in main thread.
+  tracked_objects::Location task_location_;
+  const char* task_name_;
+  bool stacks_captured_;
+  std::string js_stack_;
+  std::string native_stack_;
+
+  base::Thread watchdog_;
+
+  DISALLOW_COPY_AND_ASSIGN(JankMonitor);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_JANK_MONITOR_H_
@@ -10,6 +10,7 @@
 #include "atom/common/api/event_emitter_caller.h"
 #include "atom/common/api/locker.h"
 #include "atom/common/atom_command_line.h"
+#include "atom/common/jank_monitor.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "base/base_paths.h"
 #include "base/command_line.h"
@@ -42,6 +43,7 @@ REFERENCE_MODULE(atom_browser_desktop_capturer);
 REFERENCE_MODULE(atom_browser_download_item);
 REFERENCE_MODULE(atom_browser_menu);
 REFERENCE_MODULE(atom_browser_net);
+REFERENCE_MODULE(atom_browser_node_worker);
 REFERENCE_MODULE(atom_browser_power_monitor);
 REFERENCE_MODULE(atom_browser_power_save_blocker);
 REFERENCE_MODULE(atom_browser_protocol);
@@ -59,6 +61,7 @@ REFERENCE_MODULE(atom_common_crash_reporter);
 REFERENCE_MODULE(atom_common_native_image);
 REFERENCE_MODULE(atom_common_screen);
 REFERENCE_MODULE(atom_common_shell);
+REFERENCE_MODULE(atom_common_trace_events);
 REFERENCE_MODULE(atom_common_v8_util);
 REFERENCE_MODULE(atom_renderer_ipc);
 REFERENCE_MODULE(atom_renderer_web_frame);
@@ -68,6 +71,10 @@ namespace atom {
 
 namespace {
 
+// Upper bound of uv_run passes in a single UvRunOnce task, so a busy uv loop
+// can not starve the tasks of Chromium's message loop.
+const int kMaxUvRunsPerTask = 8;
+
 // Convert the given vector to an array of C-strings. The strings in the
 // returned vector are only guaranteed valid so long as the vector of strings
 // is not modified.
@@ -80,7 +87,21 @@ std::unique_ptr<const char*[]> StringVectorToArgArray(
   return array;
 }
 
-base::FilePath GetResourcesPath(bool is_browser) {
+v8::Local<v8::Value> UvStatsToV8(v8::Isolate* isolate,
+                                 const NodeBindings::UvStats& stats) {
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("wakeups", stats.wakeups);
+  dict.Set("coalescedWakeups", stats.coalesced_wakeups);
+  dict.Set("tasks", stats.tasks);
+  dict.Set("iterations", stats.iterations);
+  dict.Set("uvRunTime", stats.uv_run_time.InMillisecondsF());
+  return dict.GetHandle();
+}
+
+}  // namespace
+
+// static
+base::FilePath NodeBindings::GetResourcesPath(bool is_browser) {
   auto command_line = base::CommandLine::ForCurrentProcess();
   base::FilePath exec_path(command_line->GetProgram());
   PathService::Get(base::FILE_EXE, &exec_path);
@@ -96,8 +117,6 @@ base::FilePath GetResourcesPath(bool is_browser) {
   return resources_path;
 }
 
-}  // namespace
-
 NodeBindings::NodeBindings(bool is_browser)
     : is_browser_(is_browser),
       uv_loop_(uv_default_loop()),
@@ -190,6 +209,10 @@ node::Environment* NodeBindings::CreateEnvironment(
       base::CommandLine::ForCurrentProcess()->HasSwitch("debug-brk"))
     process.Set("_debugWaitConnect", true);
 
+  // Expose the counters of message loop integration.
+  process.SetMethod("getUvStats", base::Bind(&NodeBindings::GetUvStatsForJS,
+                                             base::Unretained(this)));
+
   return env;
 }
 
@@ -220,9 +243,24 @@ void NodeBindings::RunMessageLoop() {
   UvRunOnce();
 }
 
+NodeBindings::UvStats NodeBindings::GetUvStats() const {
+  return stats_;
+}
+
+v8::Local<v8::Value> NodeBindings::GetUvStatsForJS(v8::Isolate* isolate) {
+  return UvStatsToV8(isolate, GetUvStats());
+}
+
+bool NodeBindings::HasPendingEvents() {
+  return false;
+}
+
 void NodeBindings::UvRunOnce() {
   DCHECK(!is_browser_ || BrowserThread::CurrentlyOn(BrowserThread::UI));
 
+  ++stats_.tasks;
+  JankMonitor::SetCurrentTaskName("NodeBindings::UvRunOnce");
+
   node::Environment* env = uv_env();
 
   // Use Locker in browser process.
@@ -239,8 +277,18 @@ void NodeBindings::UvRunOnce() {
   if (!is_browser_)
     TRACE_EVENT_BEGIN0("devtools.timeline", "FunctionCall");
 
-  // Deal with uv events.
-  int r = uv_run(uv_loop_, UV_RUN_NOWAIT);
+  // Deal with uv events, when more events became ready while running the
+  // callbacks, handle them here instead of waking up the embed thread.
+  base::TimeTicks start = base::TimeTicks::Now();
+  int r;
+  int runs = 0;
+  do {
+    r = uv_run(uv_loop_, UV_RUN_NOWAIT);
+    ++runs;
+  } while (r != 0 && runs < kMaxUvRunsPerTask && HasPendingEvents());
+  stats_.iterations += runs;
+  stats_.coalesced_wakeups += runs - 1;
+  stats_.uv_run_time += base::TimeTicks::Now() - start;
 
   if (!is_browser_)
     TRACE_EVENT_END0("devtools.timeline", "FunctionCall");
@@ -252,9 +300,14 @@ void NodeBindings::UvRunOnce() {
   uv_sem_post(&embed_sem_);
 }
 
+void NodeBindings::OnWakeup() {
+  ++stats_.wakeups;
+  UvRunOnce();
+}
+
 void NodeBindings::WakeupMainThread() {
   DCHECK(task_runner_);
-  task_runner_->PostTask(FROM_HERE, base::Bind(&NodeBindings::UvRunOnce,
+  task_runner_->PostTask(FROM_HERE, base::Bind(&NodeBindings::OnWakeup,
                                                weak_factory_.GetWeakPtr()));
 }
 
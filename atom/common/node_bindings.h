@@ -5,8 +5,10 @@
 #ifndef ATOM_COMMON_NODE_BINDINGS_H_
 #define ATOM_COMMON_NODE_BINDINGS_H_
 
+#include "base/files/file_path.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "v8/include/v8.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
@@ -22,8 +24,29 @@ namespace atom {
 
 class NodeBindings {
  public:
+  // Counters describing the traffic between the embed thread and the main
+  // thread, used to measure the cost of running node's I/O in main loop.
+  struct UvStats {
+    // Number of times the embed thread found the uv loop ready.
+    int64_t wakeups = 0;
+    // Number of times events that became ready while running the uv loop
+    // were handled in the same task, instead of going through the embed
+    // thread with another wakeup.
+    int64_t coalesced_wakeups = 0;
+    // Number of UvRunOnce tasks that ran in main thread.
+    int64_t tasks = 0;
+    // Number of uv_run calls, a task may run several of them.
+    int64_t iterations = 0;
+    // Total time spent in uv_run.
+    base::TimeDelta uv_run_time;
+  };
+
   static NodeBindings* Create(bool is_browser);
 
+  // Returns the path of the "resources" directory that contains the
+  // electron.asar archive.
+  static base::FilePath GetResourcesPath(bool is_browser);
+
   virtual ~NodeBindings();
 
   // Setup V8, libuv.
@@ -45,15 +68,27 @@ class NodeBindings {
   void set_uv_env(node::Environment* env) { uv_env_ = env; }
   node::Environment* uv_env() const { return uv_env_; }
 
+  // Returns a snapshot of the counters, must be called in main thread.
+  UvStats GetUvStats() const;
+  v8::Local<v8::Value> GetUvStatsForJS(v8::Isolate* isolate);
+
  protected:
   explicit NodeBindings(bool is_browser);
 
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
+  // Called in main thread after uv_run to check whether the backend has more
+  // events ready, so they can be handled in the same task instead of bouncing
+  // through the embed thread again. Implementations must not block.
+  virtual bool HasPendingEvents();
+
   // Run the libuv loop for once.
   void UvRunOnce();
 
+  // Called in main thread for the wakeups of the embed thread.
+  void OnWakeup();
+
   // Make the main thread run libuv loop.
   void WakeupMainThread();
 
@@ -88,6 +123,10 @@ class NodeBindings {
   // Environment that to wrap the uv loop.
   node::Environment* uv_env_;
 
+  // The embed thread only polls again after the posted task has run, so the
+  // counters are all updated in main thread.
+  UvStats stats_;
+
   base::WeakPtrFactory<NodeBindings> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(NodeBindings);
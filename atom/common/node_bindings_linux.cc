@@ -49,6 +49,15 @@ void NodeBindingsLinux::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsLinux::HasPendingEvents() {
+  struct epoll_event ev;
+  int r;
+  do {
+    r = epoll_wait(epoll_, &ev, 1, 0);
+  } while (r == -1 && errno == EINTR);
+  return r > 0;
+}
+
 // static
 NodeBindings* NodeBindings::Create(bool is_browser) {
   return new NodeBindingsLinux(is_browser);
@@ -122,6 +122,22 @@ const char kBlinkFeatures[] = "blinkFeatures";
 // Disable blink features.
 const char kDisableBlinkFeatures[] = "disableBlinkFeatures";
 
+// Capacity of Blink's memory cache in megabytes.
+const char kMemoryCacheCapacity[] = "memoryCacheCapacity";
+
+// The size of V8 heap in megabytes above which the memory is purged.
+const char kV8HeapSoftLimit[] = "v8HeapSoftLimit";
+
+// Purge the memory after the page has been hidden for a while.
+const char kPurgeMemoryWhenHidden[] = "purgeMemoryWhenHidden";
+
+// The page is a spare renderer of a session, which stays on about:blank until
+// a window takes it.
+const char kSpareRenderer[] = "spareRenderer";
+
+// Report the renderer's main thread tasks running longer than the milliseconds.
+const char kJankThreshold[] = "jankThreshold";
+
 }  // namespace options
 
 namespace switches {
@@ -160,6 +176,9 @@ const char kCipherSuiteBlacklist[] = "cipher-suite-blacklist";
 // The browser process app model ID
 const char kAppUserModelId[] = "app-user-model-id";
 
+// Report the main thread tasks running longer than the milliseconds.
+const char kJankThreshold[] = "jank-threshold";
+
 // The command line switch versions of the options.
 const char kBackgroundColor[]  = "background-color";
 const char kZoomFactor[]       = "zoom-factor";
@@ -172,6 +191,14 @@ const char kOpenerID[]         = "opener-id";
 const char kScrollBounce[]     = "scroll-bounce";
 const char kHiddenPage[]       = "hidden-page";
 
+// The memory policies of the renderer process.
+const char kMemoryCacheCapacity[]   = "memory-cache-capacity";
+const char kV8HeapSoftLimit[]       = "v8-heap-soft-limit";
+const char kPurgeMemoryWhenHidden[] = "purge-memory-when-hidden";
+
+// The renderer process was launched for a spare renderer.
+const char kSpareRenderer[] = "spare-renderer";
+
 // Widevine options
 // Path to Widevine CDM binaries.
 const char kWidevineCdmPath[] = "widevine-cdm-path";
@@ -62,6 +62,11 @@ extern const char kOpenerID[];
 extern const char kScrollBounce[];
 extern const char kBlinkFeatures[];
 extern const char kDisableBlinkFeatures[];
+extern const char kMemoryCacheCapacity[];
+extern const char kV8HeapSoftLimit[];
+extern const char kPurgeMemoryWhenHidden[];
+extern const char kSpareRenderer[];
+extern const char kJankThreshold[];
 
 }   // namespace options
 
@@ -81,6 +86,7 @@ extern const char kSecureSchemes[];
 extern const char kSSLVersionFallbackMin[];
 extern const char kCipherSuiteBlacklist[];
 extern const char kAppUserModelId[];
+extern const char kJankThreshold[];
 
 extern const char kBackgroundColor[];
 extern const char kZoomFactor[];
@@ -92,6 +98,10 @@ extern const char kGuestInstanceID[];
 extern const char kOpenerID[];
 extern const char kScrollBounce[];
 extern const char kHiddenPage[];
+extern const char kMemoryCacheCapacity[];
+extern const char kV8HeapSoftLimit[];
+extern const char kPurgeMemoryWhenHidden[];
+extern const char kSpareRenderer[];
 
 extern const char kWidevineCdmPath[];
 extern const char kWidevineCdmVersion[];
@@ -7,6 +7,7 @@
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
+#include "atom/renderer/atom_render_view_observer.h"
 #include "content/public/renderer/render_view.h"
 #include "native_mate/dictionary.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
@@ -65,11 +66,48 @@ base::string16 SendSync(mate::Arguments* args,
   return json;
 }
 
+void PostPortMessage(mate::Arguments* args,
+                     int port_id,
+                     const base::ListValue& arguments) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == nullptr)
+    return;
+
+  bool success = render_view->Send(new AtomViewHostMsg_PortMessage(
+      render_view->GetRoutingID(), port_id, arguments));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_PortMessage");
+}
+
+void ClosePort(int port_id) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == nullptr)
+    return;
+
+  render_view->Send(new AtomViewHostMsg_ClosePort(
+      render_view->GetRoutingID(), port_id));
+}
+
+void SetChannelSubscribed(const base::string16& channel, bool subscribed) {
+  WebLocalFrame* frame = WebLocalFrame::frameForCurrentContext();
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == nullptr)
+    return;
+
+  auto observer = AtomRenderViewObserver::Get(render_view);
+  if (observer)
+    observer->SetChannelSubscribed(frame, channel, subscribed);
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("send", &Send);
   dict.SetMethod("sendSync", &SendSync);
+  dict.SetMethod("setChannelSubscribed", &SetChannelSubscribed);
+  dict.SetMethod("postPortMessage", &PostPortMessage);
+  dict.SetMethod("closePort", &ClosePort);
 }
 
 }  // namespace api
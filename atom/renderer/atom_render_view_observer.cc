@@ -12,13 +12,18 @@
 
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/event_emitter_caller.h"
+#include "atom/common/jank_monitor.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
 #include "atom/renderer/atom_renderer_client.h"
+#include "atom/renderer/memory_purger.h"
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/trace_event/trace_event.h"
+#include "content/common/view_messages.h"
 #include "content/public/renderer/render_view.h"
 #include "ipc/ipc_message_macros.h"
 #include "native_mate/dictionary.h"
@@ -36,6 +41,15 @@ namespace atom {
 
 namespace {
 
+// Internal channels of ipcRenderer used to deliver the events of message
+// ports.
+const char kPortMessageChannel[] = "ELECTRON_RENDERER_PORT_MESSAGE";
+const char kPortClosedChannel[] = "ELECTRON_RENDERER_PORT_CLOSED";
+
+// Internal channel of ipcRenderer telling whether the window is visible.
+const char kWindowVisibilityChannel[] =
+    "ELECTRON_RENDERER_WINDOW_VISIBILITY_CHANGE";
+
 bool GetIPCObject(v8::Isolate* isolate,
                   v8::Local<v8::Context> context,
                   v8::Local<v8::Object>* ipc) {
@@ -60,6 +74,52 @@ std::vector<v8::Local<v8::Value>> ListValueToVector(
   return result;
 }
 
+// Sends a report about the whole process, e.g. a janky task of the main
+// thread, to the WebContents of every view.
+template <typename Message>
+class ProcessReportSender : public content::RenderViewVisitor {
+ public:
+  explicit ProcessReportSender(const base::DictionaryValue& details)
+      : details_(details) {}
+
+  bool Visit(content::RenderView* render_view) override {
+    render_view->Send(new Message(render_view->GetRoutingID(), details_));
+    return true;
+  }
+
+ private:
+  const base::DictionaryValue& details_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProcessReportSender);
+};
+
+template <typename Message>
+void SendProcessReport(const base::DictionaryValue& details) {
+  ProcessReportSender<Message> sender(details);
+  content::RenderView::ForEach(&sender);
+}
+
+// Watches the main thread when --jank-threshold is set, created with the first
+// view and lives as long as the process.
+JankMonitor* g_jank_monitor = nullptr;
+
+// Applies the memory policies of the webPreferences, created with the first
+// view and lives as long as the process.
+MemoryPurger* g_memory_purger = nullptr;
+
+// The spare view is the first view of a spare renderer process, the views
+// opened later by its pages are not spares.
+bool g_spare_view_created = false;
+
+bool IsSpareView() {
+  if (g_spare_view_created ||
+      !base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kSpareRenderer))
+    return false;
+  g_spare_view_created = true;
+  return true;
+}
+
 base::StringPiece NetResourceProvider(int key) {
   if (key == IDR_DIR_HEADER_HTML) {
     base::StringPiece html_data =
@@ -76,13 +136,105 @@ AtomRenderViewObserver::AtomRenderViewObserver(
     content::RenderView* render_view,
     AtomRendererClient* renderer_client)
     : content::RenderViewObserver(render_view),
+      content::RenderViewObserverTracker<AtomRenderViewObserver>(render_view),
       renderer_client_(renderer_client),
-      document_created_(false) {
+      document_created_(false),
+      is_unclaimed_spare_(IsSpareView()),
+      window_hidden_(base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kHiddenPage)),
+      widget_hidden_(false) {
   // Initialise resource for directory listing.
   net::NetModule::SetResourceProvider(NetResourceProvider);
+
+  if (!g_jank_monitor)
+    g_jank_monitor = JankMonitor::CreateFromCommandLine(
+        blink::mainThreadIsolate(),
+        base::Bind(&SendProcessReport<AtomViewHostMsg_ReportJank>)).release();
+
+  if (!g_memory_purger)
+    g_memory_purger = MemoryPurger::CreateFromCommandLine(
+        blink::mainThreadIsolate(),
+        base::Bind(&SendProcessReport<AtomViewHostMsg_ReportMemoryPurge>))
+        .release();
+  if (g_memory_purger)
+    g_memory_purger->ViewCreated(!IsHidden());
 }
 
 AtomRenderViewObserver::~AtomRenderViewObserver() {
+  if (g_memory_purger)
+    g_memory_purger->ViewDestroyed(!IsHidden());
+}
+
+void AtomRenderViewObserver::SetChannelSubscribed(
+    blink::WebFrame* frame,
+    const base::string16& channel,
+    bool subscribed) {
+  std::set<base::string16>& channels = frame_subscriptions_[frame];
+  if (subscribed) {
+    if (channels.insert(channel).second)
+      UpdateSubscriptionCount(channel, 1);
+  } else {
+    if (channels.erase(channel) > 0)
+      UpdateSubscriptionCount(channel, -1);
+    if (channels.empty())
+      frame_subscriptions_.erase(frame);
+  }
+}
+
+void AtomRenderViewObserver::ClearChannelSubscriptions(blink::WebFrame* frame) {
+  auto it = frame_subscriptions_.find(frame);
+  if (it == frame_subscriptions_.end())
+    return;
+  for (const base::string16& channel : it->second)
+    UpdateSubscriptionCount(channel, -1);
+  frame_subscriptions_.erase(it);
+}
+
+void AtomRenderViewObserver::OnPortMessage(int port_id,
+                                           const base::ListValue& args) {
+  if (!document_created_ || !render_view()->GetWebView())
+    return;
+
+  base::ListValue list;
+  list.AppendInteger(port_id);
+  list.Append(args.CreateDeepCopy());
+  EmitIPCEvent(render_view()->GetWebView()->mainFrame(),
+               base::ASCIIToUTF16(kPortMessageChannel), list);
+}
+
+void AtomRenderViewObserver::OnPortClosed(int port_id) {
+  if (!document_created_ || !render_view()->GetWebView())
+    return;
+
+  base::ListValue list;
+  list.AppendInteger(port_id);
+  EmitIPCEvent(render_view()->GetWebView()->mainFrame(),
+               base::ASCIIToUTF16(kPortClosedChannel), list);
+}
+
+void AtomRenderViewObserver::OnClaimSpare() {
+  is_unclaimed_spare_ = false;
+}
+
+bool AtomRenderViewObserver::IsChannelSubscribed(
+    blink::WebFrame* frame, const base::string16& channel) const {
+  auto it = frame_subscriptions_.find(frame);
+  return it != frame_subscriptions_.end() &&
+         it->second.find(channel) != it->second.end();
+}
+
+void AtomRenderViewObserver::UpdateSubscriptionCount(
+    const base::string16& channel, int delta) {
+  int& count = subscription_counts_[channel];
+  count += delta;
+  if (count == 1 && delta > 0) {
+    Send(new AtomViewHostMsg_SetChannelSubscribed(routing_id(), channel,
+                                                  true));
+  } else if (count == 0) {
+    subscription_counts_.erase(channel);
+    Send(new AtomViewHostMsg_SetChannelSubscribed(routing_id(), channel,
+                                                  false));
+  }
 }
 
 void AtomRenderViewObserver::EmitIPCEvent(blink::WebFrame* frame,
@@ -148,6 +300,16 @@ bool AtomRenderViewObserver::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(AtomRenderViewObserver, message)
     IPC_MESSAGE_HANDLER(AtomViewMsg_Message, OnBrowserMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_PortMessage, OnPortMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_PortClosed, OnPortClosed)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_ClaimSpare, OnClaimSpare)
+    // The visibility of the widget is only observed.
+    IPC_MESSAGE_HANDLER_GENERIC(ViewMsg_WasHidden,
+                                SetHidden(window_hidden_, true);
+                                handled = false)
+    IPC_MESSAGE_HANDLER_GENERIC(ViewMsg_WasShown,
+                                SetHidden(window_hidden_, false);
+                                handled = false)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -161,6 +323,11 @@ void AtomRenderViewObserver::OnDestruct() {
 void AtomRenderViewObserver::OnBrowserMessage(bool send_to_all,
                                               const base::string16& channel,
                                               const base::ListValue& args) {
+  std::string visibility_state;
+  if (channel == base::ASCIIToUTF16(kWindowVisibilityChannel) &&
+      args.GetString(0, &visibility_state))
+    SetHidden(visibility_state != "visible", widget_hidden_);
+
   if (!document_created_)
     return;
 
@@ -171,14 +338,31 @@ void AtomRenderViewObserver::OnBrowserMessage(bool send_to_all,
   if (!frame || frame->isWebRemoteFrame())
     return;
 
-  EmitIPCEvent(frame, channel, args);
+  // Frames without listeners of the channel are skipped, so the arguments
+  // are not converted for nothing.
+  if (IsChannelSubscribed(frame, channel))
+    EmitIPCEvent(frame, channel, args);
 
   // Also send the message to all sub-frames.
   if (send_to_all) {
     for (blink::WebFrame* child = frame->firstChild(); child;
-         child = child->nextSibling())
-      EmitIPCEvent(child, channel, args);
+         child = child->nextSibling()) {
+      if (IsChannelSubscribed(child, channel))
+        EmitIPCEvent(child, channel, args);
+    }
   }
 }
 
+bool AtomRenderViewObserver::IsHidden() const {
+  return window_hidden_ || widget_hidden_;
+}
+
+void AtomRenderViewObserver::SetHidden(bool window_hidden, bool widget_hidden) {
+  bool was_hidden = IsHidden();
+  window_hidden_ = window_hidden;
+  widget_hidden_ = widget_hidden;
+  if (g_memory_purger && IsHidden() != was_hidden)
+    g_memory_purger->ViewVisibilityChanged(!IsHidden());
+}
+
 }  // namespace atom
@@ -5,8 +5,12 @@
 #ifndef ATOM_RENDERER_ATOM_RENDER_VIEW_OBSERVER_H_
 #define ATOM_RENDERER_ATOM_RENDER_VIEW_OBSERVER_H_
 
+#include <map>
+#include <set>
+
 #include "base/strings/string16.h"
 #include "content/public/renderer/render_view_observer.h"
+#include "content/public/renderer/render_view_observer_tracker.h"
 #include "third_party/WebKit/public/web/WebFrame.h"
 
 namespace base {
@@ -17,11 +21,28 @@ namespace atom {
 
 class AtomRendererClient;
 
-class AtomRenderViewObserver : public content::RenderViewObserver {
+class AtomRenderViewObserver
+    : public content::RenderViewObserver,
+      public content::RenderViewObserverTracker<AtomRenderViewObserver> {
  public:
   explicit AtomRenderViewObserver(content::RenderView* render_view,
                                   AtomRendererClient* renderer_client);
 
+  // Records whether the ipcRenderer of |frame| has listeners for |channel|,
+  // the browser is told when the first listener of the view is added or the
+  // last one is removed.
+  void SetChannelSubscribed(blink::WebFrame* frame,
+                            const base::string16& channel,
+                            bool subscribed);
+
+  // Removes all listeners of |frame|, called when its context is released.
+  void ClearChannelSubscriptions(blink::WebFrame* frame);
+
+  // Whether the view is the spare of a spare renderer process and has not been
+  // taken by a window yet, its pages set up neither node nor the preload
+  // script.
+  bool is_unclaimed_spare() const { return is_unclaimed_spare_; }
+
  protected:
   virtual ~AtomRenderViewObserver();
 
@@ -40,11 +61,36 @@ class AtomRenderViewObserver : public content::RenderViewObserver {
                         const base::string16& channel,
                         const base::ListValue& args);
 
+  void OnPortMessage(int port_id, const base::ListValue& args);
+  void OnPortClosed(int port_id);
+  void OnClaimSpare();
+
+  bool IsChannelSubscribed(blink::WebFrame* frame,
+                           const base::string16& channel) const;
+  void UpdateSubscriptionCount(const base::string16& channel, int delta);
+
+  // The view is hidden when either its window or its widget is hidden.
+  bool IsHidden() const;
+  void SetHidden(bool window_hidden, bool widget_hidden);
+
   AtomRendererClient* renderer_client_;
 
   // Whether the document object has been created.
   bool document_created_;
 
+  bool is_unclaimed_spare_;
+
+  // Whether the window is hidden or minimized, as told by the browser.
+  bool window_hidden_;
+  // Whether the widget has been hidden, e.g. when it is occluded.
+  bool widget_hidden_;
+
+  // The channels with listeners in each frame.
+  std::map<blink::WebFrame*, std::set<base::string16>> frame_subscriptions_;
+
+  // The number of frames listening to each channel.
+  std::map<base::string16, int> subscription_counts_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomRenderViewObserver);
 };
 
@@ -18,11 +18,14 @@
 #include "atom/common/options_switches.h"
 #include "atom/renderer/api/atom_api_renderer_ipc.h"
 #include "atom/renderer/atom_render_view_observer.h"
+#include "atom/renderer/content_script_injector.h"
 #include "atom/renderer/content_settings_observer.h"
 #include "atom/renderer/guest_view_container.h"
 #include "atom/renderer/node_array_buffer_bridge.h"
 #include "atom/renderer/preferences_manager.h"
+#include "atom/renderer/script_executor.h"
 #include "base/command_line.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "chrome/renderer/media/chrome_key_systems.h"
 #include "chrome/renderer/pepper/pepper_helper.h"
 #include "chrome/renderer/printing/print_web_view_helper.h"
@@ -44,6 +47,7 @@
 #include "third_party/WebKit/public/web/WebScriptSource.h"
 #include "third_party/WebKit/public/web/WebSecurityPolicy.h"
 #include "third_party/WebKit/public/web/WebView.h"
+#include "url/gurl.h"
 
 #if defined(OS_MACOSX)
 #include "base/mac/mac_util.h"
@@ -227,6 +231,7 @@ void AtomRendererClient::RenderThreadStarted() {
   OverrideNodeArrayBuffer();
 
   preferences_manager_.reset(new PreferencesManager);
+  content_script_injector_.reset(new ContentScriptInjector);
 
 #if defined(OS_WIN)
   // Set ApplicationUserModelID in renderer process.
@@ -257,6 +262,7 @@ void AtomRendererClient::RenderFrameCreated(
   new PepperHelper(render_frame);
   new AtomRenderFrameObserver(render_frame, this);
   new ContentSettingsObserver(render_frame);
+  new ScriptExecutor(render_frame);
 
   // Allow file scheme to handle service worker by default.
   // FIXME(zcbenz): Can this be moved elsewhere?
@@ -304,6 +310,8 @@ void AtomRendererClient::RunScriptsAtDocumentStart(
     v8::HandleScope handle_scope(env->isolate());
     mate::EmitEvent(env->isolate(), env->process_object(), "document-start");
   }
+
+  InjectContentScripts(render_frame, ContentScriptInjector::DOCUMENT_START);
 }
 
 void AtomRendererClient::RunScriptsAtDocumentEnd(
@@ -314,6 +322,40 @@ void AtomRendererClient::RunScriptsAtDocumentEnd(
     v8::HandleScope handle_scope(env->isolate());
     mate::EmitEvent(env->isolate(), env->process_object(), "document-end");
   }
+
+  InjectContentScripts(render_frame, ContentScriptInjector::DOCUMENT_END);
+
+  // The document_idle scripts run after the tasks of document end, the frame
+  // may have gone by then.
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&AtomRendererClient::RunScriptsAtDocumentIdle,
+                 base::Unretained(this), render_frame->GetRoutingID()));
+}
+
+void AtomRendererClient::RunScriptsAtDocumentIdle(int render_frame_id) {
+  content::RenderFrame* render_frame =
+      content::RenderFrame::FromRoutingID(render_frame_id);
+  if (render_frame)
+    InjectContentScripts(render_frame, ContentScriptInjector::DOCUMENT_IDLE);
+}
+
+void AtomRendererClient::InjectContentScripts(
+    content::RenderFrame* render_frame,
+    ContentScriptInjector::RunAt run_at) {
+  // Content scripts get the chrome API from the node environment, which only
+  // the main frame has.
+  if (!render_frame->IsMainFrame())
+    return;
+
+  blink::WebLocalFrame* frame = render_frame->GetWebFrame();
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> context = GetContext(frame, isolate);
+  if (!node::Environment::GetCurrent(context))
+    return;
+  content_script_injector_->InjectScripts(
+      context, frame->document().url(), run_at);
 }
 
 blink::WebSpeechSynthesizer* AtomRendererClient::OverrideSpeechSynthesizer(
@@ -342,6 +384,11 @@ void AtomRendererClient::DidCreateScriptContext(
   if (!render_frame->IsMainFrame() && !IsDevToolsExtension(render_frame))
     return;
 
+  // The node environment is set up for the page loaded after the spare is
+  // taken.
+  if (IsUnclaimedSpare(render_frame))
+    return;
+
   // Whether the node binding has been initialized.
   bool first_time = node_bindings_->uv_env() == nullptr;
 
@@ -371,6 +418,15 @@ void AtomRendererClient::DidCreateScriptContext(
   }
 }
 
+// static
+bool AtomRendererClient::IsUnclaimedSpare(
+    content::RenderFrame* render_frame) {
+  if (!render_frame->IsMainFrame())
+    return false;
+  auto observer = AtomRenderViewObserver::Get(render_frame->GetRenderView());
+  return observer && observer->is_unclaimed_spare();
+}
+
 void AtomRendererClient::WillReleaseScriptContext(
     v8::Handle<v8::Context> context, content::RenderFrame* render_frame) {
   // Only allow node integration for the main frame, unless it is a devtools
@@ -381,6 +437,10 @@ void AtomRendererClient::WillReleaseScriptContext(
   node::Environment* env = node::Environment::GetCurrent(context);
   if (env)
     mate::EmitEvent(env->isolate(), env->process_object(), "exit");
+
+  auto observer = AtomRenderViewObserver::Get(render_frame->GetRenderView());
+  if (observer)
+    observer->ClearChannelSubscriptions(render_frame->GetWebFrame());
 }
 
 bool AtomRendererClient::ShouldFork(blink::WebLocalFrame* frame,
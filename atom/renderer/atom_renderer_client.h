@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "atom/renderer/content_script_injector.h"
 #include "content/public/renderer/content_renderer_client.h"
 
 namespace atom {
@@ -27,6 +28,10 @@ class AtomRendererClient : public content::ContentRendererClient {
   void WillReleaseScriptContext(
       v8::Handle<v8::Context> context, content::RenderFrame* render_frame);
 
+  // Whether |render_frame| is the main frame of a spare view that no window
+  // has taken yet, which sets up neither node nor the preload script.
+  static bool IsUnclaimedSpare(content::RenderFrame* render_frame);
+
   // Get the context that the Electron API is running in.
   v8::Local<v8::Context> GetContext(
       blink::WebFrame* frame, v8::Isolate* isolate);
@@ -66,9 +71,14 @@ class AtomRendererClient : public content::ContentRendererClient {
       std::vector<std::unique_ptr<::media::KeySystemProperties>>* key_systems)
       override;
 
+  void RunScriptsAtDocumentIdle(int render_frame_id);
+  void InjectContentScripts(content::RenderFrame* render_frame,
+                            ContentScriptInjector::RunAt run_at);
+
   std::unique_ptr<NodeBindings> node_bindings_;
   std::unique_ptr<AtomBindings> atom_bindings_;
   std::unique_ptr<PreferencesManager> preferences_manager_;
+  std::unique_ptr<ContentScriptInjector> content_script_injector_;
   bool isolated_world_;
 
   DISALLOW_COPY_AND_ASSIGN(AtomRendererClient);
@@ -9,15 +9,19 @@
 #include "atom_natives.h"  // NOLINT: This file is generated with js2c
 
 #include "atom/common/api/api_messages.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/options_switches.h"
 #include "atom/renderer/api/atom_api_renderer_ipc.h"
 #include "atom/renderer/atom_render_view_observer.h"
+#include "atom/renderer/atom_renderer_client.h"
+#include "atom/renderer/script_executor.h"
 #include "base/command_line.h"
 #include "chrome/renderer/printing/print_web_view_helper.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
+#include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
 #include "content/public/renderer/render_view_observer.h"
 #include "ipc/ipc_message_macros.h"
@@ -33,6 +37,51 @@ namespace {
 
 const std::string kBindingKey = "binding";
 
+// Compiles and runs |source|. The code cache in |code_cache| is used when it
+// is not empty, otherwise a new code cache is written to it and |produced| is
+// set to true.
+v8::MaybeLocal<v8::Value> RunScriptWithCodeCache(
+    v8::Handle<v8::Context> context,
+    const std::string& source,
+    const std::string& name,
+    std::string* code_cache,
+    bool* produced) {
+  auto isolate = context->GetIsolate();
+  *produced = false;
+
+  // The CachedData is owned by |script_source|, but not the buffer.
+  v8::ScriptCompiler::CachedData* cached_data = nullptr;
+  if (!code_cache->empty()) {
+    cached_data = new v8::ScriptCompiler::CachedData(
+        reinterpret_cast<const uint8_t*>(code_cache->data()),
+        code_cache->size());
+  }
+  v8::ScriptOrigin origin(mate::StringToV8(isolate, name));
+  v8::ScriptCompiler::Source script_source(
+      mate::StringToV8(isolate, source), origin, cached_data);
+  auto options = cached_data ? v8::ScriptCompiler::kConsumeCodeCache
+                             : v8::ScriptCompiler::kProduceCodeCache;
+
+  v8::Local<v8::Script> script;
+  if (!v8::ScriptCompiler::Compile(context, &script_source, options)
+          .ToLocal(&script))
+    return v8::MaybeLocal<v8::Value>();
+
+  const v8::ScriptCompiler::CachedData* data = script_source.GetCachedData();
+  if (options == v8::ScriptCompiler::kProduceCodeCache) {
+    if (data && data->length > 0) {
+      code_cache->assign(reinterpret_cast<const char*>(data->data),
+                         data->length);
+      *produced = true;
+    }
+  } else if (data && data->rejected) {
+    // Produce a new one next time.
+    code_cache->clear();
+  }
+
+  return script->Run(context);
+}
+
 class AtomSandboxedRenderFrameObserver : public content::RenderFrameObserver {
  public:
   AtomSandboxedRenderFrameObserver(content::RenderFrame* frame,
@@ -114,7 +163,9 @@ class AtomSandboxedRenderViewObserver : public AtomRenderViewObserver {
 }  // namespace
 
 
-AtomSandboxedRendererClient::AtomSandboxedRendererClient() {
+AtomSandboxedRendererClient::AtomSandboxedRendererClient()
+    : preload_loaded_(false),
+      preload_found_(false) {
 }
 
 AtomSandboxedRendererClient::~AtomSandboxedRendererClient() {
@@ -123,6 +174,7 @@ AtomSandboxedRendererClient::~AtomSandboxedRendererClient() {
 void AtomSandboxedRendererClient::RenderFrameCreated(
     content::RenderFrame* render_frame) {
   new AtomSandboxedRenderFrameObserver(render_frame, this);
+  new ScriptExecutor(render_frame);
 }
 
 void AtomSandboxedRendererClient::RenderViewCreated(
@@ -133,50 +185,92 @@ void AtomSandboxedRendererClient::RenderViewCreated(
 
 void AtomSandboxedRendererClient::DidCreateScriptContext(
     v8::Handle<v8::Context> context, content::RenderFrame* render_frame) {
+  if (AtomRendererClient::IsUnclaimedSpare(render_frame))
+    return;
+
   base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
-  std::string preload_script = command_line->GetSwitchValueASCII(
+  base::FilePath preload_path = command_line->GetSwitchValuePath(
       switches::kPreloadScript);
-  if (preload_script.empty())
+  if (preload_path.empty())
     return;
 
   auto isolate = context->GetIsolate();
   v8::HandleScope handle_scope(isolate);
   v8::Context::Scope context_scope(context);
-  // Wrap the bundle into a function that receives the binding object and the
-  // preload script path as arguments.
-  std::string preload_bundle_native(node::preload_bundle_data,
-      node::preload_bundle_data + sizeof(node::preload_bundle_data));
-  std::stringstream ss;
-  ss << "(function(binding, preloadPath) {\n";
-  ss << preload_bundle_native << "\n";
-  ss << "})";
-  std::string preload_wrapper = ss.str();
+  // Wrap the bundle into a function that receives the binding object, the
+  // preload script path and the preload function as arguments.
+  if (bundle_wrapper_.empty()) {
+    std::string preload_bundle_native(node::preload_bundle_data,
+        node::preload_bundle_data + sizeof(node::preload_bundle_data));
+    std::stringstream ss;
+    ss << "(function(binding, preloadPath, preloadFn) {\n";
+    ss << preload_bundle_native << "\n";
+    ss << "})";
+    bundle_wrapper_ = ss.str();
+  }
   // Compile the wrapper and run it to get the function object
-  auto script = v8::Script::Compile(
-      mate::ConvertToV8(isolate, preload_wrapper)->ToString());
+  bool produced;
   auto func = v8::Handle<v8::Function>::Cast(
-      script->Run(context).ToLocalChecked());
+      RunScriptWithCodeCache(context, bundle_wrapper_, "preload_bundle.js",
+                             &bundle_code_cache_, &produced)
+          .ToLocalChecked());
   // Create and initialize the binding object
   auto binding = v8::Object::New(isolate);
   api::Initialize(binding, v8::Null(isolate), context, nullptr);
   v8::Local<v8::Value> args[] = {
     binding,
-    mate::ConvertToV8(isolate, preload_script)
+    mate::ConvertToV8(isolate, preload_path),
+    GetPreloadFunction(context, preload_path),
   };
   // Execute the function with proper arguments
-  ignore_result(func->Call(context, v8::Null(isolate), 2, args));
+  ignore_result(func->Call(context, v8::Null(isolate), 3, args));
   // Store the bindingt privately for handling messages from the main process.
   auto binding_key = mate::ConvertToV8(isolate, kBindingKey)->ToString();
   auto private_binding_key = v8::Private::ForApi(isolate, binding_key);
   context->Global()->SetPrivate(context, private_binding_key, binding);
 }
 
+v8::Local<v8::Value> AtomSandboxedRendererClient::GetPreloadFunction(
+    v8::Handle<v8::Context> context, const base::FilePath& preload_path) {
+  auto isolate = context->GetIsolate();
+  // The source is read by the browser once per process, the code cache is
+  // produced by the first context and only reused inside this process.
+  if (!preload_loaded_) {
+    std::string source;
+    content::RenderThread::Get()->Send(new AtomHostMsg_ReadPreloadScript(
+        preload_path, &preload_found_, &source));
+    preload_loaded_ = true;
+    // Wrap the source into a function receives a `require` function as
+    // argument, see lib/sandboxed_renderer/init.js.
+    preload_wrapper_ = "(function(require, process, Buffer, global) {\n" +
+                       source + "\n})";
+  }
+
+  if (!preload_found_) {
+    return v8::Exception::Error(mate::StringToV8(
+        isolate, "Unable to read " + preload_path.AsUTF8Unsafe()));
+  }
+
+  v8::TryCatch try_catch(isolate);
+  bool produced;
+  v8::Local<v8::Value> func;
+  if (!RunScriptWithCodeCache(context, preload_wrapper_,
+                              preload_path.AsUTF8Unsafe(),
+                              &preload_code_cache_, &produced).ToLocal(&func))
+    return try_catch.Exception();
+  return func;
+}
+
 void AtomSandboxedRendererClient::WillReleaseScriptContext(
     v8::Handle<v8::Context> context, content::RenderFrame* render_frame) {
   auto isolate = context->GetIsolate();
   v8::HandleScope handle_scope(isolate);
   v8::Context::Scope context_scope(context);
   InvokeBindingCallback(context, "onExit", std::vector<v8::Local<v8::Value>>());
+
+  auto observer = AtomRenderViewObserver::Get(render_frame->GetRenderView());
+  if (observer)
+    observer->ClearChannelSubscriptions(render_frame->GetWebFrame());
 }
 
 void AtomSandboxedRendererClient::InvokeBindingCallback(
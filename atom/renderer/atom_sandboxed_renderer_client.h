@@ -10,6 +10,10 @@
 #include "content/public/renderer/content_renderer_client.h"
 #include "content/public/renderer/render_frame.h"
 
+namespace base {
+class FilePath;
+}
+
 namespace atom {
 
 class AtomSandboxedRendererClient : public content::ContentRendererClient {
@@ -29,6 +33,21 @@ class AtomSandboxedRendererClient : public content::ContentRendererClient {
   void RenderViewCreated(content::RenderView*) override;
 
  private:
+  // Returns the function wrapping the preload script, or the exception thrown
+  // while reading or compiling it.
+  v8::Local<v8::Value> GetPreloadFunction(v8::Handle<v8::Context> context,
+                                          const base::FilePath& preload_path);
+
+  // The wrapper of the preload bundle and its V8 code cache.
+  std::string bundle_wrapper_;
+  std::string bundle_code_cache_;
+
+  // The wrapper of the preload script and its V8 code cache.
+  bool preload_loaded_;
+  bool preload_found_;
+  std::string preload_wrapper_;
+  std::string preload_code_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomSandboxedRendererClient);
 };
 
@@ -0,0 +1,333 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/content_script_injector.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "base/memory/shared_memory.h"
+#include "base/pickle.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "content/public/renderer/render_thread.h"
+#include "extensions/common/url_pattern.h"
+#include "ipc/ipc_message_macros.h"
+#include "native_mate/converter.h"
+#include "third_party/WebKit/public/web/WebConsoleMessage.h"
+#include "third_party/WebKit/public/web/WebLocalFrame.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+// The key of the function returning the chrome API of an extension, which is
+// set on the global object by content-scripts-injector.js.
+const char kChromeKey[] = "contentScriptChrome";
+
+struct ContentScriptFile {
+  GURL url;
+  // Points into the shared memory.
+  base::StringPiece code;
+  bool is_ascii;
+  std::string code_cache;
+};
+
+struct ContentScript {
+  std::string extension_id;
+  ContentScriptInjector::RunAt run_at;
+  std::vector<extensions::URLPattern> patterns;
+  std::vector<ContentScriptFile> files;
+};
+
+ContentScriptInjector::RunAt ParseRunAt(const std::string& run_at) {
+  if (run_at == "document_start")
+    return ContentScriptInjector::DOCUMENT_START;
+  if (run_at == "document_end")
+    return ContentScriptInjector::DOCUMENT_END;
+  return ContentScriptInjector::DOCUMENT_IDLE;
+}
+
+bool MatchesURL(const ContentScript& script, const GURL& url) {
+  for (const auto& pattern : script.patterns) {
+    if (pattern.MatchesURL(url))
+      return true;
+  }
+  return false;
+}
+
+// Reports the error caught by |try_catch| to the console of the page, with the
+// location in the script at |url| that threw it.
+void ReportError(v8::Local<v8::Context> context,
+                 const GURL& url,
+                 const v8::TryCatch& try_catch) {
+  blink::WebLocalFrame* frame = blink::WebLocalFrame::frameForContext(context);
+  if (!frame)
+    return;
+  std::string error = try_catch.HasCaught() ?
+      mate::V8ToString(try_catch.Exception()) : "Script failed";
+  blink::WebConsoleMessage message(
+      blink::WebConsoleMessage::LevelError,
+      blink::WebString::fromUTF8(
+          "Error in content script " + url.spec() + ": " + error));
+  message.url = blink::WebString::fromUTF8(url.spec());
+  v8::Local<v8::Message> v8_message = try_catch.Message();
+  if (!v8_message.IsEmpty()) {
+    message.lineNumber = v8_message->GetLineNumber(context).FromMaybe(0);
+    message.columnNumber =
+        v8_message->GetStartColumn(context).FromMaybe(0) + 1;
+  }
+  frame->addMessageToConsole(message);
+}
+
+}  // namespace
+
+// The content scripts parsed from the shared memory, which stays mapped until
+// V8 has released every source in it.
+class ContentScriptSet : public base::RefCountedThreadSafe<ContentScriptSet> {
+ public:
+  explicit ContentScriptSet(std::unique_ptr<base::SharedMemory> shared_memory)
+      : shared_memory_(std::move(shared_memory)) {}
+
+  // See RenderProcessPreferences::UpdateCache for the format.
+  bool Parse(uint32_t size) {
+    base::Pickle pickle(static_cast<const char*>(shared_memory_->memory()),
+                        size);
+    base::PickleIterator iter(pickle);
+    uint32_t entries;
+    if (!iter.ReadUInt32(&entries))
+      return false;
+    for (uint32_t i = 0; i < entries; ++i) {
+      std::string extension_id;
+      uint32_t script_count;
+      if (!iter.ReadString(&extension_id) || !iter.ReadUInt32(&script_count))
+        return false;
+      for (uint32_t j = 0; j < script_count; ++j) {
+        ContentScript script;
+        script.extension_id = extension_id;
+        if (!ParseScript(&iter, &script))
+          return false;
+        scripts_.push_back(std::move(script));
+      }
+    }
+    return true;
+  }
+
+  std::vector<ContentScript>& scripts() { return scripts_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<ContentScriptSet>;
+
+  ~ContentScriptSet() {}
+
+  bool ParseScript(base::PickleIterator* iter, ContentScript* script) {
+    std::string run_at;
+    uint32_t match_count;
+    if (!iter->ReadString(&run_at) || !iter->ReadUInt32(&match_count))
+      return false;
+    script->run_at = ParseRunAt(run_at);
+
+    for (uint32_t i = 0; i < match_count; ++i) {
+      std::string match;
+      if (!iter->ReadString(&match))
+        return false;
+      extensions::URLPattern pattern(extensions::URLPattern::SCHEME_ALL);
+      if (pattern.Parse(match) != extensions::URLPattern::PARSE_SUCCESS) {
+        LOG(WARNING) << "Invalid match pattern " << match << " of extension "
+                     << script->extension_id;
+        continue;
+      }
+      script->patterns.push_back(pattern);
+    }
+
+    uint32_t file_count;
+    if (!iter->ReadUInt32(&file_count))
+      return false;
+    for (uint32_t i = 0; i < file_count; ++i) {
+      ContentScriptFile file;
+      std::string url;
+      if (!iter->ReadString(&url) || !iter->ReadStringPiece(&file.code))
+        return false;
+      file.url = GURL(url);
+      file.is_ascii = base::IsStringASCII(file.code);
+      script->files.push_back(std::move(file));
+    }
+    return true;
+  }
+
+  std::unique_ptr<base::SharedMemory> shared_memory_;
+  std::vector<ContentScript> scripts_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentScriptSet);
+};
+
+namespace {
+
+// Hands a source in the shared memory to V8 without copying it.
+class SharedSourceResource
+    : public v8::String::ExternalOneByteStringResource {
+ public:
+  SharedSourceResource(scoped_refptr<ContentScriptSet> script_set,
+                       base::StringPiece source)
+      : script_set_(script_set), source_(source) {}
+
+  const char* data() const override { return source_.data(); }
+  size_t length() const override { return source_.size(); }
+
+ private:
+  scoped_refptr<ContentScriptSet> script_set_;
+  base::StringPiece source_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedSourceResource);
+};
+
+// Compiles |file| into a function receiving the chrome API, using and
+// updating its code cache.
+bool CompileFile(v8::Local<v8::Context> context,
+                 scoped_refptr<ContentScriptSet> script_set,
+                 ContentScriptFile* file,
+                 v8::Local<v8::Function>* function) {
+  v8::Isolate* isolate = context->GetIsolate();
+  v8::Local<v8::String> code;
+  if (file->is_ascii) {
+    auto* resource = new SharedSourceResource(script_set, file->code);
+    if (!v8::String::NewExternalOneByte(isolate, resource).ToLocal(&code)) {
+      delete resource;
+      return false;
+    }
+  } else {
+    code = mate::StringToV8(isolate, file->code);
+  }
+
+  // The wrapper ends its first line so the line numbers of the script are
+  // kept with the -1 line offset.
+  v8::Local<v8::String> source = v8::String::Concat(
+      v8::String::Concat(mate::StringToV8(isolate, "(function (chrome) {\n"),
+                         code),
+      mate::StringToV8(isolate, "\n})"));
+  v8::ScriptOrigin origin(mate::StringToV8(isolate, file->url.spec()),
+                          v8::Integer::New(isolate, -1));
+
+  // The CachedData is owned by |script_source|, but not the buffer.
+  v8::ScriptCompiler::CachedData* cached_data = nullptr;
+  if (!file->code_cache.empty()) {
+    cached_data = new v8::ScriptCompiler::CachedData(
+        reinterpret_cast<const uint8_t*>(file->code_cache.data()),
+        file->code_cache.size());
+  }
+  v8::ScriptCompiler::Source script_source(source, origin, cached_data);
+  auto options = cached_data ? v8::ScriptCompiler::kConsumeCodeCache
+                             : v8::ScriptCompiler::kProduceCodeCache;
+
+  v8::Local<v8::Script> script;
+  if (!v8::ScriptCompiler::Compile(context, &script_source, options)
+          .ToLocal(&script))
+    return false;
+
+  const v8::ScriptCompiler::CachedData* data = script_source.GetCachedData();
+  if (options == v8::ScriptCompiler::kProduceCodeCache) {
+    if (data && data->length > 0)
+      file->code_cache.assign(reinterpret_cast<const char*>(data->data),
+                              data->length);
+  } else if (data && data->rejected) {
+    // Produce a new one next time.
+    file->code_cache.clear();
+  }
+
+  v8::Local<v8::Value> result;
+  if (!script->Run(context).ToLocal(&result) || !result->IsFunction())
+    return false;
+  *function = result.As<v8::Function>();
+  return true;
+}
+
+}  // namespace
+
+ContentScriptInjector::ContentScriptInjector() {
+  content::RenderThread::Get()->AddObserver(this);
+}
+
+ContentScriptInjector::~ContentScriptInjector() {
+}
+
+void ContentScriptInjector::InjectScripts(v8::Local<v8::Context> context,
+                                          const GURL& url,
+                                          RunAt run_at) {
+  if (!script_set_)
+    return;
+
+  v8::Isolate* isolate = context->GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context);
+
+  v8::Local<v8::Private> key =
+      v8::Private::ForApi(isolate, mate::StringToV8(isolate, kChromeKey));
+  v8::Local<v8::Value> value;
+  if (!context->Global()->GetPrivate(context, key).ToLocal(&value) ||
+      !value->IsFunction())
+    return;
+  v8::Local<v8::Function> get_chrome = value.As<v8::Function>();
+
+  // A script may cause an update of the scripts while running.
+  scoped_refptr<ContentScriptSet> script_set = script_set_;
+  for (auto& script : script_set->scripts()) {
+    if (script.run_at != run_at || !MatchesURL(script, url))
+      continue;
+
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::Value> args[] = {
+      mate::StringToV8(isolate, script.extension_id),
+    };
+    v8::Local<v8::Value> chrome;
+    if (!get_chrome->Call(context, v8::Undefined(isolate), 1, args)
+            .ToLocal(&chrome)) {
+      ReportError(context, GURL("chrome-extension://" + script.extension_id),
+                  try_catch);
+      continue;
+    }
+
+    // A script that fails to compile or throws does not stop the others.
+    for (auto& file : script.files) {
+      try_catch.Reset();
+      v8::Local<v8::Function> function;
+      v8::Local<v8::Value> argv[] = { chrome };
+      if (!CompileFile(context, script_set, &file, &function) ||
+          function->Call(context, context->Global(), 1, argv).IsEmpty())
+        ReportError(context, file.url, try_catch);
+    }
+  }
+}
+
+bool ContentScriptInjector::OnControlMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(ContentScriptInjector, message)
+    IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentScripts, OnUpdateContentScripts)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void ContentScriptInjector::OnUpdateContentScripts(
+    base::SharedMemoryHandle shared_memory_handle,
+    uint32_t size) {
+  std::unique_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(shared_memory_handle, true));
+  if (!shared_memory->Map(size))
+    return;
+
+  scoped_refptr<ContentScriptSet> script_set(
+      new ContentScriptSet(std::move(shared_memory)));
+  if (!script_set->Parse(size)) {
+    LOG(ERROR) << "Failed to parse content scripts";
+    return;
+  }
+  script_set_ = script_set;
+}
+
+}  // namespace atom
@@ -0,0 +1,61 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_CONTENT_SCRIPT_INJECTOR_H_
+#define ATOM_RENDERER_CONTENT_SCRIPT_INJECTOR_H_
+
+#include <stdint.h>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/shared_memory_handle.h"
+#include "content/public/renderer/render_thread_observer.h"
+#include "v8/include/v8.h"
+
+class GURL;
+
+namespace atom {
+
+class ContentScriptSet;
+
+// Runs the content scripts of extensions in pages.
+//
+// The scripts are read from the read-only shared memory sent by
+// RenderProcessPreferences, and their sources are handed to V8 without being
+// copied out of it. The match patterns are compiled once per process, and each
+// script keeps a V8 code cache for the later pages of the process.
+// Scripts that fail to compile or throw are reported to the console of the
+// page with their URLs.
+class ContentScriptInjector : public content::RenderThreadObserver {
+ public:
+  enum RunAt {
+    DOCUMENT_START,
+    DOCUMENT_END,
+    DOCUMENT_IDLE,
+  };
+
+  ContentScriptInjector();
+  ~ContentScriptInjector() override;
+
+  // Runs the scripts of |run_at| whose patterns match |url| in |context|. The
+  // context must have set the function returning the chrome API of an
+  // extension, pages that have not are left alone.
+  void InjectScripts(v8::Local<v8::Context> context,
+                     const GURL& url,
+                     RunAt run_at);
+
+ private:
+  // content::RenderThreadObserver:
+  bool OnControlMessageReceived(const IPC::Message& message) override;
+
+  void OnUpdateContentScripts(base::SharedMemoryHandle shared_memory,
+                              uint32_t size);
+
+  scoped_refptr<ContentScriptSet> script_set_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentScriptInjector);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_CONTENT_SCRIPT_INJECTOR_H_
@@ -0,0 +1,199 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/memory_purger.h"
+
+#include <algorithm>
+
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ptr_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/values.h"
+#include "third_party/WebKit/public/web/WebCache.h"
+
+namespace atom {
+
+namespace {
+
+const size_t kBytesPerMegabyte = 1024 * 1024;
+
+// The minimum interval between two purges for the heap limit.
+const int kMinHeapPurgeIntervalSeconds = 30;
+
+// There is at most one purger per process, it is only accessed in main thread.
+MemoryPurger* g_memory_purger = nullptr;
+
+int GetPositiveSwitch(const base::CommandLine* command_line,
+                      const char* name) {
+  int value;
+  if (!base::StringToInt(command_line->GetSwitchValueASCII(name), &value) ||
+      value <= 0)
+    return 0;
+  return value;
+}
+
+double Reclaimed(size_t before, size_t after) {
+  return before > after ? static_cast<double>(before - after) : 0;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<MemoryPurger> MemoryPurger::CreateFromCommandLine(
+    v8::Isolate* isolate, const ReportCallback& callback) {
+  auto command_line = base::CommandLine::ForCurrentProcess();
+  int cache_capacity =
+      GetPositiveSwitch(command_line, switches::kMemoryCacheCapacity);
+  int heap_soft_limit =
+      GetPositiveSwitch(command_line, switches::kV8HeapSoftLimit);
+  int hidden_delay =
+      GetPositiveSwitch(command_line, switches::kPurgeMemoryWhenHidden);
+  if (!cache_capacity && !heap_soft_limit && !hidden_delay)
+    return nullptr;
+  return base::MakeUnique<MemoryPurger>(
+      isolate,
+      cache_capacity * kBytesPerMegabyte,
+      heap_soft_limit * kBytesPerMegabyte,
+      base::TimeDelta::FromMilliseconds(hidden_delay),
+      callback);
+}
+
+MemoryPurger::MemoryPurger(v8::Isolate* isolate,
+                           size_t cache_capacity,
+                           size_t heap_soft_limit,
+                           base::TimeDelta hidden_delay,
+                           const ReportCallback& callback)
+    : isolate_(isolate),
+      heap_soft_limit_(heap_soft_limit),
+      hidden_delay_(hidden_delay),
+      callback_(callback),
+      visible_views_(0),
+      purged_while_hidden_(false),
+      heap_purge_pending_(false),
+      weak_factory_(this) {
+  DCHECK(!g_memory_purger);
+  g_memory_purger = this;
+
+  if (cache_capacity)
+    blink::WebCache::setCapacity(cache_capacity);
+  if (heap_soft_limit_)
+    isolate_->AddGCEpilogueCallback(&MemoryPurger::OnGCEpilogue,
+                                    v8::kGCTypeMarkSweepCompact);
+}
+
+MemoryPurger::~MemoryPurger() {
+  if (heap_soft_limit_)
+    isolate_->RemoveGCEpilogueCallback(&MemoryPurger::OnGCEpilogue);
+  g_memory_purger = nullptr;
+}
+
+void MemoryPurger::ViewCreated(bool visible) {
+  if (visible)
+    ++visible_views_;
+  UpdateHiddenTimer();
+}
+
+void MemoryPurger::ViewVisibilityChanged(bool visible) {
+  visible_views_ += visible ? 1 : -1;
+  DCHECK_GE(visible_views_, 0);
+  UpdateHiddenTimer();
+}
+
+void MemoryPurger::ViewDestroyed(bool visible) {
+  if (visible)
+    --visible_views_;
+  UpdateHiddenTimer();
+}
+
+void MemoryPurger::Purge(const std::string& reason) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  v8::HeapStatistics heap_before, heap_after;
+  blink::WebCache::UsageStats cache_before, cache_after;
+  isolate_->GetHeapStatistics(&heap_before);
+  blink::WebCache::getUsageStats(&cache_before);
+
+  blink::WebCache::clear();
+  // The listeners of Blink and V8 release their caches in later tasks, which
+  // are not counted in the reclaimed sizes.
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  isolate_->LowMemoryNotification();
+
+  isolate_->GetHeapStatistics(&heap_after);
+  blink::WebCache::getUsageStats(&cache_after);
+
+  size_t cache_size_before = cache_before.liveSize + cache_before.deadSize;
+  size_t cache_size_after = cache_after.liveSize + cache_after.deadSize;
+  base::DictionaryValue details;
+  details.SetString("reason", reason);
+  details.SetDouble("duration",
+                    (base::TimeTicks::Now() - start).InMillisecondsF());
+  details.SetDouble("v8HeapSize",
+                    static_cast<double>(heap_after.used_heap_size()));
+  details.SetDouble("v8HeapReclaimed",
+                    Reclaimed(heap_before.used_heap_size(),
+                              heap_after.used_heap_size()));
+  details.SetDouble("memoryCacheSize", static_cast<double>(cache_size_after));
+  details.SetDouble("memoryCacheReclaimed",
+                    Reclaimed(cache_size_before, cache_size_after));
+  callback_.Run(details);
+}
+
+void MemoryPurger::UpdateHiddenTimer() {
+  if (visible_views_ > 0) {
+    purged_while_hidden_ = false;
+    hidden_timer_.Stop();
+  } else if (!hidden_delay_.is_zero() && !purged_while_hidden_ &&
+             !hidden_timer_.IsRunning()) {
+    hidden_timer_.Start(FROM_HERE, hidden_delay_,
+                        base::Bind(&MemoryPurger::OnHiddenTimeout,
+                                   base::Unretained(this)));
+  }
+}
+
+void MemoryPurger::OnHiddenTimeout() {
+  purged_while_hidden_ = true;
+  Purge("hidden");
+}
+
+// static
+void MemoryPurger::OnGCEpilogue(v8::Isolate* isolate,
+                                v8::GCType type,
+                                v8::GCCallbackFlags flags) {
+  if (g_memory_purger && g_memory_purger->isolate_ == isolate)
+    g_memory_purger->CheckHeapSize();
+}
+
+void MemoryPurger::CheckHeapSize() {
+  if (heap_purge_pending_)
+    return;
+  if (!last_heap_purge_.is_null() &&
+      base::TimeTicks::Now() - last_heap_purge_ <
+          base::TimeDelta::FromSeconds(kMinHeapPurgeIntervalSeconds))
+    return;
+
+  v8::HeapStatistics heap;
+  isolate_->GetHeapStatistics(&heap);
+  if (heap.used_heap_size() <= heap_soft_limit_)
+    return;
+
+  // A GC can not be started inside the callback of another one.
+  heap_purge_pending_ = true;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&MemoryPurger::OnHeapLimitExceeded,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void MemoryPurger::OnHeapLimitExceeded() {
+  Purge("v8-heap-limit");
+  heap_purge_pending_ = false;
+  last_heap_purge_ = base::TimeTicks::Now();
+}
+
+}  // namespace atom
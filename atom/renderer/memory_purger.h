@@ -0,0 +1,92 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_MEMORY_PURGER_H_
+#define ATOM_RENDERER_MEMORY_PURGER_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "v8/include/v8.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace atom {
+
+// Applies the memory policies of the renderer process set by the
+// webPreferences: the capacity of Blink's memory cache, a soft limit of the V8
+// heap, and purging the memory once all pages have been hidden for a while.
+//
+// Purging runs a full GC, empties the memory cache and tells Blink that the
+// memory is critical, then reports how much the V8 heap and the memory cache
+// have shrunk.
+class MemoryPurger {
+ public:
+  // Called in main thread after each purge.
+  using ReportCallback = base::Callback<void(const base::DictionaryValue&)>;
+
+  // Returns null unless one of the memory switches is set, must be called in
+  // main thread after its message loop has been created.
+  static std::unique_ptr<MemoryPurger> CreateFromCommandLine(
+      v8::Isolate* isolate, const ReportCallback& callback);
+
+  // A zero |cache_capacity| or |heap_soft_limit| leaves it unchanged, and a
+  // zero |hidden_delay| never purges hidden pages.
+  MemoryPurger(v8::Isolate* isolate,
+               size_t cache_capacity,
+               size_t heap_soft_limit,
+               base::TimeDelta hidden_delay,
+               const ReportCallback& callback);
+  ~MemoryPurger();
+
+  // Tracks the visibility of the pages of the process.
+  void ViewCreated(bool visible);
+  void ViewVisibilityChanged(bool visible);
+  void ViewDestroyed(bool visible);
+
+  // Purges the memory now, |reason| is reported in the details.
+  void Purge(const std::string& reason);
+
+ private:
+  // Starts waiting for the delay when no page is visible.
+  void UpdateHiddenTimer();
+  void OnHiddenTimeout();
+
+  // Called by V8 after each full GC.
+  static void OnGCEpilogue(v8::Isolate* isolate,
+                           v8::GCType type,
+                           v8::GCCallbackFlags flags);
+  void CheckHeapSize();
+  void OnHeapLimitExceeded();
+
+  v8::Isolate* isolate_;
+  size_t heap_soft_limit_;
+  base::TimeDelta hidden_delay_;
+  ReportCallback callback_;
+
+  int visible_views_;
+  // Hidden pages are purged only once until one of them is shown.
+  bool purged_while_hidden_;
+  base::OneShotTimer hidden_timer_;
+
+  // Purging for the heap limit is throttled, since the live objects may stay
+  // above the limit after it.
+  bool heap_purge_pending_;
+  base::TimeTicks last_heap_purge_;
+
+  base::WeakPtrFactory<MemoryPurger> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPurger);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_MEMORY_PURGER_H_
@@ -0,0 +1,190 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/script_executor.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/native_mate_converters/v8_value_converter.h"
+#include "base/memory/ref_counted.h"
+#include "base/values.h"
+#include "content/public/renderer/render_frame.h"
+#include "content/public/renderer/render_thread.h"
+#include "ipc/ipc_message_macros.h"
+#include "native_mate/converter.h"
+#include "third_party/WebKit/public/web/WebKit.h"
+#include "third_party/WebKit/public/web/WebLocalFrame.h"
+#include "third_party/WebKit/public/web/WebScopedUserGesture.h"
+
+namespace atom {
+
+namespace {
+
+// Collects the results of a batch of scripts, and sends them to the browser
+// when the last one is set.
+class ScriptResults : public base::RefCounted<ScriptResults> {
+ public:
+  ScriptResults(int routing_id, int request_id, size_t size)
+      : routing_id_(routing_id),
+        request_id_(request_id),
+        errors_(size),
+        pending_(size) {
+    for (size_t i = 0; i < size; ++i)
+      results_.Append(base::Value::CreateNullValue());
+    if (size == 0)
+      Send();
+  }
+
+  void SetResult(size_t index,
+                 v8::Local<v8::Context> context,
+                 v8::Local<v8::Value> value) {
+    // Values that can not be converted, e.g. undefined, are sent as null.
+    std::unique_ptr<base::Value> converted(
+        V8ValueConverter().FromV8Value(value, context));
+    if (converted)
+      results_.Set(index, std::move(converted));
+    Done();
+  }
+
+  void SetError(size_t index, const std::string& error) {
+    errors_[index] = error;
+    Done();
+  }
+
+ private:
+  friend class base::RefCounted<ScriptResults>;
+
+  ~ScriptResults() {}
+
+  void Done() {
+    DCHECK_GT(pending_, 0u);
+    if (--pending_ == 0)
+      Send();
+  }
+
+  void Send() {
+    // The message is dropped by the browser if the frame has gone.
+    content::RenderThread::Get()->Send(
+        new AtomFrameHostMsg_ExecuteJavaScriptResponse(
+            routing_id_, request_id_, results_, errors_));
+  }
+
+  int routing_id_;
+  int request_id_;
+  base::ListValue results_;
+  std::vector<std::string> errors_;
+  size_t pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptResults);
+};
+
+// The result of a script that returned a promise, only one of its handlers
+// is called and deletes it.
+struct PendingPromise {
+  scoped_refptr<ScriptResults> results;
+  size_t index;
+};
+
+void OnPromiseFulfilled(const v8::FunctionCallbackInfo<v8::Value>& info) {
+  std::unique_ptr<PendingPromise> pending(static_cast<PendingPromise*>(
+      info.Data().As<v8::External>()->Value()));
+  pending->results->SetResult(
+      pending->index, info.GetIsolate()->GetCurrentContext(), info[0]);
+}
+
+void OnPromiseRejected(const v8::FunctionCallbackInfo<v8::Value>& info) {
+  std::unique_ptr<PendingPromise> pending(static_cast<PendingPromise*>(
+      info.Data().As<v8::External>()->Value()));
+  pending->results->SetError(pending->index, mate::V8ToString(info[0]));
+}
+
+void WaitForPromise(v8::Local<v8::Context> context,
+                    v8::Local<v8::Promise> promise,
+                    const scoped_refptr<ScriptResults>& results,
+                    size_t index) {
+  v8::Isolate* isolate = context->GetIsolate();
+  v8::Local<v8::External> data =
+      v8::External::New(isolate, new PendingPromise{results, index});
+  // The rejection handler is chained after the fulfillment handler, so a
+  // rejected promise does not leave an unhandled rejection behind.
+  v8::Local<v8::Function> on_fulfilled, on_rejected;
+  v8::Local<v8::Promise> chained;
+  if (!v8::Function::New(context, OnPromiseFulfilled, data)
+          .ToLocal(&on_fulfilled) ||
+      !v8::Function::New(context, OnPromiseRejected, data)
+          .ToLocal(&on_rejected) ||
+      !promise->Then(context, on_fulfilled).ToLocal(&chained) ||
+      chained->Catch(context, on_rejected).IsEmpty()) {
+    delete static_cast<PendingPromise*>(data->Value());
+    results->SetError(index, "Failed to wait for the promise");
+  }
+}
+
+}  // namespace
+
+ScriptExecutor::ScriptExecutor(content::RenderFrame* render_frame)
+    : content::RenderFrameObserver(render_frame) {
+}
+
+ScriptExecutor::~ScriptExecutor() {
+}
+
+bool ScriptExecutor::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(ScriptExecutor, message)
+    IPC_MESSAGE_HANDLER(AtomFrameMsg_ExecuteJavaScript, OnExecuteJavaScript)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+
+  return handled;
+}
+
+void ScriptExecutor::OnDestruct() {
+  delete this;
+}
+
+void ScriptExecutor::OnExecuteJavaScript(
+    int request_id,
+    const std::vector<base::string16>& scripts,
+    bool has_user_gesture) {
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> context =
+      render_frame()->GetWebFrame()->mainWorldScriptContext();
+  v8::Context::Scope context_scope(context);
+
+  scoped_refptr<ScriptResults> results(
+      new ScriptResults(routing_id(), request_id, scripts.size()));
+
+  std::unique_ptr<blink::WebScopedUserGesture> user_gesture;
+  if (has_user_gesture)
+    user_gesture.reset(new blink::WebScopedUserGesture);
+
+  // The microtasks run once after the whole batch, which also settles the
+  // promises that have been resolved by the scripts.
+  v8::MicrotasksScope microtasks_scope(isolate,
+                                       v8::MicrotasksScope::kRunMicrotasks);
+  for (size_t i = 0; i < scripts.size(); ++i) {
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::String> source =
+        mate::ConvertToV8(isolate, scripts[i]).As<v8::String>();
+    v8::Local<v8::Script> script;
+    v8::Local<v8::Value> result;
+    if (!v8::Script::Compile(context, source).ToLocal(&script) ||
+        !script->Run(context).ToLocal(&result)) {
+      results->SetError(i, try_catch.HasCaught() ?
+          mate::V8ToString(try_catch.Exception()) : "Script failed");
+    } else if (result->IsPromise()) {
+      WaitForPromise(context, result.As<v8::Promise>(), results, i);
+    } else {
+      results->SetResult(i, context, result);
+    }
+  }
+}
+
+}  // namespace atom
@@ -0,0 +1,37 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_SCRIPT_EXECUTOR_H_
+#define ATOM_RENDERER_SCRIPT_EXECUTOR_H_
+
+#include <vector>
+
+#include "base/strings/string16.h"
+#include "content/public/renderer/render_frame_observer.h"
+
+namespace atom {
+
+// Runs the scripts sent by webContents.executeJavaScriptInFrame in the main
+// world of a frame, and sends their results back to the browser without going
+// through the JavaScript IPC.
+class ScriptExecutor : public content::RenderFrameObserver {
+ public:
+  explicit ScriptExecutor(content::RenderFrame* render_frame);
+  ~ScriptExecutor() override;
+
+  // content::RenderFrameObserver:
+  bool OnMessageReceived(const IPC::Message& message) override;
+  void OnDestruct() override;
+
+ private:
+  void OnExecuteJavaScript(int request_id,
+                           const std::vector<base::string16>& scripts,
+                           bool has_user_gesture);
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptExecutor);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_SCRIPT_EXECUTOR_H_
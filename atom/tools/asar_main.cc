@@ -0,0 +1,233 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "atom/common/asar/archive.h"
+#include "atom/common/asar/archive_writer.h"
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+
+namespace {
+
+const char kUsage[] =
+    "Usage: asar pack <archive> <dir> [<file>...] [--files-from=<list>]\n"
+    "                 [--unpack=<pattern>] [--jobs=<n>] [--no-incremental]\n"
+    "       asar extract <archive> <dir>\n"
+    "       asar list <archive>\n"
+    "\n"
+    "pack puts all files under <dir> into <archive>, or only the listed files\n"
+    "when given as arguments or one per line in <list>. An existing archive\n"
+    "is updated by writing only the changed files.\n";
+
+// Reads the files to pack from a file, one per line.
+const char kFilesFrom[] = "files-from";
+// Files matching the pattern are put in the ".unpacked" directory.
+const char kUnpack[] = "unpack";
+// Number of threads reading files.
+const char kJobs[] = "jobs";
+// Always rewrite the whole archive.
+const char kNoIncremental[] = "no-incremental";
+
+const size_t kExtractBufferSize = 1024 * 1024;
+
+int PrintUsage() {
+  fputs(kUsage, stderr);
+  return 1;
+}
+
+int PrintError(const std::string& message, const base::FilePath& path) {
+  fprintf(stderr, "asar: %s %s\n", message.c_str(),
+          path.AsUTF8Unsafe().c_str());
+  return 1;
+}
+
+// Appends the paths of all entries under |dir| in |archive| to |paths|.
+void ListEntries(asar::Archive* archive,
+                 const base::FilePath& dir,
+                 std::vector<base::FilePath>* paths) {
+  std::vector<base::FilePath> children;
+  if (!archive->Readdir(dir, &children))
+    return;
+  for (const base::FilePath& child : children) {
+    base::FilePath path = dir.Append(child);
+    paths->push_back(path);
+    asar::Archive::Stats stats;
+    if (archive->Stat(path, &stats) && stats.is_directory && !stats.is_link)
+      ListEntries(archive, path, paths);
+  }
+}
+
+bool ExtractFile(asar::Archive* archive,
+                 const base::FilePath& path,
+                 const base::FilePath& dest) {
+  asar::Archive::FileInfo info;
+  if (!archive->GetFileInfo(path, &info))
+    return false;
+
+  if (info.unpacked) {
+    base::FilePath unpacked_path(archive->path().value() +
+                                 FILE_PATH_LITERAL(".unpacked"));
+    return base::CopyFile(unpacked_path.Append(path), dest);
+  }
+
+  base::File file(dest,
+                  base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  if (!file.IsValid())
+    return false;
+  std::vector<char> buf(kExtractBufferSize);
+  for (uint64_t start = 0; start < info.size; start += buf.size()) {
+    uint64_t length = std::min<uint64_t>(buf.size(), info.size - start);
+    if (!archive->Read(info, start, length, buf.data()) ||
+        file.WriteAtCurrentPos(buf.data(), length) !=
+            static_cast<int>(length))
+      return false;
+  }
+
+#if defined(OS_POSIX)
+  if (info.executable)
+    base::SetPosixFilePermissions(dest, base::FILE_PERMISSION_MASK &
+                                        ~base::FILE_PERMISSION_WRITE_BY_GROUP &
+                                        ~base::FILE_PERMISSION_WRITE_BY_OTHERS);
+#endif
+  return true;
+}
+
+int Pack(const base::CommandLine& command_line,
+         const base::CommandLine::StringVector& args) {
+  if (args.size() < 3)
+    return PrintUsage();
+
+  base::FilePath root(args[2]);
+  asar::ArchiveWriter writer(base::FilePath(args[1]));
+  writer.set_unpack_pattern(command_line.GetSwitchValueASCII(kUnpack));
+  writer.set_incremental(!command_line.HasSwitch(kNoIncremental));
+  int jobs;
+  if (base::StringToInt(command_line.GetSwitchValueASCII(kJobs), &jobs) &&
+      jobs > 0)
+    writer.set_jobs(jobs);
+
+  std::vector<base::FilePath> files;
+  for (size_t i = 3; i < args.size(); ++i)
+    files.push_back(base::FilePath(args[i]));
+  if (command_line.HasSwitch(kFilesFrom)) {
+    base::FilePath list_path = command_line.GetSwitchValuePath(kFilesFrom);
+    std::string list;
+    if (!base::ReadFileToString(list_path, &list))
+      return PrintError("cannot read", list_path);
+    for (const std::string& line : base::SplitString(
+             list, "\r\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY))
+      files.push_back(base::FilePath::FromUTF8Unsafe(line));
+  }
+
+  if (files.empty()) {
+    if (!writer.AddDirectory(root))
+      return PrintError("cannot read directory", root);
+  } else {
+    for (const base::FilePath& file : files) {
+      base::FilePath path;
+      if (!root.AppendRelativePath(file, &path))
+        return PrintError("file is not under the directory:", file);
+      writer.AddFile(path, file);
+    }
+  }
+
+  if (!writer.Write())
+    return PrintError("failed to write", base::FilePath(args[1]));
+  return 0;
+}
+
+int Extract(const base::CommandLine::StringVector& args) {
+  if (args.size() != 3)
+    return PrintUsage();
+
+  asar::Archive archive((base::FilePath(args[1])));
+  if (!archive.Init())
+    return PrintError("cannot read archive", base::FilePath(args[1]));
+
+  base::FilePath dest_dir(args[2]);
+  if (!base::CreateDirectory(dest_dir))
+    return PrintError("cannot create directory", dest_dir);
+
+  std::vector<base::FilePath> paths;
+  ListEntries(&archive, base::FilePath(), &paths);
+  for (const base::FilePath& path : paths) {
+    base::FilePath dest = dest_dir.Append(path);
+    asar::Archive::Stats stats;
+    if (!archive.Stat(path, &stats))
+      return PrintError("cannot stat", path);
+
+    if (stats.is_link) {
+#if defined(OS_POSIX)
+      // Links are relative to the root of archive.
+      base::FilePath target;
+      if (!archive.Realpath(path, &target))
+        return PrintError("cannot resolve link", path);
+      std::vector<base::FilePath::StringType> components;
+      path.DirName().GetComponents(&components);
+      base::FilePath relative_target;
+      for (const auto& component : components) {
+        if (component != base::FilePath::kCurrentDirectory)
+          relative_target = relative_target.Append(
+              base::FilePath::kParentDirectory);
+      }
+      if (!base::CreateSymbolicLink(relative_target.Append(target), dest))
+        return PrintError("cannot create link", dest);
+      continue;
+#endif
+    }
+
+    if (stats.is_directory) {
+      if (!base::CreateDirectory(dest))
+        return PrintError("cannot create directory", dest);
+    } else if (!ExtractFile(&archive, path, dest)) {
+      return PrintError("cannot extract", path);
+    }
+  }
+  return 0;
+}
+
+int List(const base::CommandLine::StringVector& args) {
+  if (args.size() != 2)
+    return PrintUsage();
+
+  asar::Archive archive((base::FilePath(args[1])));
+  if (!archive.Init())
+    return PrintError("cannot read archive", base::FilePath(args[1]));
+
+  std::vector<base::FilePath> paths;
+  ListEntries(&archive, base::FilePath(), &paths);
+  for (const base::FilePath& path : paths)
+    printf("%s\n", path.AsUTF8Unsafe().c_str());
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+
+  base::CommandLine::StringVector args = command_line.GetArgs();
+  if (args.empty())
+    return PrintUsage();
+  if (args[0] == FILE_PATH_LITERAL("pack"))
+    return Pack(command_line, args);
+  if (args[0] == FILE_PATH_LITERAL("extract"))
+    return Extract(args);
+  if (args[0] == FILE_PATH_LITERAL("list"))
+    return List(args);
+  return PrintUsage();
+}
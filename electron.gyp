@@ -352,9 +352,56 @@
         }],  # OS=="linux"
       ],
     },  # target <(product_name)_lib
+    {
+      'target_name': 'asar_tool',
+      'product_name': 'asar',
+      'type': 'executable',
+      'dependencies': [
+        # Only for the headers and libraries of base, crypto and zlib.
+        'vendor/brightray/brightray.gyp:brightray',
+      ],
+      'sources': [
+        '<@(asar_tool_sources)',
+      ],
+      'include_dirs': [
+        '.',
+      ],
+      # Drop the code and the shared libraries of libchromiumcontent that the
+      # tool does not use.
+      'xcode_settings': {
+        'DEAD_CODE_STRIPPING': 'YES',  # -Wl,-dead_strip
+      },
+      'msvs_settings': {
+        'VCLinkerTool': {
+          'OptimizeReferences': 2,  # /OPT:REF
+        },
+      },
+      'conditions': [
+        ['OS=="linux"', {
+          'ldflags': [
+            '-Wl,--gc-sections',
+            '-Wl,--as-needed',
+          ],
+        }],  # OS=="linux"
+        ['OS=="win"', {
+          'sources': [
+            # Used by asar::Archive to get the fd of archive.
+            'atom/node/osfhandle.cc',
+            'atom/node/osfhandle.h',
+          ],
+        }],  # OS=="win"
+      ],
+    },  # target asar_tool
     {
       'target_name': 'js2asar',
       'type': 'none',
+      'conditions': [
+        ['target_arch==host_arch', {
+          'dependencies': [
+            'asar_tool',
+          ],
+        }],
+      ],
       'actions': [
         {
           'action_name': 'js2asar',
@@ -365,9 +412,19 @@
               },{
                 'resources_path': '<(PRODUCT_DIR)/resources',
               }],
+              # The asar executable is built for the target, cross builds
+              # use the asar module of npm instead.
+              ['target_arch==host_arch', {
+                'asar_path': '<(PRODUCT_DIR)/asar<(EXECUTABLE_SUFFIX)',
+                'asar_inputs': [ '<(PRODUCT_DIR)/asar<(EXECUTABLE_SUFFIX)' ],
+              }, {
+                'asar_path': 'npm',
+                'asar_inputs': [],
+              }],
             ],
           },
           'inputs': [
+            '<@(asar_inputs)',
             '<@(js_sources)',
           ],
           'outputs': [
@@ -376,9 +433,10 @@
           'action': [
             'python',
             'tools/js2asar.py',
+            '<(asar_path)',
             '<@(_outputs)',
             'lib',
-            '<@(_inputs)',
+            '<@(js_sources)',
           ],
         }
       ],
@@ -386,6 +444,13 @@
     {
       'target_name': 'app2asar',
       'type': 'none',
+      'conditions': [
+        ['target_arch==host_arch', {
+          'dependencies': [
+            'asar_tool',
+          ],
+        }],
+      ],
       'actions': [
         {
           'action_name': 'app2asar',
@@ -396,9 +461,19 @@
               },{
                 'resources_path': '<(PRODUCT_DIR)/resources',
               }],
+              # The asar executable is built for the target, cross builds
+              # use the asar module of npm instead.
+              ['target_arch==host_arch', {
+                'asar_path': '<(PRODUCT_DIR)/asar<(EXECUTABLE_SUFFIX)',
+                'asar_inputs': [ '<(PRODUCT_DIR)/asar<(EXECUTABLE_SUFFIX)' ],
+              }, {
+                'asar_path': 'npm',
+                'asar_inputs': [],
+              }],
             ],
           },
           'inputs': [
+            '<@(asar_inputs)',
             '<@(default_app_sources)',
           ],
           'outputs': [
@@ -407,9 +482,10 @@
           'action': [
             'python',
             'tools/js2asar.py',
+            '<(asar_path)',
             '<@(_outputs)',
             'default_app',
-            '<@(_inputs)',
+            '<@(default_app_sources)',
           ],
         }
       ],
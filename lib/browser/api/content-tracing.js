@@ -1 +1,25 @@
-module.exports = process.atomBinding('content_tracing')
+const {Readable} = require('stream')
+const contentTracing = process.atomBinding('content_tracing')
+
+// Pushes the trace data produced by |start| into a readable stream.
+const createTraceStream = function (start, options = {}) {
+  const stream = new Readable({read () {}})
+  const onChunk = (chunk) => stream.push(chunk)
+  const onEnd = () => stream.push(null)
+  if (!start(Boolean(options.compress), onChunk, onEnd)) {
+    process.nextTick(() => {
+      stream.emit('error', new Error('Tracing is not recording'))
+    })
+  }
+  return stream
+}
+
+contentTracing.stopRecordingToStream = function (options) {
+  return createTraceStream(contentTracing._stopRecordingToStream, options)
+}
+
+contentTracing.captureRecordingSnapshot = function (options) {
+  return createTraceStream(contentTracing._captureRecordingSnapshot, options)
+}
+
+module.exports = contentTracing
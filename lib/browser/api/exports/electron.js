@@ -59,6 +59,12 @@ Object.defineProperties(exports, {
       return require('../menu-item')
     }
   },
+  NodeWorker: {
+    enumerable: true,
+    get: function () {
+      return require('../node-worker')
+    }
+  },
   powerMonitor: {
     enumerable: true,
     get: function () {
@@ -0,0 +1,10 @@
+const {EventEmitter} = require('events')
+const {NodeWorker} = process.atomBinding('node_worker')
+
+Object.setPrototypeOf(NodeWorker.prototype, EventEmitter.prototype)
+
+NodeWorker.prototype.postMessage = function (message) {
+  this._postMessage(JSON.stringify(message))
+}
+
+module.exports = NodeWorker
@@ -17,6 +17,17 @@ Object.defineProperties(exports, {
 Object.setPrototypeOf(Session.prototype, EventEmitter.prototype)
 Object.setPrototypeOf(Cookies.prototype, EventEmitter.prototype)
 
+// The native callback of the verify proc always takes the cache time.
+const {setCertificateVerifyProc} = Session.prototype
+Session.prototype.setCertificateVerifyProc = function (proc) {
+  if (typeof proc !== 'function') return setCertificateVerifyProc.call(this, proc)
+  setCertificateVerifyProc.call(this, (hostname, certificate, callback) => {
+    proc(hostname, certificate, (isTrusted, cacheTime = 0) => {
+      callback(Boolean(isTrusted), cacheTime)
+    })
+  })
+}
+
 Session.prototype._init = function () {
   app.emit('session-created', this)
 }
@@ -167,6 +167,25 @@ WebContents.prototype.executeJavaScript = function (code, hasUserGesture, callba
   }
 }
 
+// Run one script or a batch of scripts in the frame of frameRoutingId, the
+// scripts and their results do not go through the JavaScript IPC.
+WebContents.prototype.executeJavaScriptInFrame = function (frameRoutingId, code, hasUserGesture, callback) {
+  if (typeof hasUserGesture === 'function') {
+    callback = hasUserGesture
+    hasUserGesture = false
+  }
+  const isBatch = Array.isArray(code)
+  const scripts = isBatch ? code : [code]
+  return new Promise((resolve, reject) => {
+    this._executeJavaScriptInFrame(frameRoutingId, scripts, Boolean(hasUserGesture), (error, results) => {
+      if (error) return reject(error)
+      const result = isBatch ? results : results[0]
+      if (callback != null) callback(result)
+      resolve(result)
+    })
+  })
+}
+
 // Translate the options of printToPDF.
 WebContents.prototype.printToPDF = function (options, callback) {
   const printingSetting = Object.assign({}, defaultPrintingSetting)
@@ -283,5 +302,30 @@ module.exports = {
 
   getAllWebContents () {
     return binding.getAllWebContents()
+  },
+
+  broadcast (channel, ...args) {
+    if (channel == null) throw new Error('Missing required channel argument')
+    const ids = binding.getAllWebContents().map((contents) => contents.id)
+    return binding._broadcast(ids, false, channel, args)
+  },
+
+  broadcastTo (targets, channel, ...args) {
+    if (channel == null) throw new Error('Missing required channel argument')
+    if (!Array.isArray(targets)) {
+      // A session, send to all webContents using it.
+      const ses = targets
+      targets = binding.getAllWebContents().filter((contents) => contents.session === ses)
+    }
+    const ids = targets.map((contents) => contents.id)
+    return binding._broadcast(ids, false, channel, args)
+  },
+
+  connect (contents1, contents2, channel) {
+    if (channel == null) throw new Error('Missing required channel argument')
+    const ports = binding._createMessagePorts(contents1.id, contents2.id)
+    if (ports.length !== 2) throw new Error('Unable to connect the web contents')
+    contents1._send(false, 'ELECTRON_RENDERER_MESSAGE_PORT', [channel, ports[0]])
+    contents2._send(false, 'ELECTRON_RENDERER_MESSAGE_PORT', [channel, ports[1]])
   }
 }
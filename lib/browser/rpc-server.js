@@ -7,8 +7,6 @@ const {WebContents} = process.atomBinding('web_contents')
 
 const {ipcMain, isPromise, webContents} = electron
 
-const fs = require('fs')
-
 const objectsRegistry = require('./objects-registry')
 
 const hasProp = {}.hasOwnProperty
@@ -267,13 +265,6 @@ ipcMain.on('ELECTRON_BROWSER_REQUIRE', function (event, module) {
   }
 })
 
-ipcMain.on('ELECTRON_BROWSER_READ_FILE', function (event, file) {
-  fs.readFile(file, (err, data) => {
-    if (err) event.returnValue = {err: err.message}
-    else event.returnValue = {data: data.toString()}
-  })
-})
-
 ipcMain.on('ELECTRON_BROWSER_GET_BUILTIN', function (event, module) {
   try {
     event.returnValue = valueToMeta(event.sender, electron[module])
@@ -27,6 +27,12 @@ exports.defineProperties = function (exports) {
         return require('../shell')
       }
     },
+    traceEvents: {
+      enumerable: true,
+      get: function () {
+        return require('../trace-events')
+      }
+    },
 
     // The internal modules, invisible unless you know their names.
     CallbacksRegistry: {
@@ -0,0 +1,63 @@
+const binding = process.atomBinding('trace_events')
+
+// The enabled flags of the categories, a disabled category is checked without
+// calling into native code.
+const categoryFlags = {}
+let categoryCount = 0
+
+// Each category takes an entry of a table that Chromium's own categories fill
+// too, and that is never freed, so only a few categories can be registered.
+const maxCategories = 32
+
+const getCategoryFlag = function (category) {
+  category = String(category)
+  let flag = categoryFlags[category]
+  if (!flag) {
+    if (categoryCount >= maxCategories) {
+      throw new RangeError(`Can not use more than ${maxCategories} trace categories`)
+    }
+    flag = new Uint8Array(binding.getCategoryEnabledFlag(category))
+    categoryFlags[category] = flag
+    categoryCount++
+  }
+  return flag
+}
+
+const isCategoryEnabled = function (category) {
+  return getCategoryFlag(category)[0] !== 0
+}
+
+const addEvent = function (phase, category, name, id, args) {
+  if (isCategoryEnabled(category)) {
+    binding.addTraceEvent(phase, category, String(name), id, args)
+  }
+}
+
+exports.isCategoryEnabled = isCategoryEnabled
+
+exports.begin = function (category, name, args) {
+  addEvent('B', category, name, 0, args)
+}
+
+exports.end = function (category, name, args) {
+  addEvent('E', category, name, 0, args)
+}
+
+exports.instant = function (category, name, args) {
+  addEvent('I', category, name, 0, args)
+}
+
+exports.asyncBegin = function (category, name, id, args) {
+  addEvent('b', category, name, id, args)
+}
+
+exports.asyncEnd = function (category, name, id, args) {
+  addEvent('e', category, name, id, args)
+}
+
+exports.counter = function (category, name, values) {
+  if (isCategoryEnabled(category)) {
+    if (typeof values === 'number') values = {value: values}
+    binding.addCounter(category, String(name), values)
+  }
+}
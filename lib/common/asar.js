@@ -149,6 +149,19 @@
     })
   }
 
+  // Create a EIO error for a file failing the integrity check.
+  const integrityError = function (asarPath, filePath, callback) {
+    const error = new Error(`EIO, integrity check failed for ${filePath} in ${asarPath}`)
+    error.code = 'EIO'
+    error.errno = -5
+    if (typeof callback !== 'function') {
+      throw error
+    }
+    process.nextTick(function () {
+      callback(error)
+    })
+  }
+
   // Create invalid archive error.
   const invalidArchiveError = function (asarPath, callback) {
     const error = new Error(`Invalid package ${asarPath}`)
@@ -488,6 +501,16 @@
         throw new TypeError('Bad arguments')
       }
       const {encoding} = options
+      if (info.compressed) {
+        logASARAccess(asarPath, filePath, info.offset)
+        // Inflating can take long, so it is done in a worker thread.
+        return archive.readFileAsync(filePath, function (buffer) {
+          if (!buffer) {
+            return integrityError(asarPath, filePath, callback)
+          }
+          callback(null, encoding ? buffer.toString(encoding) : buffer)
+        })
+      }
       const buffer = new Buffer(info.size)
       const fd = archive.getFd()
       if (!(fd >= 0)) {
@@ -495,6 +518,9 @@
       }
       logASARAccess(asarPath, filePath, info.offset)
       fs.read(fd, buffer, 0, info.size, info.offset, function (error) {
+        if (!error && info.integrity && !archive.verifyIntegrity(filePath, buffer)) {
+          return integrityError(asarPath, filePath, callback)
+        }
         callback(error, encoding ? buffer.toString(encoding) : buffer)
       })
     }
@@ -536,13 +562,25 @@
         throw new TypeError('Bad arguments')
       }
       const {encoding} = options
-      const buffer = new Buffer(info.size)
-      const fd = archive.getFd()
-      if (!(fd >= 0)) {
-        notFoundError(asarPath, filePath)
+      let buffer
+      if (info.compressed) {
+        logASARAccess(asarPath, filePath, info.offset)
+        buffer = archive.readFile(filePath)
+        if (!buffer) {
+          integrityError(asarPath, filePath)
+        }
+      } else {
+        buffer = new Buffer(info.size)
+        const fd = archive.getFd()
+        if (!(fd >= 0)) {
+          notFoundError(asarPath, filePath)
+        }
+        logASARAccess(asarPath, filePath, info.offset)
+        fs.readSync(fd, buffer, 0, info.size, info.offset)
+        if (info.integrity && !archive.verifyIntegrity(filePath, buffer)) {
+          integrityError(asarPath, filePath)
+        }
       }
-      logASARAccess(asarPath, filePath, info.offset)
-      fs.readSync(fd, buffer, 0, info.size, info.offset)
       if (encoding) {
         return buffer.toString(encoding)
       } else {
@@ -609,6 +647,14 @@
           encoding: 'utf8'
         })
       }
+      if (info.compressed) {
+        logASARAccess(asarPath, filePath, info.offset)
+        const buffer = archive.readFile(filePath)
+        if (!buffer) {
+          integrityError(asarPath, filePath)
+        }
+        return buffer.toString('utf8')
+      }
       const buffer = new Buffer(info.size)
       const fd = archive.getFd()
       if (!(fd >= 0)) {
@@ -616,6 +662,9 @@
       }
       logASARAccess(asarPath, filePath, info.offset)
       fs.readSync(fd, buffer, 0, info.size, info.offset)
+      if (info.integrity && !archive.verifyIntegrity(filePath, buffer)) {
+        integrityError(asarPath, filePath)
+      }
       return buffer.toString('utf8')
     }
 
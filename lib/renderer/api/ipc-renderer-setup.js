@@ -2,6 +2,35 @@
 // in filenames.gypi so they get built into the preload_bundle.js bundle
 
 module.exports = function (ipcRenderer, binding) {
+  // Tell the browser which channels have listeners, messages of the other
+  // channels are dropped before being sent to this renderer. The listeners are
+  // tracked by wrapping the methods that change them, so the tracking does
+  // not rely on listeners that could be removed from ipcRenderer.
+  const subscribed = new Set()
+  const updateSubscription = function (channel) {
+    if (typeof channel !== 'string') return
+    const hasListeners = ipcRenderer.listenerCount(channel) > 0
+    if (hasListeners === subscribed.has(channel)) return
+    if (hasListeners) {
+      subscribed.add(channel)
+    } else {
+      subscribed.delete(channel)
+    }
+    binding.setChannelSubscribed(channel, hasListeners)
+  }
+  const methods = [
+    'addListener', 'on', 'once', 'prependListener', 'prependOnceListener',
+    'removeListener', 'removeAllListeners'
+  ]
+  for (const method of methods) {
+    const original = ipcRenderer[method]
+    ipcRenderer[method] = function (channel, ...args) {
+      const result = original.call(this, channel, ...args)
+      updateSubscription(channel)
+      return result
+    }
+  }
+
   ipcRenderer.send = function (...args) {
     return binding.send('ipc-message', args)
   }
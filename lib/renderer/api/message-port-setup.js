@@ -0,0 +1,56 @@
+// Any requires added here need to be added to the browserify_entries array
+// in filenames.gypi so they get built into the preload_bundle.js bundle
+
+const {EventEmitter} = require('events')
+
+// One end of a message channel connected to another renderer by
+// webContents.connect, messages do not go through the main process.
+class MessagePort extends EventEmitter {
+  constructor (binding, id) {
+    super()
+    this.binding = binding
+    this.id = id
+    this.closed = false
+  }
+
+  postMessage (...args) {
+    if (this.closed) throw new Error('Message port is closed')
+    this.binding.postPortMessage(this.id, args)
+  }
+
+  close () {
+    if (this.closed) return
+    this.binding.closePort(this.id)
+    this._onClosed()
+  }
+
+  _onClosed () {
+    this.closed = true
+    this.emit('close')
+  }
+}
+
+// The sandboxed renderer emits ipcRenderer events without the event object,
+// so the arguments are taken from the end.
+module.exports = function (ipcRenderer, binding) {
+  const ports = new Map()
+
+  ipcRenderer.on('ELECTRON_RENDERER_MESSAGE_PORT', function (...args) {
+    const [channel, id] = args.slice(-2)
+    const port = new MessagePort(binding, id)
+    ports.set(id, port)
+    port.once('close', () => ports.delete(id))
+    ipcRenderer.emit(channel, ...args.slice(0, -2), port)
+  })
+
+  ipcRenderer.on('ELECTRON_RENDERER_PORT_MESSAGE', function (...args) {
+    const [id, messageArgs] = args.slice(-2)
+    const port = ports.get(id)
+    if (port) port.emit('message', {sender: port}, ...messageArgs)
+  })
+
+  ipcRenderer.on('ELECTRON_RENDERER_PORT_CLOSED', function (...args) {
+    const port = ports.get(args[args.length - 1])
+    if (port) port._onClosed()
+  })
+}
@@ -1,17 +1,14 @@
 // Any requires added here need to be added to the browserify_entries array
 // in filenames.gypi so they get built into the preload_bundle.js bundle
 
-/* eslint no-eval: "off" */
-/* global binding, preloadPath, process, Buffer */
+/* global binding, preloadPath, preloadFn, process, Buffer */
 const events = require('events')
 
 const ipcRenderer = new events.EventEmitter()
 const proc = new events.EventEmitter()
-// eval in window scope:
-// http://www.ecma-international.org/ecma-262/5.1/#sec-10.4.2
-const geval = eval
 
 require('../renderer/api/ipc-renderer-setup')(ipcRenderer, binding)
+require('../renderer/api/message-port-setup')(ipcRenderer, binding)
 
 binding.onMessage = function (channel, args) {
   ipcRenderer.emit(channel, ...args)
@@ -34,14 +31,9 @@ function preloadRequire (module) {
   throw new Error('module not found')
 }
 
-// Fetch the source for the preload
-let preloadSrc = ipcRenderer.sendSync('ELECTRON_BROWSER_READ_FILE', preloadPath)
-if (preloadSrc.err) {
-  throw new Error(preloadSrc.err)
-}
-
-// Wrap the source into a function receives a `require` function as argument.
-// Browserify bundles can make use of this, as explained in:
+// The preload script is read and compiled natively, wrapped into a function
+// receiving a `require` function as argument. Browserify bundles can make use
+// of this, as explained in:
 // https://github.com/substack/node-browserify#multiple-bundles
 //
 // For example, the user can create a browserify bundle with:
@@ -51,9 +43,10 @@ if (preloadSrc.err) {
 // and any `require('electron')` calls in `preload.js` will work as expected
 // since browserify won't try to include `electron` in the bundle and will fall
 // back to the `preloadRequire` function above.
-let preloadWrapperSrc = `(function(require, process, Buffer, global) {
-${preloadSrc.data}
-})`
+//
+// When the script can not be read or compiled, `preloadFn` is the error.
+if (typeof preloadFn !== 'function') {
+  throw preloadFn
+}
 
-let preloadFn = geval(preloadWrapperSrc)
 preloadFn(preloadRequire, proc, Buffer, global)
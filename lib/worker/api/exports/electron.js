@@ -0,0 +1,9 @@
+Object.defineProperties(exports, {
+  // Worker side modules, please sort with alphabet order.
+  parentPort: {
+    enumerable: true,
+    get: function () {
+      return require('../parent-port')
+    }
+  }
+})
@@ -0,0 +1,27 @@
+const {EventEmitter} = require('events')
+
+const binding = process._workerBinding
+
+const parentPort = new EventEmitter()
+
+parentPort.postMessage = function (message) {
+  binding.postMessage(JSON.stringify(message))
+}
+
+// Only keep the worker alive when someone is listening to the parent.
+parentPort.on('newListener', function (event) {
+  if (event === 'message' && parentPort.listenerCount('message') === 0) {
+    binding.ref()
+  }
+})
+parentPort.on('removeListener', function (event) {
+  if (event === 'message' && parentPort.listenerCount('message') === 0) {
+    binding.unref()
+  }
+})
+
+process.on('ELECTRON_WORKER_MESSAGE', function (message) {
+  parentPort.emit('message', JSON.parse(message))
+})
+
+module.exports = parentPort
@@ -0,0 +1,56 @@
+'use strict'
+
+const path = require('path')
+const Module = require('module')
+
+// We modified the original process.argv to let node.js load the init.js,
+// we need to restore it here.
+process.argv.splice(1, 1)
+
+// Clear search paths.
+require('../common/reset-search-paths')
+
+// Expose public APIs.
+Module.globalPaths.push(path.join(__dirname, 'api', 'exports'))
+
+// Setup the channel to the main process before hiding the native binding.
+require('./api/parent-port')
+const binding = process._workerBinding
+delete process._workerBinding
+
+// Whether node is handling an uncaught exception, terminating the execution
+// while it does would make node exit the whole process.
+let handlingException = false
+
+// The worker shares the process with the main process, exiting should only
+// stop the worker's own event loop and not run the rest of the script.
+process.exit = function (code) {
+  if (code || code === 0) process.exitCode = code
+  binding.exit(process.exitCode || 0, !handlingException)
+  if (!handlingException) throw new Error('process.exit() was called')
+}
+
+// An uncaught exception would make node exit the whole process, instead stop
+// the worker and report the exception to the main process.
+const fatalException = process._fatalException
+process._fatalException = function (error) {
+  handlingException = true
+  try {
+    if (!fatalException.call(process, error)) {
+      binding.exitWithError(error && error.stack ? error.stack : String(error))
+    }
+  } finally {
+    handlingException = false
+  }
+  return true
+}
+
+// Set main startup script of the worker.
+const mainStartupScript = path.resolve(process.argv[1])
+process.argv.splice(1, 1, mainStartupScript)
+
+// Node has bootstrapped, the worker can be terminated from now on.
+binding.allowTermination()
+
+// Finally load the worker script.
+Module._load(mainStartupScript, Module, true)
@@ -376,6 +376,25 @@ describe('app module', function () {
     })
   })
 
+  describe('getAppMetrics() API', function () {
+    it('returns memory and cpu stats of all running electron processes', function () {
+      const appMetrics = app.getAppMetrics()
+      assert.ok(appMetrics.length > 0, 'App memory info object is not > 0')
+      const types = []
+      for (const {memory, pid, type, cpu} of appMetrics) {
+        assert.ok(memory.workingSetSize > 0, 'working set size is not > 0')
+        assert.ok(memory.peakWorkingSetSize > 0, 'peak working set size is not > 0')
+        assert.ok(pid > 0, 'pid is not > 0')
+        assert.ok(type.length > 0, 'process type is null')
+        types.push(type)
+        assert.equal(typeof cpu.percentCPUUsage, 'number')
+      }
+
+      assert.ok(types.includes('Browser'))
+      assert.ok(types.includes('Tab'))
+    })
+  })
+
   describe('select-client-certificate event', function () {
     let w = null
 
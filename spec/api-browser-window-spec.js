@@ -866,6 +866,29 @@ describe('BrowserWindow module', function () {
         w.loadURL('file://' + path.join(fixtures, 'api', 'preload.html'))
       })
 
+      it('runs the preload script again when it is reloaded', function (done) {
+        let answers = 0
+        const onAnswer = function (event, test) {
+          assert.equal(test, 'preload')
+          if (++answers === 1) {
+            w.webContents.reload()
+          } else {
+            ipcMain.removeListener('answer', onAnswer)
+            done()
+          }
+        }
+        ipcMain.on('answer', onAnswer)
+        w.destroy()
+        w = new BrowserWindow({
+          show: false,
+          webPreferences: {
+            sandbox: true,
+            preload: preload
+          }
+        })
+        w.loadURL('file://' + path.join(fixtures, 'api', 'preload.html'))
+      })
+
       it('exposes "exit" event to preload script', function (done) {
         w.destroy()
         w = new BrowserWindow({
@@ -1807,6 +1830,64 @@ describe('BrowserWindow module', function () {
       app.emit('will-quit')
       assert.equal(fs.existsSync(serializedPath), false)
     })
+
+    describe('content scripts', function () {
+      const pageURL = 'file://' + path.join(fixtures, 'pages', 'content-script.html')
+
+      beforeEach(function () {
+        BrowserWindow.removeDevToolsExtension('content-script')
+        BrowserWindow.addDevToolsExtension(path.join(__dirname, 'fixtures', 'devtools-extensions', 'content-script'))
+      })
+
+      afterEach(function () {
+        BrowserWindow.removeDevToolsExtension('content-script')
+      })
+
+      const getResults = function (callback) {
+        w.webContents.once('did-finish-load', function () {
+          w.webContents.executeJavaScript('window.contentScriptResults', callback)
+        })
+        w.loadURL(pageURL)
+      }
+
+      it('runs document_start scripts before the document is parsed', function (done) {
+        getResults(function (results) {
+          assert.deepEqual(results.start, {readyState: 'loading', hasBody: false})
+          done()
+        })
+      })
+
+      it('runs document_end scripts after the document is parsed', function (done) {
+        getResults(function (results) {
+          assert.deepEqual(results.end, {readyState: 'interactive', hasLastElement: true})
+          done()
+        })
+      })
+
+      it('runs the scripts with any pattern matching the URL', function (done) {
+        getResults(function (results) {
+          assert.equal(results.matched, true)
+          assert.equal(results.notMatched, undefined)
+          done()
+        })
+      })
+
+      it('reports the errors of scripts to the console and runs the next ones', function (done) {
+        let reported = false
+        w.webContents.on('console-message', function (event, level, message, line, sourceId) {
+          if (message.includes('content script failed')) {
+            assert.equal(sourceId, 'chrome-extension://content-script/throw.js')
+            assert.equal(line, 1)
+            reported = true
+          }
+        })
+        getResults(function (results) {
+          assert.equal(reported, true)
+          assert.equal(results.afterThrow, true)
+          done()
+        })
+      })
+    })
   })
 
   describe('window.webContents.executeJavaScript', function () {
@@ -0,0 +1,89 @@
+const assert = require('assert')
+const zlib = require('zlib')
+const {remote, traceEvents} = require('electron')
+const {contentTracing} = remote
+
+describe('contentTracing module', function () {
+  const category = 'electron-spec'
+
+  const startRecording = function (callback) {
+    contentTracing.startRecording({
+      categoryFilter: category,
+      traceOptions: 'record-until-full'
+    }, () => callback())
+  }
+
+  // Reads the whole trace from |stream| and returns the names of the events of
+  // the category.
+  const readTrace = function (stream, compressed, callback) {
+    const chunks = []
+    stream
+      .on('data', (chunk) => chunks.push(chunk))
+      .on('end', () => {
+        let data = Buffer.concat(chunks)
+        if (compressed) data = zlib.gunzipSync(data)
+        const trace = JSON.parse(data.toString())
+        callback(trace.traceEvents
+          .filter((event) => event.cat === category)
+          .map((event) => event.name))
+      })
+  }
+
+  // The renderer starts recording again after the browser has.
+  const waitForRecording = function (callback) {
+    if (traceEvents.isCategoryEnabled(category)) return callback()
+    setTimeout(() => waitForRecording(callback), 10)
+  }
+
+  describe('contentTracing.stopRecordingToStream([options])', function () {
+    beforeEach(function (done) {
+      startRecording(done)
+    })
+
+    it('streams the trace as JSON', function (done) {
+      traceEvents.instant(category, 'streamed')
+      readTrace(contentTracing.stopRecordingToStream(), false, (names) => {
+        assert.deepEqual(names, ['streamed'])
+        done()
+      })
+    })
+
+    it('streams the trace as gzipped JSON', function (done) {
+      traceEvents.instant(category, 'compressed')
+      readTrace(contentTracing.stopRecordingToStream({compress: true}), true, (names) => {
+        assert.deepEqual(names, ['compressed'])
+        done()
+      })
+    })
+  })
+
+  describe('contentTracing.captureRecordingSnapshot([options])', function () {
+    beforeEach(function (done) {
+      startRecording(done)
+    })
+
+    it('keeps recording after the snapshot', function (done) {
+      traceEvents.instant(category, 'before')
+      readTrace(contentTracing.captureRecordingSnapshot(), false, (names) => {
+        assert.deepEqual(names, ['before'])
+        waitForRecording(() => {
+          traceEvents.instant(category, 'after')
+          readTrace(contentTracing.stopRecordingToStream(), false, (names) => {
+            assert.deepEqual(names, ['after'])
+            done()
+          })
+        })
+      })
+    })
+
+    it('streams the snapshot as gzipped JSON', function (done) {
+      traceEvents.instant(category, 'compressed')
+      readTrace(contentTracing.captureRecordingSnapshot({compress: true}), true, (names) => {
+        assert.deepEqual(names, ['compressed'])
+        waitForRecording(() => {
+          contentTracing.stopRecording('', () => done())
+        })
+      })
+    })
+  })
+})
@@ -483,6 +483,46 @@ describe('ipc module', function () {
     })
   })
 
+  describe('ipcRenderer channel listeners', function () {
+    it('receives messages after listening to a channel again', function (done) {
+      const listener = function () {}
+      ipcRenderer.on('channel-listeners', listener)
+      ipcRenderer.removeListener('channel-listeners', listener)
+      ipcRenderer.once('channel-listeners', function (event, value) {
+        assert.equal(value, 'again')
+        assert.equal(ipcRenderer.listenerCount('channel-listeners'), 0)
+        done()
+      })
+      remote.getCurrentWebContents().send('channel-listeners', 'again')
+    })
+
+    it('receives messages after removeAllListeners of a channel', function (done) {
+      ipcRenderer.on('channel-remove-all', function () {
+        done(new Error('removed listener was called'))
+      })
+      ipcRenderer.removeAllListeners('channel-remove-all')
+      assert.equal(ipcRenderer.listenerCount('channel-remove-all'), 0)
+      ipcRenderer.once('channel-remove-all', function (event, value) {
+        assert.equal(value, 'again')
+        done()
+      })
+      remote.getCurrentWebContents().send('channel-remove-all', 'again')
+    })
+
+    it('keeps tracking channels when the listeners of other events are removed', function (done) {
+      assert.throws(function () {
+        ipcRenderer.removeAllListeners()
+      }, /Please specify a event name/)
+      ipcRenderer.removeAllListeners('newListener')
+      ipcRenderer.removeAllListeners('removeListener')
+      ipcRenderer.once('channel-untracked', function (event, value) {
+        assert.equal(value, 'received')
+        done()
+      })
+      remote.getCurrentWebContents().send('channel-untracked', 'received')
+    })
+  })
+
   describe('remote listeners', function () {
     it('can be added and removed correctly', function () {
       w = new BrowserWindow({
@@ -0,0 +1,88 @@
+const assert = require('assert')
+const path = require('path')
+const {NodeWorker} = require('electron').remote
+
+describe('NodeWorker module', () => {
+  const fixtures = path.resolve(__dirname, 'fixtures', 'api', 'node-worker')
+  let worker = null
+
+  afterEach(() => {
+    if (worker != null) worker.terminate()
+    worker = null
+  })
+
+  it('throws when the script path is not absolute', () => {
+    assert.throws(() => {
+      worker = new NodeWorker('echo.js')
+    }, /The script path must be absolute/)
+  })
+
+  it('exchanges messages with the worker', (done) => {
+    worker = new NodeWorker(path.join(fixtures, 'echo.js'))
+    worker.once('message', (event, message) => {
+      assert.deepEqual(message, {type: 'worker', echo: {hello: 'world'}})
+      done()
+    })
+    worker.postMessage({hello: 'world'})
+  })
+
+  it('can read files in asar archives', (done) => {
+    worker = new NodeWorker(path.join(fixtures, 'asar.js'))
+    worker.once('message', (event, message) => {
+      assert.equal(message, 'file1')
+      done()
+    })
+  })
+
+  it('emits exit with the code passed to process.exit', (done) => {
+    worker = new NodeWorker(path.join(fixtures, 'echo.js'))
+    worker.once('exit', (event, code) => {
+      assert.equal(code, 3)
+      assert.equal(worker.isRunning(), false)
+      done()
+    })
+    worker.postMessage('exit')
+  })
+
+  it('stops running the script after process.exit', (done) => {
+    worker = new NodeWorker(path.join(fixtures, 'exit.js'))
+    worker.once('message', () => {
+      done(new Error('The script kept running after process.exit'))
+    })
+    worker.once('exit', (event, code) => {
+      assert.equal(code, 4)
+      done()
+    })
+  })
+
+  it('stops only the worker on uncaught exceptions', (done) => {
+    worker = new NodeWorker(path.join(fixtures, 'throw.js'))
+    let stack = null
+    worker.once('uncaught-exception', (event, error) => {
+      stack = error
+    })
+    worker.once('exit', (event, code) => {
+      assert.equal(code, 1)
+      assert.notEqual(stack.indexOf('thrown in worker'), -1)
+      done()
+    })
+  })
+
+  it('can terminate a worker before it has loaded', (done) => {
+    worker = new NodeWorker(path.join(fixtures, 'echo.js'))
+    worker.once('exit', () => {
+      assert.equal(worker.isRunning(), false)
+      done()
+    })
+    worker.terminate()
+  })
+
+  it('can terminate a busy worker', (done) => {
+    worker = new NodeWorker(path.join(fixtures, 'busy.js'))
+    worker.once('exit', () => {
+      assert.equal(worker.isRunning(), false)
+      done()
+    })
+    worker.terminate()
+  })
+})
@@ -209,6 +209,73 @@ describe('protocol module', function () {
         })
       })
     })
+
+    it('serves cached responses without calling handler', function (done) {
+      var calls = 0
+      var handler = function (request, callback) {
+        calls++
+        callback({data: text, headers: {'Cache-Control': 'max-age=60'}})
+      }
+      var get = function (callback) {
+        $.ajax({
+          url: protocolName + '://fake-host/cached',
+          headers: {'Cache-Control': 'no-cache'},
+          success: function (data) {
+            assert.equal(data, text)
+            callback()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      }
+      protocol.registerStringProtocol(protocolName, handler, {cache: {}}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        get(function () {
+          get(function () {
+            assert.equal(calls, 1)
+            protocol.clearResponseCache(protocolName, function (error) {
+              assert.equal(error, null)
+              get(function () {
+                assert.equal(calls, 2)
+                done()
+              })
+            })
+          })
+        })
+      })
+    })
+
+    it('does not cache responses without max-age', function (done) {
+      var calls = 0
+      var handler = function (request, callback) {
+        calls++
+        callback(text)
+      }
+      var get = function (callback) {
+        $.ajax({
+          url: protocolName + '://fake-host/uncached',
+          headers: {'Cache-Control': 'no-cache'},
+          success: callback,
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      }
+      protocol.registerStringProtocol(protocolName, handler, {cache: {}}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        get(function () {
+          get(function () {
+            assert.equal(calls, 2)
+            done()
+          })
+        })
+      })
+    })
   })
 
   describe('protocol.registerBufferProtocol', function () {
@@ -452,6 +519,122 @@ describe('protocol module', function () {
     })
   })
 
+  describe('protocol.registerFileSystemProtocol', function () {
+    var fixtures = path.join(__dirname, 'fixtures')
+    var normalContent = require('fs').readFileSync(path.join(fixtures, 'pages', 'a.html'))
+    var asarContent = require('fs').readFileSync(path.join(fixtures, 'asar', 'a.asar', 'file1'))
+
+    it('sends the file under root', function (done) {
+      protocol.registerFileSystemProtocol(protocolName, {root: fixtures}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://pages/a.html',
+          cache: false,
+          success: function (data, status, request) {
+            assert.equal(data, String(normalContent))
+            assert.equal(request.getResponseHeader('Access-Control-Allow-Origin'), '*')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('sends the file in asar archive', function (done) {
+      var root = path.join(fixtures, 'asar', 'a.asar')
+      protocol.registerFileSystemProtocol(protocolName, {root: root}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://file1',
+          cache: false,
+          success: function (data) {
+            assert.equal(data, String(asarContent))
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('sends spaFallback for unexist-file', function (done) {
+      var options = {root: fixtures, spaFallback: path.join('pages', 'a.html')}
+      protocol.registerFileSystemProtocol(protocolName, options, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://pages/not-exist',
+          cache: false,
+          success: function (data) {
+            assert.equal(data, String(normalContent))
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('sends custom headers and ETag', function (done) {
+      var options = {root: fixtures, headers: {'X-Custom': 'value'}}
+      protocol.registerFileSystemProtocol(protocolName, options, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://pages/a.html',
+          cache: false,
+          success: function (data, status, request) {
+            assert.equal(request.getResponseHeader('X-Custom'), 'value')
+            var etag = request.getResponseHeader('ETag')
+            assert.ok(etag)
+            $.ajax({
+              url: protocolName + '://pages/a.html',
+              cache: false,
+              headers: {'If-None-Match': etag},
+              complete: function (request) {
+                assert.equal(request.status, 304)
+                done()
+              }
+            })
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('fails when path goes out of root', function (done) {
+      var root = path.join(fixtures, 'pages')
+      protocol.registerFileSystemProtocol(protocolName, {root: root}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://../asar/a.asar/file1',
+          cache: false,
+          success: function () {
+            done('request succeeded but it should not')
+          },
+          error: function (xhr, errorType) {
+            assert.equal(errorType, 'error')
+            done()
+          }
+        })
+      })
+    })
+  })
+
   describe('protocol.registerHttpProtocol', function () {
     it('sends url as response', function (done) {
       var server = http.createServer(function (req, res) {
@@ -871,6 +1054,78 @@ describe('protocol module', function () {
       })
     })
 
+    it('sends the original body when uploadData is not set', function (done) {
+      var server = http.createServer(function (req, res) {
+        var body = ''
+        req.on('data', function (chunk) {
+          body += chunk
+        })
+        req.on('end', function () {
+          res.end(body)
+        })
+        server.close()
+      })
+      server.listen(0, '127.0.0.1', function () {
+        var port = server.address().port
+        var url = 'http://127.0.0.1:' + port
+        var handler = function (request, callback) {
+          callback({url: url, session: null})
+        }
+        protocol.interceptHttpProtocol('http', handler, function (error) {
+          if (error) {
+            return done(error)
+          }
+          $.ajax({
+            url: 'http://fake-host',
+            cache: false,
+            type: 'POST',
+            data: postData,
+            success: function (data) {
+              assert.deepEqual(qs.parse(data), postData)
+              done()
+            },
+            error: function (xhr, errorType, error) {
+              done(error)
+            }
+          })
+        })
+      })
+    })
+
+    it('fails when the original body can not be sent again', function (done) {
+      var server = http.createServer(function (req, res) {
+        res.end('reached')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        var port = server.address().port
+        var url = 'http://127.0.0.1:' + port
+        var handler = function (request, callback) {
+          callback({url: url, session: null})
+        }
+        protocol.interceptHttpProtocol('http', handler, function (error) {
+          if (error) {
+            return done(error)
+          }
+          $.ajax({
+            url: 'http://fake-host',
+            cache: false,
+            type: 'POST',
+            data: new Blob(['blob body']),
+            processData: false,
+            success: function () {
+              server.close()
+              done('request succeeded but it should not')
+            },
+            error: function (xhr, errorType) {
+              server.close()
+              assert.equal(errorType, 'error')
+              done()
+            }
+          })
+        })
+      })
+    })
+
     it('can use custom session', function (done) {
       const customSession = session.fromPartition('custom-ses', {
         cache: false
@@ -189,6 +189,42 @@ describe('session module', function () {
       })
     })
 
+    it('filters cookies by domain and name without a url', function (done) {
+      const {cookies} = session.fromPartition('cookies-index')
+      cookies.set({
+        url: 'http://sub.example.com',
+        domain: '.example.com',
+        name: 'indexed',
+        value: '1'
+      }, function (error) {
+        if (error) return done(error)
+        cookies.set({
+          url: 'http://example-other.com',
+          name: 'indexed',
+          value: '2'
+        }, function (error) {
+          if (error) return done(error)
+          cookies.get({domain: 'example.com'}, function (error, list) {
+            if (error) return done(error)
+            assert.equal(list.length, 1)
+            assert.equal(list[0].value, '1')
+            cookies.get({name: 'indexed'}, function (error, list) {
+              if (error) return done(error)
+              assert.deepEqual(list.map((cookie) => cookie.value).sort(), ['1', '2'])
+              cookies.remove('http://example-other.com', 'indexed', function () {
+                cookies.get({name: 'indexed'}, function (error, list) {
+                  if (error) return done(error)
+                  assert.equal(list.length, 1)
+                  assert.equal(list[0].value, '1')
+                  done()
+                })
+              })
+            })
+          })
+        })
+      })
+    })
+
     it('emits a changed event when a cookie is added or removed', function (done) {
       const {cookies} = session.fromPartition('cookies-changed')
 
@@ -219,6 +255,66 @@ describe('session module', function () {
         if (error) return done(error)
       })
     })
+
+    it('emits one changed-batch event for setMany and removeMany', function (done) {
+      const {cookies} = session.fromPartition('cookies-batch')
+      const list = [
+        {url: url, name: 'batch1', value: '1'},
+        {url: url, name: 'batch2', value: '2'}
+      ]
+      const onChanged = function (event, cookie) {
+        done(new Error(`Unexpected changed event for ${cookie.name}`))
+      }
+      cookies.on('changed', onChanged)
+
+      cookies.once('changed-batch', function (event, changes) {
+        assert.deepEqual(changes.map((change) => change.cookie.name).sort(), ['batch1', 'batch2'])
+        assert(changes.every((change) => !change.removed))
+
+        cookies.once('changed-batch', function (event, changes) {
+          assert.equal(changes.length, 2)
+          assert(changes.every((change) => change.removed))
+          cookies.removeListener('changed', onChanged)
+          done()
+        })
+
+        cookies.removeMany(list, function (error) {
+          if (error) return done(error)
+        })
+      })
+
+      cookies.setMany(list, function (error) {
+        if (error) return done(error)
+      })
+    })
+
+    it('reports unrelated cookies by changed events', function (done) {
+      const {cookies} = session.fromPartition('cookies-batch-unrelated')
+      let batchChanges = null
+      const changedNames = []
+      const finish = function () {
+        if (batchChanges == null || changedNames.length === 0) return
+        assert.deepEqual(batchChanges.map((change) => change.cookie.name), ['batch3'])
+        assert.deepEqual(changedNames, ['other'])
+        cookies.removeListener('changed', onChanged)
+        done()
+      }
+      const onChanged = function (event, cookie) {
+        changedNames.push(cookie.name)
+        finish()
+      }
+      cookies.on('changed', onChanged)
+      cookies.once('changed-batch', function (event, changes) {
+        batchChanges = changes
+        finish()
+      })
+      cookies.set({url: url, name: 'other', value: '0'}, function (error) {
+        if (error) return done(error)
+      })
+      cookies.setMany([{url: url, name: 'batch3', value: '3'}], function (error) {
+        if (error) return done(error)
+      })
+    })
   })
 
   describe('ses.clearStorageData(options)', function () {
@@ -530,6 +626,7 @@ describe('session module', function () {
 
   describe('ses.setCertificateVerifyProc(callback)', function () {
     var server = null
+    var handshakes = 0
 
     beforeEach(function (done) {
       var certPath = path.join(__dirname, 'fixtures', 'certificates')
@@ -544,10 +641,16 @@ describe('session module', function () {
         rejectUnauthorized: false
       }
 
+      // Close the connection after each response, so every load needs a new
+      // handshake and a new verification.
+      handshakes = 0
       server = https.createServer(options, function (req, res) {
-        res.writeHead(200)
+        res.writeHead(200, {Connection: 'close'})
         res.end('<title>hello</title>')
       })
+      server.on('secureConnection', function () {
+        handshakes++
+      })
       server.listen(0, '127.0.0.1', done)
     })
 
@@ -590,6 +693,47 @@ describe('session module', function () {
       })
       w.loadURL(url)
     })
+    it('verifies each handshake when the callback is called without a cache time', function (done) {
+      let calls = 0
+      session.defaultSession.setCertificateVerifyProc(function (hostname, certificate, callback) {
+        calls++
+        callback(true)
+      })
+
+      const url = `https://127.0.0.1:${server.address().port}`
+      w.webContents.once('did-finish-load', function () {
+        w.webContents.once('did-finish-load', function () {
+          assert.equal(w.webContents.getTitle(), 'hello')
+          assert(handshakes >= 2)
+          assert.equal(calls, handshakes)
+          done()
+        })
+        w.loadURL(`${url}/again`)
+      })
+      w.loadURL(url)
+    })
+
+    it('reuses the result when the callback is called with a cache time', function (done) {
+      let calls = 0
+      session.defaultSession.setCertificateVerifyProc(function (hostname, certificate, callback) {
+        calls++
+        callback(true, 60 * 1000)
+      })
+
+      const url = `https://127.0.0.1:${server.address().port}`
+      w.webContents.once('did-finish-load', function () {
+        assert.equal(w.webContents.getTitle(), 'hello')
+        w.webContents.once('did-finish-load', function () {
+          assert.equal(w.webContents.getTitle(), 'hello')
+          // The second handshake was verified by the cached result.
+          assert(handshakes >= 2)
+          assert.equal(calls, 1)
+          done()
+        })
+        w.loadURL(`${url}/again`)
+      })
+      w.loadURL(url)
+    })
   })
 
   describe('ses.createInterruptedDownload(options)', function () {
@@ -727,6 +871,89 @@ describe('session module', function () {
     })
   })
 
+  describe('ses.preconnect(options)', function () {
+    it('opens the given number of connections', function (done) {
+      let connections = 0
+      const server = http.createServer(function (req, res) {
+        res.end()
+      })
+      server.on('connection', function () {
+        connections++
+        if (connections === 2) {
+          server.close()
+          done()
+        }
+      })
+      server.listen(0, '127.0.0.1', function () {
+        const ses = session.fromPartition('preconnect')
+        ses.preconnect({url: `http://127.0.0.1:${server.address().port}`, numSockets: 2})
+      })
+    })
+
+    it('throws on invalid options', function () {
+      assert.throws(function () {
+        session.defaultSession.preconnect({url: 'file:///'})
+      }, /Must pass an http or https url/)
+      assert.throws(function () {
+        session.defaultSession.preconnect({url: 'http://127.0.0.1', numSockets: 7})
+      }, /numSockets must be between 1 and 6/)
+    })
+  })
+
+  describe('ses.cache', function () {
+    let server = null
+    let port = null
+
+    before(function (done) {
+      server = http.createServer(function (req, res) {
+        res.setHeader('Cache-Control', 'max-age=3600')
+        res.end('cached')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        port = server.address().port
+        done()
+      })
+    })
+
+    after(function () {
+      server.close()
+    })
+
+    function fetch (ses, path, callback) {
+      const request = net.request({url: `http://127.0.0.1:${port}${path}`, session: ses})
+      request.on('response', function (response) {
+        response.on('data', function () {})
+        response.on('end', callback)
+      })
+      request.end()
+    }
+
+    it('gets and removes entries by url and prefix', function (done) {
+      const ses = session.fromPartition('cache-entries', {cacheType: 'memory', maxCacheSize: 1024 * 1024})
+      const {cache} = ses
+      fetch(ses, '/a/1', function () {
+        fetch(ses, '/a/2', function () {
+          fetch(ses, '/b', function () {
+            cache.get({url: `http://127.0.0.1:${port}/b#fragment`}, function (error, entries) {
+              assert.ifError(error)
+              assert.equal(entries.length, 1)
+              assert.equal(entries[0].url, `http://127.0.0.1:${port}/b`)
+              assert(entries[0].size > 0)
+              cache.remove({prefix: `http://127.0.0.1:${port}/a/`}, function (error) {
+                assert.ifError(error)
+                cache.get({}, function (error, entries) {
+                  assert.ifError(error)
+                  assert.deepEqual(entries.map((entry) => entry.url), [`http://127.0.0.1:${port}/b`])
+                  done()
+                })
+              })
+            })
+          })
+        })
+      })
+    })
+  })
+
   describe('ses.setPermissionRequestHandler(handler)', () => {
     it('cancels any pending requests when cleared', (done) => {
       const ses = session.fromPartition('permissionTest')
@@ -746,4 +973,68 @@ describe('session module', function () {
       document.body.appendChild(webview)
     })
   })
+
+  describe('ses.setSpareRendererPool(size[, webPreferences])', function () {
+    const {app, webContents} = remote
+    const partition = 'spare-renderer-pool'
+    let spareWindow = null
+
+    afterEach(function () {
+      session.fromPartition(partition).setSpareRendererPool(0)
+      return closeWindow(spareWindow, {assertSingleWindow: false}).then(function () {
+        spareWindow = null
+      })
+    })
+
+    // The spares are not exposed as WebContents, so their renderer processes
+    // are counted instead.
+    const getRendererCount = function () {
+      return app.getAppMetrics().filter((metric) => metric.type === 'Tab').length
+    }
+    const waitForRendererCount = function (count, callback) {
+      if (getRendererCount() >= count) {
+        callback()
+      } else {
+        setTimeout(waitForRendererCount, 50, count, callback)
+      }
+    }
+
+    it('lets a BrowserWindow with the same webPreferences take a spare', function (done) {
+      const initialCount = webContents.getAllWebContents().length
+      const initialRenderers = getRendererCount()
+      session.fromPartition(partition).setSpareRendererPool(1, {nodeIntegration: false})
+      waitForRendererCount(initialRenderers + 1, function () {
+        // The spare is not seen until a window takes it.
+        assert.equal(webContents.getAllWebContents().length, initialCount)
+        spareWindow = new BrowserWindow({
+          show: false,
+          webPreferences: {partition: partition, nodeIntegration: false}
+        })
+        // The spare has loaded the blank page.
+        assert.equal(spareWindow.webContents.getURL(), 'about:blank')
+        assert.equal(webContents.getAllWebContents().length, initialCount + 1)
+        const processId = spareWindow.webContents.getProcessId()
+        spareWindow.webContents.once('did-finish-load', function () {
+          // The page is loaded in the launched renderer process.
+          assert.equal(spareWindow.webContents.getProcessId(), processId)
+          assert.equal(webContents.getAllWebContents().length, initialCount + 1)
+          done()
+        })
+        spareWindow.loadURL('file://' + path.join(fixtures, 'pages', 'base-page.html'))
+      })
+    })
+
+    it('is not used by windows with different webPreferences', function (done) {
+      const initialRenderers = getRendererCount()
+      session.fromPartition(partition).setSpareRendererPool(1, {nodeIntegration: false})
+      waitForRendererCount(initialRenderers + 1, function () {
+        spareWindow = new BrowserWindow({
+          show: false,
+          webPreferences: {partition: partition}
+        })
+        assert.equal(spareWindow.webContents.getURL(), '')
+        done()
+      })
+    })
+  })
 })
@@ -0,0 +1,74 @@
+const assert = require('assert')
+const {remote, traceEvents} = require('electron')
+const {contentTracing} = remote
+const mainTraceEvents = remote.require('electron').traceEvents
+
+describe('traceEvents module', function () {
+  const category = 'electron-spec'
+
+  describe('traceEvents.isCategoryEnabled(category)', function () {
+    it('returns false when not recording', function () {
+      assert.equal(traceEvents.isCategoryEnabled(category), false)
+    })
+  })
+
+  describe('when recording', function () {
+    beforeEach(function (done) {
+      contentTracing.startRecording({
+        categoryFilter: category,
+        traceOptions: 'record-until-full'
+      }, () => done())
+    })
+
+    const stopRecording = function (callback) {
+      const chunks = []
+      contentTracing.stopRecordingToStream()
+        .on('data', (chunk) => chunks.push(chunk))
+        .on('end', () => {
+          const trace = JSON.parse(Buffer.concat(chunks).toString())
+          callback(trace.traceEvents.filter((event) => event.cat === category))
+        })
+    }
+
+    it('records the events of the category', function (done) {
+      assert.equal(traceEvents.isCategoryEnabled(category), true)
+      traceEvents.begin(category, 'span', {query: 'select'})
+      traceEvents.end(category, 'span')
+      traceEvents.instant(category, 'mark')
+      traceEvents.counter(category, 'items', {queued: 2, done: 5})
+      traceEvents.begin('electron-spec-disabled', 'ignored')
+      stopRecording((events) => {
+        const phases = events.map((event) => event.ph)
+        assert.deepEqual(phases, ['B', 'E', 'I', 'C'])
+        assert.equal(events[0].name, 'span')
+        assert.deepEqual(events[0].args, {data: {query: 'select'}})
+        assert.deepEqual(events[3].args, {queued: 2, done: 5})
+        done()
+      })
+    })
+
+    it('records async spans with their ids', function (done) {
+      traceEvents.asyncBegin(category, 'request', 0, {url: 'a'})
+      traceEvents.asyncBegin(category, 'request', 1)
+      traceEvents.asyncEnd(category, 'request', 1)
+      traceEvents.asyncEnd(category, 'request', 0)
+      stopRecording((events) => {
+        const spans = events.map((event) => [event.ph, Number(event.id)])
+        assert.deepEqual(spans, [['b', 0], ['b', 1], ['e', 1], ['e', 0]])
+        assert.deepEqual(events[0].args, {data: {url: 'a'}})
+        done()
+      })
+    })
+
+    it('records the events of the main process', function (done) {
+      assert.equal(mainTraceEvents.isCategoryEnabled(category), true)
+      mainTraceEvents.instant(category, 'main')
+      stopRecording((events) => {
+        assert.equal(events.length, 1)
+        assert.equal(events[0].name, 'main')
+        assert.equal(events[0].pid, remote.process.pid)
+        done()
+      })
+    })
+  })
+})
@@ -90,6 +90,163 @@ describe('webContents module', function () {
     })
   })
 
+  describe('broadcastTo() API', function () {
+    it('sends the message to the targets', function (done) {
+      ipcRenderer.once('pong', function (event, id) {
+        assert.equal(id, remote.getCurrentWebContents().id)
+        done()
+      })
+      w.webContents.once('did-finish-load', function () {
+        const id = remote.getCurrentWebContents().id
+        assert.equal(webContents.broadcastTo([w.webContents], 'ping', id), 1)
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'ping-pong.html'))
+    })
+
+    it('sends the message to the web contents of a session', function () {
+      const ses = remote.session.fromPartition('broadcast-to')
+      assert.equal(webContents.broadcastTo(ses, 'ping', 0), 0)
+    })
+
+    it('skips the web contents not listening to the channel', function (done) {
+      const currentWebContents = remote.getCurrentWebContents()
+      assert.equal(webContents.broadcastTo([currentWebContents], 'broadcast-spec', 'ignored'), 0)
+
+      ipcRenderer.once('broadcast-spec', function (event, value) {
+        assert.equal(value, 'received')
+        done()
+      })
+      assert.equal(webContents.broadcastTo(currentWebContents.session, 'broadcast-spec', 'received'), 1)
+    })
+  })
+
+  describe('connect() API', function () {
+    afterEach(function () {
+      ipcRenderer.removeAllListeners('message-port')
+    })
+
+    it('passes messages between renderers', function (done) {
+      ipcRenderer.once('message-port', function (event, port) {
+        port.once('message', function (event, reply, value) {
+          assert.equal(reply, 'echo')
+          assert.deepEqual(value, {hello: 'world'})
+          port.once('close', function () {
+            assert.equal(port.closed, true)
+            done()
+          })
+          port.close()
+        })
+        port.postMessage({hello: 'world'})
+      })
+      w.webContents.once('did-finish-load', function () {
+        webContents.connect(remote.getCurrentWebContents(), w.webContents, 'message-port')
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'message-port.html'))
+    })
+
+    it('closes the ports when the peer navigates to another document', function (done) {
+      ipcRenderer.once('message-port', function (event, port) {
+        port.once('close', function () {
+          assert.equal(port.closed, true)
+          done()
+        })
+        w.loadURL('about:blank')
+      })
+      w.webContents.once('did-finish-load', function () {
+        webContents.connect(remote.getCurrentWebContents(), w.webContents, 'message-port')
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'message-port.html'))
+    })
+  })
+
+  describe('jank event', function () {
+    it('reports a blocking task of the renderer with its JavaScript stack', function (done) {
+      w.destroy()
+      w = new BrowserWindow({
+        show: false,
+        webPreferences: {
+          jankThreshold: 500
+        }
+      })
+      w.webContents.once('jank', function (event, details) {
+        assert.ok(details.duration >= 500)
+        assert.equal(typeof details.task, 'string')
+        assert.notEqual(details.jsStack.indexOf('blockMainThread'), -1)
+        done()
+      })
+      w.webContents.once('did-finish-load', function () {
+        w.webContents.executeJavaScript(`
+          function blockMainThread () {
+            const end = Date.now() + 1000
+            while (Date.now() < end) {}
+          }
+          blockMainThread()
+        `)
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'base-page.html'))
+    })
+  })
+
+  describe('memory-purged event', function () {
+    it('reports the purge of a hidden page', function (done) {
+      w.destroy()
+      w = new BrowserWindow({
+        show: false,
+        webPreferences: {
+          purgeMemoryWhenHidden: 100
+        }
+      })
+      w.webContents.once('memory-purged', function (event, details) {
+        assert.equal(details.reason, 'hidden')
+        assert.equal(typeof details.duration, 'number')
+        assert.ok(details.v8HeapSize > 0)
+        assert.ok(details.v8HeapReclaimed >= 0)
+        assert.ok(details.memoryCacheReclaimed >= 0)
+        done()
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'base-page.html'))
+    })
+  })
+
+  describe('executeJavaScriptInFrame() API', function () {
+    beforeEach(function (done) {
+      w.webContents.once('did-finish-load', () => done())
+      w.loadURL('data:text/html,<iframe name="child" src="about:blank"></iframe>')
+    })
+
+    function getChildFrame () {
+      const frames = w.webContents.getFrames()
+      assert.equal(frames.length, 2)
+      const mainFrame = frames.find((frame) => frame.isMainFrame)
+      const childFrame = frames.find((frame) => !frame.isMainFrame)
+      assert.equal(childFrame.name, 'child')
+      assert.equal(childFrame.parentRoutingId, mainFrame.routingId)
+      return childFrame
+    }
+
+    it('runs a batch of scripts in the given frame', function () {
+      const {routingId} = getChildFrame()
+      return w.webContents.executeJavaScriptInFrame(routingId, ['window.name', 'Promise.resolve({sum: 1 + 1})'])
+        .then((results) => {
+          assert.deepEqual(results, ['child', {sum: 2}])
+        })
+    })
+
+    it('rejects with the error of a throwing script', function (done) {
+      const {routingId} = getChildFrame()
+      w.webContents.executeJavaScriptInFrame(routingId, 'throw new Error("boom")').catch((error) => {
+        assert.ok(/boom/.test(error.message))
+        done()
+      })
+    })
+
+    it('throws for an unknown frame', function () {
+      assert.throws(function () {
+        w.webContents.executeJavaScriptInFrame(-1, '1')
+      }, /No live frame has the routing id/)
+    })
+  })
+
   describe('isFocused() API', function () {
     it('returns false when the window is hidden', function () {
       BrowserWindow.getAllWindows().forEach(function (window) {
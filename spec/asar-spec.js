@@ -37,6 +37,22 @@ describe('asar package', function () {
         assert.equal(fs.readFileSync(file3).toString().trim(), 'file3')
       })
 
+      it('checks the integrity of files', function () {
+        var valid = path.join(fixtures, 'asar', 'integrity.asar', 'valid.txt')
+        assert.equal(fs.readFileSync(valid, 'utf8'), 'file with blocks checked lazily\n')
+        var tampered = path.join(fixtures, 'asar', 'integrity.asar', 'tampered.txt')
+        assert.throws(function () {
+          fs.readFileSync(tampered)
+        }, /EIO/)
+      })
+
+      it('reads a compressed file', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'text.txt')
+        var content = fs.readFileSync(p, 'utf8')
+        assert.equal(content.length, 4100)
+        assert.equal(content.split('\n')[99], 'line 0099 of a file compressed in frames')
+      })
+
       it('reads from a empty file', function () {
         var file = path.join(fixtures, 'asar', 'empty.asar', 'file1')
         var buffer = fs.readFileSync(file)
@@ -124,6 +140,32 @@ describe('asar package', function () {
           done()
         })
       })
+
+      it('reads a file passing the integrity check', function (done) {
+        var p = path.join(fixtures, 'asar', 'integrity.asar', 'valid.txt')
+        fs.readFile(p, function (err, content) {
+          assert.equal(err, null)
+          assert.equal(String(content), 'file with blocks checked lazily\n')
+          done()
+        })
+      })
+
+      it('throws EIO error when a file fails the integrity check', function (done) {
+        var p = path.join(fixtures, 'asar', 'integrity.asar', 'tampered.txt')
+        fs.readFile(p, function (err) {
+          assert.equal(err.code, 'EIO')
+          done()
+        })
+      })
+
+      it('reads a compressed file', function (done) {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'text.txt')
+        fs.readFile(p, 'utf8', function (err, content) {
+          assert.equal(err, null)
+          assert.equal(content.split('\n')[0], 'line 0000 of a file compressed in frames')
+          done()
+        })
+      })
     })
 
     describe('fs.lstatSync', function () {
@@ -496,6 +538,15 @@ describe('asar package', function () {
         }
         assert.throws(throws, /ENOENT/)
       })
+
+      it('opens a compressed file', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'text.txt')
+        var fd = fs.openSync(p, 'r')
+        var buffer = new Buffer(9)
+        fs.readSync(fd, buffer, 0, 9, 2009)
+        assert.equal(String(buffer), 'line 0049')
+        fs.closeSync(fd)
+      })
     })
 
     describe('fs.open', function () {
@@ -686,6 +737,12 @@ describe('asar package', function () {
         var p = path.join(fixtures, 'asar', 'unpack.asar', 'a.txt')
         assert.equal(internalModuleReadFile(p).toString().trim(), 'a')
       })
+
+      it('reads a compressed module', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'index.js')
+        assert.equal(internalModuleReadFile(p), "module.exports = 'compressed module'\n")
+        assert.equal(require(path.join(fixtures, 'asar', 'compressed.asar')), 'compressed module')
+      })
     })
 
     describe('process.noAsar', function () {
@@ -841,6 +898,34 @@ describe('asar package', function () {
       })
     })
 
+    it('fails the request of a file failing the integrity check', function (done) {
+      var p = path.resolve(fixtures, 'asar', 'integrity.asar', 'tampered.txt')
+      $.ajax({
+        url: 'file://' + p,
+        success: function () {
+          done(new Error('Tampered file should not be loaded'))
+        },
+        error: function () {
+          done()
+        }
+      })
+    })
+
+    it('can request a range of a compressed file', function (done) {
+      var p = path.resolve(fixtures, 'asar', 'compressed.asar', 'text.txt')
+      $.ajax({
+        url: 'file://' + p,
+        headers: {Range: 'bytes=2009-2049'},
+        success: function (data) {
+          assert.equal(data, 'line 0049 of a file compressed in frames\n')
+          done()
+        },
+        error: function (err) {
+          done(err)
+        }
+      })
+    })
+
     it('sets __dirname correctly', function (done) {
       after(function () {
         ipcMain.removeAllListeners('dirname')
@@ -978,4 +1063,83 @@ describe('asar package', function () {
       })
     })
   })
+
+  describe('asar executable', function () {
+    // It is built next to Electron, except in cross builds.
+    const asarTool = path.join(
+      process.platform === 'darwin'
+        ? path.resolve(process.execPath, '..', '..', '..', '..')
+        : path.dirname(process.execPath),
+      process.platform === 'win32' ? 'asar.exe' : 'asar')
+    const asarBinding = process.binding('atom_common_asar')
+    const temp = require('temp').track()
+
+    let sourceDir = null
+    let archivePath = null
+
+    const pack = function () {
+      ChildProcess.execFileSync(asarTool, ['pack', archivePath, sourceDir])
+    }
+
+    // Reads the archive without the cache of fs, which would keep the header
+    // read before repacking.
+    const readArchive = function (callback) {
+      const archive = asarBinding.createArchive(archivePath)
+      assert.ok(archive)
+      try {
+        callback(archive)
+      } finally {
+        archive.destroy()
+      }
+    }
+
+    beforeEach(function () {
+      const dir = temp.mkdirSync('electron-asar-spec-')
+      sourceDir = path.join(dir, 'app')
+      archivePath = path.join(dir, 'app.asar')
+      fs.mkdirSync(sourceDir)
+      fs.mkdirSync(path.join(sourceDir, 'dir'))
+      fs.writeFileSync(path.join(sourceDir, 'file1'), 'file1')
+      fs.writeFileSync(path.join(sourceDir, 'dir', 'file2'), 'file2')
+    })
+
+    after(function () {
+      temp.cleanupSync()
+    })
+
+    it('packs files that the archive reader reads back', function () {
+      if (!fs.existsSync(asarTool)) return
+      pack()
+      readArchive(function (archive) {
+        assert.deepEqual(archive.readdir('').sort(), ['dir', 'file1'])
+        assert.equal(archive.readFile('file1').toString(), 'file1')
+        assert.equal(archive.readFile('dir/file2').toString(), 'file2')
+        assert.equal(archive.getFileInfo('file1').integrity, true)
+      })
+      const list = ChildProcess.execFileSync(asarTool, ['list', archivePath])
+      assert.deepEqual(list.toString().trim().split(/\r?\n/).map(function (p) {
+        return p.replace(/\\/g, '/')
+      }).sort(), ['dir', 'dir/file2', 'file1'])
+    })
+
+    it('only appends the changed files when repacking', function () {
+      if (!fs.existsSync(asarTool)) return
+      pack()
+      let offset
+      readArchive(function (archive) {
+        offset = archive.getFileInfo('dir/file2').offset
+      })
+
+      fs.writeFileSync(path.join(sourceDir, 'file1'), 'file1 changed')
+      fs.writeFileSync(path.join(sourceDir, 'file3'), 'file3')
+      pack()
+      assert.equal(fs.existsSync(archivePath + '.tmp'), false)
+      readArchive(function (archive) {
+        assert.equal(archive.getFileInfo('dir/file2').offset, offset)
+        assert.equal(archive.readFile('file1').toString(), 'file1 changed')
+        assert.equal(archive.readFile('dir/file2').toString(), 'file2')
+        assert.equal(archive.readFile('file3').toString(), 'file3')
+      })
+    })
+  })
 })
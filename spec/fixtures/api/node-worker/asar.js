@@ -0,0 +1,6 @@
+const fs = require('fs')
+const path = require('path')
+const {parentPort} = require('electron')
+
+const file = path.join(__dirname, '..', '..', 'asar', 'a.asar', 'file1')
+parentPort.postMessage(fs.readFileSync(file).toString().trim())
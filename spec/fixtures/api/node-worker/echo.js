@@ -0,0 +1,9 @@
+const {parentPort} = require('electron')
+
+parentPort.on('message', (message) => {
+  if (message === 'exit') {
+    process.exit(3)
+  } else {
+    parentPort.postMessage({type: process.type, echo: message})
+  }
+})
@@ -0,0 +1,4 @@
+const {parentPort} = require('electron')
+
+process.exit(4)
+parentPort.postMessage('still running')
@@ -0,0 +1 @@
+window.contentScriptResults.afterThrow = true
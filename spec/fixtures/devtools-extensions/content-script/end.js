@@ -0,0 +1,4 @@
+window.contentScriptResults.end = {
+  readyState: document.readyState,
+  hasLastElement: document.getElementById('last') != null
+}
@@ -0,0 +1 @@
+window.contentScriptResults.matched = true
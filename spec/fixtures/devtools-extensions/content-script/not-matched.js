@@ -0,0 +1 @@
+window.contentScriptResults.notMatched = true
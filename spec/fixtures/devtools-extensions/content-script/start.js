@@ -0,0 +1,6 @@
+window.contentScriptResults = {
+  start: {
+    readyState: document.readyState,
+    hasBody: document.body != null
+  }
+}
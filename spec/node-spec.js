@@ -209,6 +209,48 @@ describe('node feature', function () {
         })
       })
     })
+
+    describe('process.getUvStats', function () {
+      it('counts the uv_run calls made by the message loop', function (done) {
+        const before = process.getUvStats()
+        assert.equal(typeof before.wakeups, 'number')
+        assert.equal(typeof before.coalescedWakeups, 'number')
+        assert.equal(typeof before.uvRunTime, 'number')
+        fs.readFile(__filename, function () {
+          setImmediate(function () {
+            const after = process.getUvStats()
+            assert(after.tasks > before.tasks)
+            assert(after.iterations >= after.tasks)
+            done()
+          })
+        })
+      })
+
+      it('handles the events that become ready in the same task', function (done) {
+        // The backend of Windows is not polled without waiting.
+        if (process.platform === 'win32') return done()
+
+        // Each write of the ping-pong makes the other socket readable while the
+        // loop is running, which is handled without another wakeup.
+        const before = process.getUvStats()
+        const server = require('net').createServer(function (socket) {
+          socket.on('data', (data) => socket.write(data))
+        })
+        server.listen(0, '127.0.0.1', function () {
+          let rounds = 0
+          const client = require('net').connect(server.address().port, '127.0.0.1')
+          client.on('connect', () => client.write('ping'))
+          client.on('data', function (data) {
+            if (++rounds < 100) return client.write(data)
+            client.end()
+            server.close()
+            const after = process.getUvStats()
+            assert(after.coalescedWakeups > before.coalescedWakeups)
+            done()
+          })
+        })
+      })
+    })
   })
 
   describe('net.connect', function () {
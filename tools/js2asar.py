@@ -11,14 +11,32 @@ SOURCE_ROOT = os.path.dirname(os.path.dirname(__file__))
 
 
 def main():
-  archive = sys.argv[1]
-  folder_name = sys.argv[2]
-  source_files = sys.argv[3:]
+  asar = sys.argv[1]
+  archive = sys.argv[2]
+  folder_name = sys.argv[3]
+  source_files = sys.argv[4:]
 
-  output_dir = tempfile.mkdtemp()
-  copy_files(source_files, output_dir)
-  call_asar(archive, os.path.join(output_dir, folder_name))
-  shutil.rmtree(output_dir)
+  # Cross builds can not run the asar executable built for the target.
+  if asar == 'npm':
+    output_dir = tempfile.mkdtemp()
+    copy_files(source_files, output_dir)
+    call_npm_asar(archive, os.path.join(output_dir, folder_name))
+    shutil.rmtree(output_dir)
+  else:
+    call_asar(asar, archive, folder_name, source_files)
+
+
+def call_asar(asar, archive, folder_name, source_files):
+  # Pass the files in a list file, there can be more of them than a command
+  # line can hold on Windows.
+  (fd, files_list) = tempfile.mkstemp()
+  try:
+    with os.fdopen(fd, 'w') as f:
+      f.write('\n'.join(source_files))
+    subprocess.check_call([asar, 'pack', archive, folder_name,
+                           '--files-from=' + files_list])
+  finally:
+    os.remove(files_list)
 
 
 def copy_files(source_files, output_dir):
@@ -28,7 +46,7 @@ def copy_files(source_files, output_dir):
     shutil.copy2(source_file, output_path)
 
 
-def call_asar(archive, output_dir):
+def call_npm_asar(archive, output_dir):
   asar = os.path.join(SOURCE_ROOT, 'node_modules', '.bin', 'asar')
   if sys.platform in ['win32', 'cygwin']:
     asar += '.cmd'